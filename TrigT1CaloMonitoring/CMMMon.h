@@ -34,6 +34,7 @@ namespace LVL1 {
 
 class TrigT1CaloMonErrorTool;
 class TrigT1CaloLWHistogramTool;
+class TrigT1CaloErrorBoardTool;
 
 /** Monitoring of the JEP on CMM level.
  *
@@ -83,9 +84,6 @@ class TrigT1CaloLWHistogramTool;
  *  <tr><td> @c DataVector
  *           @c <LVL1::CMMEtSums>         </td><td> CMM Et sums data                         </td></tr>
  *  <tr><td> @c LVL1::CMMRoI              </td><td> CMM RoI data                             </td></tr>
- *  <tr><td> @c std::vector<int>          <br>
- *           @c "L1CaloJEMCMMErrorVector" </td><td> Output.
- *                                                  Error summary bits for global histograms </td></tr>
  *  </table>
  *
  *  <b>Tools Used:</b>
@@ -94,6 +92,7 @@ class TrigT1CaloLWHistogramTool;
  *  <tr><th> Tool                         </th><th> Description          </th></tr>
  *  <tr><td> @c TrigT1CaloMonErrorTool    </td><td> @copydoc m_errorTool </td></tr>
  *  <tr><td> @c TrigT1CaloLWHistogramTool </td><td> @copydoc m_histTool  </td></tr>
+ *  <tr><td> @c TrigT1CaloErrorBoardTool  </td><td> @copydoc m_errorBoard </td></tr>
  *  </table>
  *
  *  <b>JobOption Properties:</b>
@@ -146,6 +145,8 @@ private:
    ToolHandle<TrigT1CaloMonErrorTool>    m_errorTool;
    /// Histogram helper tool
    ToolHandle<TrigT1CaloLWHistogramTool> m_histTool;
+   /// Shared error summary board for global histograms
+   ToolHandle<TrigT1CaloErrorBoardTool>  m_errorBoard;
 
    /** location of data */
    /// CMMJetHits collection StoreGate key
@@ -19,6 +19,11 @@
 #include "AthenaMonitoring/ManagedMonitorToolBase.h"
 #include "DataModel/DataVector.h"
 
+#include "TrigT1CaloMonitoring/TrigT1CaloCPTowerArray.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloLazyHists.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloObjectPool.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloTaskPool.h"
+
 class LWHist;
 class TH1F_LW;
 class TH2F_LW;
@@ -26,6 +31,8 @@ class TH2I_LW;
 class StatusCode;
 class TrigT1CaloMonErrorTool;
 class TrigT1CaloLWHistogramTool;
+class TrigT1CaloErrorBoardTool;
+class TrigT1CaloRodSummary;
 
 namespace LVL1 {
   class CPAlgorithm;
@@ -33,7 +40,6 @@ namespace LVL1 {
   class CPMHits;
   class CMMCPHits;
   class CPMRoI;
-  class RODHeader;
   class TriggerTower;
   class IL1EmTauTools;
   class IL1CPHitsTools;
@@ -107,11 +113,10 @@ namespace LVL1 {
  *           @c <LVL1::CPMHits>           </td><td> CPM Hits data                            </td></tr>
  *  <tr><td> @c DataVector
  *           @c <LVL1::CMMCPHits>         </td><td> CMM-CP Hits data                         </td></tr>
+ *  <tr><td> @c TrigT1CaloRodSummary
+ *           (@c <LVL1::RODHeader>)     </td><td> Decoded ROD headers for LimitedRoISet bit </td></tr>
  *  <tr><td> @c DataVector
- *           @c <LVL1::RODHeader>         </td><td> ROD header data for LimitedRoISet bit    </td></tr>
- *  <tr><td> @c std::vector<int>          <br>
- *           @c "L1CaloCPMMismatchVector" </td><td> Output.
- *                                               Mismatch summary bits for global histograms </td></tr>
+ *           @c <LVL1::CPMRoI>            </td><td> Optional upstream simulated CPM RoIs     </td></tr>
  *  </table>
  *
  *  <b>Tools Used:</b>
@@ -122,6 +127,7 @@ namespace LVL1 {
  *  <tr><td> @c LVL1::IL1CPHitsTools      </td><td> @copydoc m_cpHitsTool </td></tr>
  *  <tr><td> @c TrigT1CaloMonErrorTool    </td><td> @copydoc m_errorTool  </td></tr>
  *  <tr><td> @c TrigT1CaloLWHistogramTool </td><td> @copydoc m_histTool   </td></tr>
+ *  <tr><td> @c TrigT1CaloErrorBoardTool  </td><td> @copydoc m_errorBoard </td></tr>
  *  </table>
  *
  *  <b>JobOption Properties:</b>
@@ -138,8 +144,30 @@ namespace LVL1 {
  *  <tr><td> @c TriggerTowerLocation    </td><td> @copydoc m_triggerTowerLocation    </td></tr>
  *  <tr><td> @c RodHeaderLocation       </td><td> @copydoc m_rodHeaderLocation       </td></tr>
  *  <tr><td> @c RootDirectory           </td><td> @copydoc m_rootDir                 </td></tr>
+ *  <tr><td> @c LazyBooking             </td><td> @copydoc m_lazyBooking             </td></tr>
+ *  <tr><td> @c RoIThreads              </td><td> @copydoc m_roiThreads              </td></tr>
+ *  <tr><td> @c SimCPMRoILocation       </td><td> @copydoc m_simCpmRoiLocation       </td></tr>
+ *  <tr><td> @c UpstreamCheckEvents     </td><td> @copydoc m_upstreamCheckEvents     </td></tr>
  *  </table>
  *
+ *  If @c SimCPMRoILocation is set and the container is present, CPM RoIs
+ *  already simulated upstream (see TrigT1CaloMonitoring_L1CaloSimulation.py)
+ *  are used instead of simulating them again, but only in events where core
+ *  and overlap CPM Towers agree with the Trigger Towers, so that the RoIs
+ *  are made from the same input.  Like the quick local simulation they are
+ *  made without the parity zeroing of ttCheck(), which is only applied
+ *  crate by crate after tower mismatches.  For the first
+ *  @c UpstreamCheckEvents events with upstream RoIs, and every event with
+ *  DEBUG output, RoIs are also simulated here and the local ones used.  If
+ *  the upstream RoIs differ in any hits, reuse is switched off for the rest
+ *  of the job with a warning.  The numbers of events checked and differing
+ *  are printed at finalize.
+ *
+ *  With @c RoIThreads > 1 the RoIs of the four crates are found in
+ *  parallel after tower mismatches, and merged in crate order.  This is
+ *  disabled when DEBUG output is enabled.  If a crate task fails the RoI
+ *  comparison is skipped for that event.
+ *
  *  <b>Related Documentation:</b>
  *
  *  <a href="http://hepwww.rl.ac.uk/Atlas-L1/Modules/CPM/CPM_Specification_2_03.pdf">
@@ -185,18 +213,22 @@ private:
   typedef DataVector<LVL1::CPMRoI>       CpmRoiCollection;
   typedef DataVector<LVL1::TriggerTower> TriggerTowerCollection;
   typedef DataVector<LVL1::CPAlgorithm>  InternalRoiCollection;
-  typedef DataVector<LVL1::RODHeader>    RodHeaderCollection;
   
   typedef std::vector<int> ErrorVector;
 
-  typedef std::map<int, LVL1::TriggerTower*> TriggerTowerMap;
+  typedef TrigT1CaloCPTowerArray<LVL1::TriggerTower> TriggerTowerArray;
+  typedef TrigT1CaloCPTowerArray<LVL1::CPMTower>     CpmTowerArray;
+
   typedef std::map<int, LVL1::CPMTower*>     CpmTowerMap;
   typedef std::map<int, LVL1::CPMRoI*>       CpmRoiMap;
   typedef std::map<int, LVL1::CPMHits*>      CpmHitsMap;
   typedef std::map<int, LVL1::CMMCPHits*>    CmmCpHitsMap;
+
+  /// RoI finding for one crate, run by m_roiPool
+  class CrateRoiTask;
   
   /// Compare Trigger Towers and CPM Towers
-  bool  compare(const TriggerTowerMap& ttMap, const CpmTowerMap& cpMap,
+  bool  compare(const TriggerTowerArray& ttArray, const CpmTowerArray& cpArray,
                       ErrorVector& errors, bool overlap);
   /// Compare Simulated RoIs with data
   void  compare(const CpmRoiMap& roiSimMap, const CpmRoiMap& roiMap,
@@ -212,21 +244,21 @@ private:
                                           ErrorVector& errors, int selection);
   /// Set labels for Overview and summary histograms
   void  setLabels(LWHist* hist, bool xAxis = true);
-  /// Set up TriggerTower map
-  void  setupMap(const TriggerTowerCollection* coll, TriggerTowerMap& map);
-  /// Set up CpmTower map
-  void  setupMap(const CpmTowerCollection* coll, CpmTowerMap& map);
+  /// Set up TriggerTower array
+  void  setupMap(const TriggerTowerCollection* coll, TriggerTowerArray& array);
+  /// Set up CpmTower array
+  void  setupMap(const CpmTowerCollection* coll, CpmTowerArray& array);
   /// Set up CpmRoi map
   void  setupMap(const CpmRoiCollection* coll, CpmRoiMap& map);
   /// Set up CpmHits map
   void  setupMap(const CpmHitsCollection* coll, CpmHitsMap& map);
   /// Set up CmmCpHits map
   void  setupMap(const CmmCpHitsCollection* coll, CmmCpHitsMap& map);
-  /// Simulate CPM RoIs from CPM Towers
-  void  simulate(const CpmTowerMap towers, const CpmTowerMap towersOv,
+  /// Simulate CPM RoIs from CPM Towers, false if crate tasks failed
+  bool  simulate(const CpmTowerArray& towers, const CpmTowerArray& towersOv,
                        CpmRoiCollection* rois);
   /// Simulate CPM RoIs from CPM Towers quick version
-  void  simulate(const CpmTowerMap towers, CpmRoiCollection* rois);
+  void  simulate(const CpmTowerArray& towers, CpmRoiCollection* rois);
   /// Simulate CPM Hits from CPM RoIs
   void  simulate(const CpmRoiCollection* rois, CpmHitsCollection* hits);
   /// Simulate CMM Hit sums from CMM Hits
@@ -235,9 +267,14 @@ private:
   /// Return EM FPGA for given crate/phi
   int   fpga(int crate, double phi);
   /// Return a tower with zero energy if parity bit is set
-  LVL1::CPMTower* ttCheck(LVL1::CPMTower* tt, CpmTowerCollection* coll);
+  LVL1::CPMTower* ttCheck(LVL1::CPMTower* tt);
   /// Check if LimitedRoISet bit is set
   bool  limitedRoiSet(int crate);
+  /// Return upstream simulated CPM RoIs if key set and present, else 0
+  const CpmRoiCollection* upstreamRois();
+  /// Compare upstream RoIs with RoIs simulated from CPM Towers
+  void  checkUpstream(const CpmRoiCollection* rois,
+                      const CpmRoiCollection* simRois);
 
   /// CP RoI simulation tool
   ToolHandle<LVL1::IL1EmTauTools>       m_emTauTool;
@@ -247,6 +284,8 @@ private:
   ToolHandle<TrigT1CaloMonErrorTool>    m_errorTool;
   /// Histogram helper tool
   ToolHandle<TrigT1CaloLWHistogramTool> m_histTool;
+  /// Shared error summary board for global histograms
+  ToolHandle<TrigT1CaloErrorBoardTool>  m_errorBoard;
   // Debug printout flag
   bool m_debug;
 
@@ -267,15 +306,53 @@ private:
   std::string m_triggerTowerLocation;
   /// ROD header container StoreGate key
   std::string m_rodHeaderLocation;
-  /// Pointer to ROD header container
-  const RodHeaderCollection* m_rodTES;
+  /// Upstream simulated CPM RoI container StoreGate key, empty to simulate
+  std::string m_simCpmRoiLocation;
+  /// Events with upstream CPM RoIs checked before reuse, all with DEBUG
+  int m_upstreamCheckEvents;
+  /// Upstream CPM RoIs in use, false after a difference
+  bool m_upstreamOn;
+  /// Number of events using upstream simulated CPM RoIs
+  unsigned long m_upstreamUsed;
+  /// Number of events upstream CPM RoIs checked
+  unsigned long m_upstreamChecked;
+  /// Number of events upstream CPM RoIs differ from local simulation
+  unsigned long m_upstreamDiffer;
+  /// Decoded ROD headers for current event
+  const TrigT1CaloRodSummary* m_rodSummary;
 
   /// CPM overlap tower container present
   bool m_overlapPresent;
-  /// LimitedRoISet flags
-  int m_limitedRoi;
+  /// Only write mismatch histograms which are filled (offline)
+  bool m_lazyBooking;
   /// Histograms booked flag
   bool m_histBooked;
+  /// Mismatch histograms written only if filled
+  TrigT1CaloLazyHists m_lazyHists;
+  /// Threads for per-crate RoI simulation, 0 or 1 for serial
+  int m_roiThreads;
+  /// Worker threads for per-crate RoI simulation
+  TrigT1CaloTaskPool m_roiPool;
+  /// Trigger Towers by eta-phi index
+  TriggerTowerArray m_ttArray;
+  /// Core CPM Towers by eta-phi index
+  CpmTowerArray m_cpArray;
+  /// Overlap CPM Towers by eta-phi index
+  CpmTowerArray m_ovArray;
+  /// Per-crate RoI finding tasks
+  std::vector<CrateRoiTask*> m_crateTasks;
+  /// Scratch internal RoIs for quick RoI simulation
+  InternalRoiCollection* m_intRois;
+  /// Scratch simulated CPM RoIs, a view of m_roiObjects
+  CpmRoiCollection* m_cpmRoiSim;
+  /// Scratch simulated CPM Hits
+  CpmHitsCollection* m_cpmHitsSim;
+  /// Scratch simulated CMM-CP Hits
+  CmmCpHitsCollection* m_cmmCpHitsSim;
+  /// Storage for simulated CPM RoIs
+  TrigT1CaloObjectPool<LVL1::CPMRoI> m_roiObjects;
+  /// Storage for parity corrected CPM Towers
+  TrigT1CaloObjectPool<LVL1::CPMTower> m_towerObjects;
 
   //=======================
   //   Match/Mismatch plots
@@ -26,6 +26,7 @@ class StatusCode;
 class CaloCluster;
 class TrigT1CaloMonErrorTool;
 class TrigT1CaloLWHistogramTool;
+class TrigT1CaloTowerTableTool;
 class EventInfo;
 class CondAttrListCollection;
 class LVL1_ROI;
@@ -127,7 +128,7 @@ namespace Trig {
  *  <tr><th> Tool                           </th><th> Description          </th></tr>
  *  <tr><td> @c TrigT1CaloMonErrorTool      </td><td> @copydoc m_errorTool </td></tr>
  *  <tr><td> @c TrigT1CaloLWHistogramTool   </td><td> @copydoc m_histTool  </td></tr>
- *  <tr><td> @c LVL1::IL1TriggerTowerTool   </td><td> @copydoc m_ttTool    </td></tr>
+ *  <tr><td> @c TrigT1CaloTowerTableTool    </td><td> @copydoc m_towerTable </td></tr>
  *  <tr><td> @c LVL1::IL1CaloLArTowerEnergy </td><td> @copydoc m_larEnergy </td></tr>
  *  <tr><td> @c Trig::TrigDecisionTool      </td><td> @copydoc m_trigger   </td></tr>
  *  </table>
@@ -137,6 +138,7 @@ namespace Trig {
  *  <table>
  *  <tr><th> Property                    </th><th> Description                         </th></tr>
  *  <tr><td> @c HistogramTool            </td><td> @copydoc m_histTool                 </td></tr>
+ *  <tr><td> @c TowerTableTool           </td><td> @copydoc m_towerTable               </td></tr>
  *  <tr><td> @c TriggerTowerTool         </td><td> @copydoc m_ttTool                   </td></tr>
  *  <tr><td> @c LArTowerEnergyTool       </td><td> @copydoc m_larEnergy                </td></tr>
  *  <tr><td> @c TrigDecisionTool         </td><td> @copydoc m_trigger                  </td></tr>
@@ -160,6 +162,12 @@ namespace Trig {
  *  <tr><td> @c IsEmType                 </td><td> @copydoc m_isEmType                 </td></tr>
  *  </table>
  *
+ *  @c TowerTableTool replaces the former @c TriggerTowerTool property.
+ *  Jobs that configured the trigger tower tool here should now set it
+ *  on TrigT1CaloTowerTableTool, whose property keeps that name.  The old
+ *  property is still accepted so that such jobs run, but is not used and
+ *  gives a warning if set to other than its default.
+ *
  *  <b>Related Documentation:</b>
  *
  *  <a href="https://cdsweb.cern.ch/record/1444500/files/ATL-COM-DAQ-2012-030.pdf">
@@ -253,7 +261,9 @@ private:
   ToolHandle<TrigT1CaloMonErrorTool>    m_errorTool;
   /// Histogram helper tool
   ToolHandle<TrigT1CaloLWHistogramTool> m_histTool;
-  /// TT simulation tool for Identifiers. Used first event only
+  /// Per-run table of tower identifiers. Used first event only
+  ToolHandle<TrigT1CaloTowerTableTool> m_towerTable;
+  /// Deprecated, set on TrigT1CaloTowerTableTool instead.  Not used
   ToolHandle<LVL1::IL1TriggerTowerTool> m_ttTool;
   /// Tool for Missing FEB. Used first event only
   ToolHandle<LVL1::IL1CaloLArTowerEnergy> m_larEnergy;
@@ -29,6 +29,7 @@ class StatusCode;
 
 class TrigT1CaloMonErrorTool;
 class TrigT1CaloLWHistogramTool;
+class TrigT1CaloErrorBoardTool;
 
 namespace LVL1 {
   class JEMHits;
@@ -89,9 +90,6 @@ namespace LVL1 {
  *           @c <LVL1::JEMHits>        </td><td> Jet hits data                            </td></tr>
  *  <tr><td> @c DataVector
  *           @c <LVL1::JEMEtSums>      </td><td> Energy sums data                         </td></tr>
- *  <tr><td> @c std::vector<int>       <br>
- *           @c "L1CaloJEMErrorVector" </td><td> Output.
- *                                               Error summary bits for global histograms </td></tr>
  *  </table>
  *
  *  <b>Tools Used:</b>
@@ -100,6 +98,7 @@ namespace LVL1 {
  *  <tr><th> Tool                         </th><th> Description          </th></tr>
  *  <tr><td> @c TrigT1CaloMonErrorTool    </td><td> @copydoc m_errorTool </td></tr>
  *  <tr><td> @c TrigT1CaloLWHistogramTool </td><td> @copydoc m_histTool  </td></tr>
+ *  <tr><td> @c TrigT1CaloErrorBoardTool  </td><td> @copydoc m_errorBoard </td></tr>
  *  </table>
  *
  *  <b>JobOption Properties:</b>
@@ -154,6 +153,8 @@ private:
    ToolHandle<TrigT1CaloMonErrorTool>    m_errorTool;
    /// Histogram helper tool
    ToolHandle<TrigT1CaloLWHistogramTool> m_histTool;
+   /// Shared error summary board for global histograms
+   ToolHandle<TrigT1CaloErrorBoardTool>  m_errorBoard;
 
    /** location of data */
    /// JetElement collection StoreGate key
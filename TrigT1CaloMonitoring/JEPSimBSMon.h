@@ -19,6 +19,11 @@
 #include "AthenaMonitoring/ManagedMonitorToolBase.h"
 #include "DataModel/DataVector.h"
 
+#include "TrigT1CaloMonitoring/TrigT1CaloJetWindowEngine.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloLazyHists.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloObjectPool.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloTaskPool.h"
+
 class LWHist;
 class TH1F_LW;
 class TH2F_LW;
@@ -26,6 +31,8 @@ class TH2I_LW;
 class StatusCode;
 class TrigT1CaloMonErrorTool;
 class TrigT1CaloLWHistogramTool;
+class TrigT1CaloErrorBoardTool;
+class TrigT1CaloRodSummary;
 
 namespace LVL1 {
   class CMMEtSums;
@@ -36,7 +43,6 @@ namespace LVL1 {
   class JEMRoI;
   class JetAlgorithm;
   class JetElement;
-  class RODHeader;
   class TriggerTower;
   class IL1JEPHitsTools;
   class IL1JetElementTools;
@@ -121,12 +127,14 @@ namespace LVL1 {
  *  <tr><td> @c DataVector
  *           @c <LVL1::CMMEtSums>         </td><td> CMM Energy sums data                        </td></tr>
  *  <tr><td> @c LVL1::CMMRoI              </td><td> CMM RoI data                                </td></tr>
- *  <tr><td> @c DataVector
- *           @c <LVL1::RODHeader>         </td><td> ROD header data for LimitedRoISet bit
+ *  <tr><td> @c TrigT1CaloRodSummary
+ *           (@c <LVL1::RODHeader>)     </td><td> Decoded ROD headers for LimitedRoISet bit
  *                                                  and MinorVersion number                     </td></tr>
- *  <tr><td> @c std::vector<int>          <br>
- *           @c "L1CaloJEMMismatchVector" </td><td> Output.
- *                                                  Mismatch summary bits for global histograms </td></tr>
+ *  <tr><td> @c DataVector
+ *           @c <LVL1::JetElement>        <br>
+ *           @c <LVL1::JEMRoI>            <br>
+ *           @c <LVL1::JEMEtSums>         </td><td> Optional upstream simulation, used instead of
+ *                                                  simulating the same step again (see below)  </td></tr>
  *  </table>
  *
  *  <b>Tools Used:</b>
@@ -139,6 +147,7 @@ namespace LVL1 {
  *  <tr><td> @c LVL1::IL1JEPEtSumsTools   </td><td> @copydoc m_etSumsTool     </td></tr>
  *  <tr><td> @c TrigT1CaloMonErrorTool    </td><td> @copydoc m_errorTool      </td></tr>
  *  <tr><td> @c TrigT1CaloLWHistogramTool </td><td> @copydoc m_histTool       </td></tr>
+ *  <tr><td> @c TrigT1CaloErrorBoardTool  </td><td> @copydoc m_errorBoard     </td></tr>
  *  </table>
  *
  *  <b>JobOption Properties:</b>
@@ -159,9 +168,56 @@ namespace LVL1 {
  *  <tr><td> @c CMMEtSumsLocation         </td><td> @copydoc m_cmmEtSumsLocation         </td></tr>
  *  <tr><td> @c TriggerTowerLocation      </td><td> @copydoc m_triggerTowerLocation      </td></tr>
  *  <tr><td> @c RodHeaderLocation         </td><td> @copydoc m_rodHeaderLocation         </td></tr>
+ *  <tr><td> @c SimJEMRoILocation         </td><td> @copydoc m_simJemRoiLocation         </td></tr>
+ *  <tr><td> @c SimJEMEtSumsLocation      </td><td> @copydoc m_simJemEtSumsLocation      </td></tr>
+ *  <tr><td> @c UpstreamCheckEvents       </td><td> @copydoc m_upstreamCheckEvents       </td></tr>
  *  <tr><td> @c RootDirectory             </td><td> @copydoc m_rootDir                   </td></tr>
+ *  <tr><td> @c LazyBooking               </td><td> @copydoc m_lazyBooking               </td></tr>
+ *  <tr><td> @c RoIThreads                </td><td> @copydoc m_roiThreads                </td></tr>
+ *  <tr><td> @c ChainThreads              </td><td> @copydoc m_chainThreads              </td></tr>
+ *  <tr><td> @c JetWindowEngine           </td><td> @copydoc m_jetWindowEngine           </td></tr>
+ *  <tr><td> @c JetWindowCheckEvents      </td><td> @copydoc m_jetWindowCheckEvents      </td></tr>
  *  </table>
  *
+ *  The @c Sim* locations let a job which already runs the L1Calo simulation
+ *  (see TrigT1CaloMonitoring_L1CaloSimulation.py) reuse its output instead
+ *  of repeating a step.  A container is only used if it is present in the
+ *  event, and must be made by the same tools from the same input as the step
+ *  it replaces: JEM RoIs from core Jet Elements (@c Sim_JEMRoIs from
+ *  JEPCMMMaker) and JEM Et Sums from core Jet Elements (@c Sim_JEMEtSums
+ *  from EnergyTrigger).  Upstream RoIs are only used when core and overlap
+ *  Jet Elements agree with simulation, otherwise RoIs are simulated crate
+ *  by crate as before.  Steps which start from data of a later stage (JEM
+ *  hits from data RoIs, CMM sums from data CMM inputs) are always simulated
+ *  here.  For the first @c UpstreamCheckEvents events with upstream
+ *  containers, and every event with DEBUG output, the step is also
+ *  simulated here and the local result used.  If any upstream container
+ *  differs from it in the quantities compared with data, reuse is switched
+ *  off for the rest of the job with a warning, so the histograms are the
+ *  same as with local simulation.  The numbers checked and differing are
+ *  printed at finalize.
+ *
+ *  With @c ChainThreads > 1 the energy simulation (JEM Et Sums and the
+ *  CMM-Energy sums) runs in a second thread while the jet chain is
+ *  simulated and compared.  The energy comparisons follow once both are
+ *  done, so histograms and error bits are only ever filled by one thread
+ *  at a time and are the same as for serial running.  Like @c RoIThreads
+ *  this requires the simulation tools not to share mutable state, and it
+ *  is disabled when DEBUG output is enabled.
+ *  If a per-crate RoI task of @c RoIThreads fails the RoI comparison is
+ *  skipped for that event.
+ *
+ *  With @c JetWindowEngine RoIs simulated from core Jet Elements (when
+ *  core and overlap agree with simulation) are found by the jet tool only
+ *  around the RoI candidates of a TrigT1CaloJetWindowEngine, which gives
+ *  the same RoIs with fewer Jet Elements to evaluate.  For the first
+ *  @c JetWindowCheckEvents events using it, and every event with DEBUG
+ *  output, RoIs are also found from all Jet Elements and their RoI words
+ *  compared.  The full result is used for those events, and on any
+ *  difference the engine is switched off for the rest of the job with a
+ *  warning.  The number of events checked and differing is printed at
+ *  finalize.
+ *
  *  <b>Related Documentation:</b>
  *
  *  <a href="http://hepwww.rl.ac.uk/Atlas-L1/Modules/JEM/JEMspec12d.pdf">
@@ -187,6 +243,7 @@ public:
   virtual ~JEPSimBSMon();
 
   virtual StatusCode initialize();
+  virtual StatusCode finalize();
     
   virtual StatusCode bookHistogramsRecurrent();
   virtual StatusCode fillHistograms();
@@ -212,7 +269,6 @@ private:
   typedef DataVector<LVL1::JetAlgorithm> InternalRoiCollection;
   typedef DataVector<LVL1::JEMEtSums>    JemEtSumsCollection;
   typedef DataVector<LVL1::CMMEtSums>    CmmEtSumsCollection;
-  typedef DataVector<LVL1::RODHeader>    RodHeaderCollection;
   
   typedef std::vector<int> ErrorVector;
 
@@ -222,6 +278,32 @@ private:
   typedef std::map<int, LVL1::CMMJetHits*>   CmmJetHitsMap;
   typedef std::map<int, LVL1::JEMEtSums*>    JemEtSumsMap;
   typedef std::map<int, LVL1::CMMEtSums*>    CmmEtSumsMap;
+
+  /// RoI finding for one crate, run by m_roiPool
+  class CrateRoiTask;
+  /// Jet chain comparisons, run by m_chainPool
+  class JetChainTask;
+  /// Energy chain simulation, run by m_chainPool
+  class EnergySimTask;
+
+  /// Inputs to the jet chain comparisons
+  struct JetChainInput {
+    const TriggerTowerCollection* triggerTowers;
+    const JetElementCollection*   jetElements;
+    const JetElementCollection*   jetElementsOv;
+    const JemRoiCollection*       jemRois;
+    const CmmJetHitsCollection*   cmmJetHits;
+    const LVL1::CMMRoI*           cmmRoi;
+    /// Upstream simulated JEM RoIs, or 0
+    const JemRoiCollection*       upJemRois;
+    /// Check upstream RoIs against local simulation, using the latter
+    bool                          checkUpstream;
+    const JetElementMap*          jeMap;
+    const JetElementMap*          ovMap;
+    const JemRoiMap*              jrMap;
+    const JemHitsMap*             jhMap;
+    const CmmJetHitsMap*          cmMap;
+  };
   
   /// Compare Simulated JetElements with data
   bool  compare(const JetElementMap& jeSimMap, const JetElementMap& jeMap,
@@ -280,8 +362,8 @@ private:
   /// Simulate Jet Elements from Trigger Towers
   void  simulate(const TriggerTowerCollection* towers,
                        JetElementCollection* elements);
-  /// Simulate JEM RoIs from Jet Elements
-  void  simulate(const JetElementCollection* elements,
+  /// Simulate JEM RoIs from Jet Elements, false if crate tasks failed
+  bool  simulate(const JetElementCollection* elements,
                  const JetElementCollection* elementsOv,
 		       JemRoiCollection* rois);
   /// Simulate JEM RoIs from Jet Elements quick version
@@ -302,8 +384,29 @@ private:
   bool  limitedRoiSet(int crate);
   /// Return true if version with Missing-Et-Sig
   bool  hasMissingEtSig();
-  /// Load ROD Headers
-  void  loadRodHeaders();
+  /// Jet Element, RoI, JEM Hits and CMM-Jet comparisons,
+  /// return true if upstream RoIs used
+  bool  compareJetChain(const JetChainInput& in, ErrorVector& errorsJEM,
+                                                 ErrorVector& errorsCMM);
+  /// Simulate JEM Et Sums (if elements) and CMM-Energy sums (if sums)
+  void  simulateEnergyChain(const JetElementCollection* elements,
+                            const CmmEtSumsCollection*  sums);
+  /// Find RoIs from Jet Elements needed by the window engine into
+  /// m_intRois, return false if the engine cannot be used
+  bool  findRoIsNeeded(const JetElementCollection* elements);
+  /// Return true if RoI reference Jet Element is marked by the window engine
+  bool  marked(LVL1::JetAlgorithm* roi) const;
+  /// Return true if marked RoIs have the same RoI words as all RoIs
+  bool  sameRois(const InternalRoiCollection* rois,
+                 const InternalRoiCollection* allRois) const;
+  /// Compare upstream RoIs with RoIs simulated from Jet Elements
+  void  checkUpstream(const JemRoiCollection* rois,
+                      const JemRoiCollection* simRois);
+  /// Compare upstream Et Sums with simulated Et Sums
+  void  checkUpstream(const JemEtSumsCollection* sums);
+  /// Return upstream simulated container if key set and present, else 0
+  template <typename T>
+  const T* upstreamSim(const std::string& key);
 
   /// JEP hits simulation tool
   ToolHandle<LVL1::IL1JEPHitsTools>      m_jepHitsTool;
@@ -317,6 +420,8 @@ private:
   ToolHandle<TrigT1CaloMonErrorTool>     m_errorTool;
   /// Histogram helper tool
   ToolHandle<TrigT1CaloLWHistogramTool>  m_histTool;
+  /// Shared error summary board for global histograms
+  ToolHandle<TrigT1CaloErrorBoardTool>   m_errorBoard;
 
   /// Debug printout flag
   bool m_debug;
@@ -343,14 +448,84 @@ private:
   std::string m_triggerTowerLocation;
   /// ROD header container StoreGate key
   std::string m_rodHeaderLocation;
-  /// Pointer to ROD header container
-  const RodHeaderCollection* m_rodTES;
-  /// LimitedRoISet flags
-  int m_limitedRoi;
-  /// Version with Missimg-Et-Sig flag
-  bool m_versionSig;
+  /// Upstream simulated JEM RoI container StoreGate key, empty to simulate
+  std::string m_simJemRoiLocation;
+  /// Upstream simulated JEM Et Sums container StoreGate key, empty to simulate
+  std::string m_simJemEtSumsLocation;
+  /// Events with upstream containers checked before reuse, all with DEBUG
+  int m_upstreamCheckEvents;
+  /// Upstream containers in use, false after a difference
+  bool m_upstreamOn;
+  /// Number of upstream simulated containers used
+  unsigned long m_upstreamUsed;
+  /// Number of events with upstream simulated containers checked
+  unsigned long m_upstreamEvents;
+  /// Number of upstream simulated containers checked
+  unsigned long m_upstreamChecked;
+  /// Number of upstream simulated containers differing from local simulation
+  unsigned long m_upstreamDiffer;
+  /// Decoded ROD headers for current event
+  const TrigT1CaloRodSummary* m_rodSummary;
+  /// Only write mismatch histograms which are filled (offline)
+  bool m_lazyBooking;
   /// Histograms booked flag
   bool m_histBooked;
+  /// Mismatch histograms written only if filled
+  TrigT1CaloLazyHists m_lazyHists;
+  /// Threads for per-crate RoI simulation, 0 or 1 for serial
+  int m_roiThreads;
+  /// Worker threads for per-crate RoI simulation
+  TrigT1CaloTaskPool m_roiPool;
+  /// Per-crate RoI finding tasks
+  std::vector<CrateRoiTask*> m_crateTasks;
+  /// Threads for concurrent jet and energy chains, 0 or 1 for serial
+  int m_chainThreads;
+  /// Worker thread for concurrent jet and energy chains
+  TrigT1CaloTaskPool m_chainPool;
+  /// Jet chain task
+  JetChainTask* m_jetChainTask;
+  /// Energy chain simulation task
+  EnergySimTask* m_energySimTask;
+  /// Scratch zero-suppressed Trigger Tower view
+  TriggerTowerCollection* m_towersZ;
+  /// Scratch internal RoIs for quick RoI simulation
+  InternalRoiCollection* m_intRois;
+  /// Use window engine to find RoIs only around candidates
+  bool m_jetWindowEngine;
+  /// Events in which window engine RoIs are checked, all with DEBUG
+  int m_jetWindowCheckEvents;
+  /// Window engine in use, false after a difference
+  bool m_windowEngineOn;
+  /// Window engine switched off in this event
+  bool m_windowFallback;
+  /// Number of events with window engine RoIs checked
+  unsigned long m_windowChecked;
+  /// Number of events with window engine RoIs differing
+  unsigned long m_windowDiffer;
+  /// Summed-area table jet window engine
+  TrigT1CaloJetWindowEngine m_windowEngine;
+  /// Scratch view of Jet Elements needed by window engine candidates
+  JetElementCollection* m_elementsNeeded;
+  /// Scratch internal RoIs from all Jet Elements for window engine check
+  InternalRoiCollection* m_intRoisAll;
+  /// Scratch simulated Jet Elements
+  JetElementCollection* m_jetElementSim;
+  /// Scratch simulated JEM RoIs, a view of m_roiObjects
+  JemRoiCollection* m_jemRoiSim;
+  /// Scratch simulated JEM Hits
+  JemHitsCollection* m_jemHitsSim;
+  /// Scratch simulated CMM-Jet Hits
+  CmmJetHitsCollection* m_cmmJetHitsSim;
+  /// Scratch simulated JEM Et Sums
+  JemEtSumsCollection* m_jemEtSumsSim;
+  /// Scratch simulated CMM-Energy Local sums
+  CmmEtSumsCollection* m_cmmEtLocalSim;
+  /// Scratch simulated CMM-Energy Total sums
+  CmmEtSumsCollection* m_cmmEtTotalSim;
+  /// Scratch simulated CMM-Energy Et Maps
+  CmmEtSumsCollection* m_cmmSumEtSim;
+  /// Storage for simulated JEM RoIs
+  TrigT1CaloObjectPool<LVL1::JEMRoI> m_roiObjects;
 
   //=======================
   //   Match/Mismatch plots
@@ -20,13 +20,22 @@
 #include "AthenaMonitoring/ManagedMonitorToolBase.h"
 #include "DataModel/DataVector.h"
 
+#include "TrigT1CaloMonitoring/PPMSimLutCache.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloEventSampler.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloLazyHists.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloTaskPool.h"
+
 class TH2F_LW;
 class TH2I_LW;
+class TProfile_LW;
 
+class L1CaloCoolChannelId;
 class StatusCode;
 
 class TrigT1CaloMonErrorTool;
 class TrigT1CaloLWHistogramTool;
+class TrigT1CaloErrorBoardTool;
+class TrigT1CaloTowerTableTool;
 
 namespace LVL1 {
   class TriggerTower;
@@ -51,8 +60,15 @@ namespace LVL1 {
  *  <tr><th> Histogram                                       </th><th> Comment                                                  </th></tr>
  *  <tr><td> @c L1Calo/PPM/Errors/Data_Simulation/PPMLUTSim/ <br>
  *           @c ppm_{em|had}_2d_etaPhi_tt_lut_SimNoData      </td><td> Will always be empty if there are less than 7 ADC slices </td></tr>
+ *  <tr><td> @c L1Calo/PPM/Errors/Data_Simulation/PPMLUTSim/ <br>
+ *           @c ppm_1d_tt_lut_SamplingFraction               </td><td> Only booked if @c CpuBudget is set                       </td></tr>
  *  </table>
  *
+ *  If @c CpuBudget is set the simulation is run on a prescaled sample of
+ *  events, the prescale being adjusted every @c SamplingWindow seconds
+ *  to keep the tool's processing time within the budget.  The fraction of events
+ *  sampled is recorded by lumiblock so that rates can be corrected.
+ *
  *  <b>Custom Merges Used (Tier0):</b>
  *
  *  <table>
@@ -66,18 +82,17 @@ namespace LVL1 {
  *  <tr><th> Container                    </th><th> Comment                                  </th></tr>
  *  <tr><td> @c DataVector
  *           @c <LVL1::TriggerTower>      </td><td> PPM data                                 </td></tr>
- *  <tr><td> @c std::vector<int>          <br>
- *           @c "L1CaloPPMMismatchVector" </td><td> Output.
- *                                                  Error summary bits for global histograms </td></tr>
  *  </table>
  *
  *  <b>Tools Used:</b>
  *
  *  <table>
- *  <tr><th> Tool                         </th><th> Description          </th></tr>
- *  <tr><td> @c LVL1::IL1TriggerTowerTool </td><td> @copydoc m_ttTool    </td></tr>
- *  <tr><td> @c TrigT1CaloMonErrorTool    </td><td> @copydoc m_errorTool </td></tr>
- *  <tr><td> @c TrigT1CaloLWHistogramTool </td><td> @copydoc m_histTool  </td></tr>
+ *  <tr><th> Tool                         </th><th> Description           </th></tr>
+ *  <tr><td> @c LVL1::IL1TriggerTowerTool </td><td> @copydoc m_ttTool     </td></tr>
+ *  <tr><td> @c TrigT1CaloMonErrorTool    </td><td> @copydoc m_errorTool  </td></tr>
+ *  <tr><td> @c TrigT1CaloLWHistogramTool </td><td> @copydoc m_histTool   </td></tr>
+ *  <tr><td> @c TrigT1CaloErrorBoardTool  </td><td> @copydoc m_errorBoard </td></tr>
+ *  <tr><td> @c TrigT1CaloTowerTableTool  </td><td> @copydoc m_towerTable </td></tr>
  *  </table>
  *
  *  <b>JobOption Properties:</b>
@@ -87,8 +102,24 @@ namespace LVL1 {
  *  <tr><td> @c TriggerTowerLocation </td><td> @copydoc m_triggerTowerLocation </td></tr>
  *  <tr><td> @c RootDirectory        </td><td> @copydoc m_rootDir              </td></tr>
  *  <tr><td> @c SimulationADCCut     </td><td> @copydoc m_simulationADCCut     </td></tr>
+ *  <tr><td> @c LazyBooking          </td><td> @copydoc m_lazyBooking          </td></tr>
+ *  <tr><td> @c SimulationCacheSize  </td><td> @copydoc m_simulationCacheSize  </td></tr>
+ *  <tr><td> @c ZeroLutPreFilter     </td><td> @copydoc m_zeroLutPreFilter     </td></tr>
+ *  <tr><td> @c CpuBudget            </td><td> @copydoc m_cpuBudget            </td></tr>
+ *  <tr><td> @c SamplingWindow       </td><td> @copydoc m_samplingWindow       </td></tr>
+ *  <tr><td> @c SamplingLumiMax      </td><td> @copydoc m_samplingLumiMax      </td></tr>
+ *  <tr><td> @c SimThreads           </td><td> @copydoc m_simThreads           </td></tr>
  *  </table>
  *
+ *  The towers are divided by the PPM crate of their EM channel and each
+ *  crate is simulated by its own task, with its own share of the LUT
+ *  simulation cache, into a list of results.  The lists are then compared
+ *  with data and the histograms filled in crate order, so the output does
+ *  not depend on scheduling.  With @c SimThreads > 1 the crate tasks run
+ *  in parallel.  This requires the L1TriggerTowerTool simulation to be
+ *  re-entrant once conditions are loaded, and it is disabled when DEBUG
+ *  output is enabled.
+ *
  *  <b>Related Documentation:</b>
  *
  *  <a href="http://hepwww.rl.ac.uk/Atlas-L1/Modules/PPr/PPMod_Wrup.pdf">
@@ -126,15 +157,57 @@ private:
   /// Fill error event number histogram
   void  fillEventSample(int crate, int module);
 
+  /// Load calibration conditions and per-channel disabled flags
+  StatusCode loadConditions();
+  /// Return ADC level at or below which channel LUT output is always zero
+  int adcCeiling(int channel, const L1CaloCoolChannelId& coolId);
+  /// Return true if all waveforms with slices up to level give zero LUT
+  bool zeroLut(const L1CaloCoolChannelId& coolId, int level);
   /// Simulate LUT data from FADC data
   void simulateAndCompare(const TriggerTowerCollection* ttIn);
 
+  /// Simulation and data LUT values of one tower
+  struct TowerSim {
+    int    index;      ///< Tower table index
+    double eta;        ///< Tower eta
+    double phi;        ///< Tower phi
+    int    simEm;      ///< Simulated EM LUT
+    int    datEm;      ///< Data EM LUT
+    int    emSlices;   ///< Number of EM ADC slices
+    int    simHad;     ///< Simulated HAD LUT
+    int    datHad;     ///< Data HAD LUT
+    int    hadSlices;  ///< Number of HAD ADC slices
+  };
+  /// Scratch LUT simulation output
+  struct LutOutput {
+    std::vector<int> lut;
+    std::vector<int> bcidR;
+    std::vector<int> bcidD;
+  };
+  /// LUT simulation for one crate, run by m_simPool
+  class CrateSimTask;
+
+  /// Simulate one tower, return false if simulation and data all zero
+  bool simulateTower(const LVL1::TriggerTower* tt, int index,
+                     PPMSimLutCache& cache, LutOutput& out, TowerSim& sim);
+  /// Simulate LUT for one channel
+  int  simulateLayer(const std::vector<int>& adc, int peak, int dat,
+                     int channel, const L1CaloCoolChannelId& coolId,
+                     PPMSimLutCache& cache, LutOutput& out);
+  /// Compare simulated and data LUT of one tower and fill histograms
+  void compareTower(const TowerSim& sim, ErrorVector& crateError,
+                                         ErrorVector& moduleError);
+
   /// LUT simulation tool
   ToolHandle<LVL1::IL1TriggerTowerTool> m_ttTool;
   /// Corrupt event veto tool
   ToolHandle<TrigT1CaloMonErrorTool>    m_errorTool;
   /// Histogram helper tool
   ToolHandle<TrigT1CaloLWHistogramTool> m_histTool;
+  /// Shared error summary board for global histograms
+  ToolHandle<TrigT1CaloErrorBoardTool>  m_errorBoard;
+  /// Per-run table of tower identifiers and hardware coordinates
+  ToolHandle<TrigT1CaloTowerTableTool>  m_towerTable;
       
   /// Debug printout flag
   bool m_debug;
@@ -149,8 +222,44 @@ private:
   int m_events;
   /// Cut on ADC digits for re-simulation
   int m_simulationADCCut;
+  /// Only write mismatch histograms which are filled (offline)
+  bool m_lazyBooking;
   /// Histograms booked flag
   bool m_histBooked;
+  /// Mismatch histograms written only if filled
+  TrigT1CaloLazyHists m_lazyHists;
+  /// Conditions loaded for current lumiblock flag
+  bool m_conditionsValid;
+  /// Number of conditions loads
+  int m_conditionsLoads;
+  /// Channel disabled flags by tower table index and layer
+  std::vector<char> m_channelDisabled;
+  /// Number of cached LUT simulation results, 0 to disable
+  int m_simulationCacheSize;
+  /// Skip simulation below per-channel zero LUT ADC ceiling
+  bool m_zeroLutPreFilter;
+  /// Zero LUT ADC ceiling by channel, valid for the loaded conditions
+  std::vector<int> m_adcCeiling;
+  /// Ceiling not yet computed flag value
+  static const int s_ceilingUnknown = -2;
+  /// Maximum ADC value
+  static const int s_maxAdc = 1023;
+  /// Processing seconds per second budget, 0 for no sampling
+  double m_cpuBudget;
+  /// Sampling prescale adjustment interval in seconds
+  int m_samplingWindow;
+  /// Maximum lumiblock in sampling fraction plot
+  int m_samplingLumiMax;
+  /// Event prescale within CPU budget
+  TrigT1CaloEventSampler m_sampler;
+  /// Threads for per-crate LUT simulation, 0 or 1 for serial
+  int m_simThreads;
+  /// Worker threads for per-crate LUT simulation
+  TrigT1CaloTaskPool m_simPool;
+  /// Per-crate LUT simulation tasks
+  std::vector<CrateSimTask*> m_crateTasks;
+  /// Number of PPM crates
+  static const int s_crates = 8;
 
   //=======================
   //   Match/Mismatch plots
@@ -171,6 +280,9 @@ private:
   TH2I_LW* m_h_ppm_2d_LUT_MismatchEvents_cr2cr3;   ///< PPM LUT Mismatch Event Numbers Crates 2 and 3
   TH2I_LW* m_h_ppm_2d_LUT_MismatchEvents_cr4cr5;   ///< PPM LUT Mismatch Event Numbers Crates 4 and 5
   TH2I_LW* m_h_ppm_2d_LUT_MismatchEvents_cr6cr7;   ///< PPM LUT Mismatch Event Numbers Crates 6 and 7
+
+  // Sampling
+  TProfile_LW* m_h_ppm_1d_tt_lut_SamplingFraction; ///< Fraction of Events Sampled by Lumiblock
   
 };
 
@@ -0,0 +1,86 @@
+// ********************************************************************
+//
+// NAME:     PPMSimLutCache.h
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+#ifndef PPMSIMLUTCACHE_H
+#define PPMSIMLUTCACHE_H
+
+#include <vector>
+
+/** Bounded memo of PPM LUT simulation results.
+ *
+ *  Most towers passing the simulation ADC cut carry near-pedestal
+ *  waveforms which recur from event to event, and for fixed conditions
+ *  the FIR, BCID and LUT simulation of a channel depends only on its ADC
+ *  slices.  Results are cached keyed on channel and ADC slices in a
+ *  direct-mapped table of fixed capacity; a new result replaces any
+ *  other occupying its slot.  Keys are compared in full so a hash
+ *  collision can never return a wrong result.
+ *
+ *  The cache must be cleared whenever the simulation conditions change.
+ *  A capacity of zero disables caching.
+ */
+
+class PPMSimLutCache
+{
+
+ public:
+
+  PPMSimLutCache();
+
+  /// Set capacity and clear the cache
+  void setup(int capacity);
+  /// Clear the cache but not the counters
+  void clear();
+
+  /// Copy cached LUT and BCID output if channel and ADC found
+  bool find(int channel, const std::vector<int>& adc,
+            std::vector<int>& lut, std::vector<int>& bcidR,
+	    std::vector<int>& bcidD);
+  /// Store LUT and BCID output for channel and ADC
+  void insert(int channel, const std::vector<int>& adc,
+              const std::vector<int>& lut, const std::vector<int>& bcidR,
+	      const std::vector<int>& bcidD);
+
+  /// Return the number of successful lookups
+  unsigned long hits() const;
+  /// Return the number of failed lookups
+  unsigned long misses() const;
+
+ private:
+
+  /// One cached simulation result
+  struct Entry {
+    int              channel;       ///< Channel, -1 if slot empty
+    unsigned int     hash;          ///< Hash of channel and ADC
+    std::vector<int> adc;           ///< ADC slices
+    std::vector<int> lut;           ///< Simulated LUT output
+    std::vector<int> bcidR;         ///< Simulated BCID raw output
+    std::vector<int> bcidD;         ///< Simulated BCID decision output
+  };
+
+  /// Return hash of channel and ADC slices
+  static unsigned int hash(int channel, const std::vector<int>& adc);
+
+  /// Cache slots
+  std::vector<Entry> m_entries;
+  /// Successful lookups
+  unsigned long m_hits;
+  /// Failed lookups
+  unsigned long m_misses;
+
+};
+
+inline unsigned long PPMSimLutCache::hits() const
+{
+  return m_hits;
+}
+
+inline unsigned long PPMSimLutCache::misses() const
+{
+  return m_misses;
+}
+
+#endif
@@ -0,0 +1,108 @@
+// ********************************************************************
+//
+// NAME:     PPrErrorDecoder.h
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+#ifndef PPRERRORDECODER_H
+#define PPRERRORDECODER_H
+
+#include "TrigT1CaloUtils/DataError.h"
+
+/** Table-driven decoding of PPM trigger tower error words.
+ *
+ *  The error word holds the 8-bit ASIC error field from bit
+ *  @c DataError::ChannelDisabled and the 8-bit SubStatus word from bit
+ *  @c DataError::GLinkParity.  The global overview bits for every value
+ *  of each byte are tabulated once, so a tower error needs two lookups
+ *  instead of a chain of @c DataError::get calls.  Set bits, which are
+ *  the summary histogram bins, are iterated with nextBit().
+ *
+ *  The ASIC errors detail histograms come in blocks, one per pair of
+ *  error bits; detailBlock() and detailX() give the block and x position
+ *  for each ASIC error bit.
+ *
+ *  <table>
+ *  <tr><th> Block </th><th> Errors                                  </th></tr>
+ *  <tr><td>   0   </td><td> Channel 0 and 1 disabled                </td></tr>
+ *  <tr><td>   1   </td><td> Channel 2 and 3 disabled                </td></tr>
+ *  <tr><td>   2   </td><td> MCM absent                              </td></tr>
+ *  <tr><td>   3   </td><td> Timeout, ASIC full                      </td></tr>
+ *  <tr><td>   4   </td><td> Event mismatch, bunch mismatch          </td></tr>
+ *  <tr><td>   5   </td><td> FIFO corrupt, pin parity                </td></tr>
+ *  </table>
+ */
+
+class PPrErrorDecoder
+{
+
+ public:
+
+  PPrErrorDecoder();
+
+  /// Return ASIC error field bits of error word
+  static int asicBits(int error);
+  /// Return SubStatus word bits of error word
+  static int statusBits(int error);
+  /// Return global overview bits for ASIC error field and SubStatus bits
+  int overview(int asic, int status) const;
+
+  /// Return lowest set bit number and clear it
+  static int nextBit(int& bits);
+
+  /// Return ASIC errors detail histogram block for ASIC error bit
+  static int detailBlock(int bit, int channel);
+  /// Return ASIC errors detail histogram x position for ASIC error bit
+  static int detailX(int bit, int channel, int submodule);
+
+ private:
+
+  /// Overview bits by ASIC error field value
+  unsigned char m_asicOverview[256];
+  /// Overview bits by SubStatus word value
+  unsigned char m_statusOverview[256];
+
+};
+
+inline int PPrErrorDecoder::asicBits(int error)
+{
+  return (static_cast<unsigned int>(error) >> LVL1::DataError::ChannelDisabled)
+                                                                      & 0xff;
+}
+
+inline int PPrErrorDecoder::statusBits(int error)
+{
+  return (static_cast<unsigned int>(error) >> LVL1::DataError::GLinkParity)
+                                                                      & 0xff;
+}
+
+inline int PPrErrorDecoder::overview(int asic, int status) const
+{
+  return m_asicOverview[asic] | m_statusOverview[status];
+}
+
+inline int PPrErrorDecoder::nextBit(int& bits)
+{
+#if defined(__GNUC__)
+  const int bit = __builtin_ctz(bits);
+#else
+  int bit = 0;
+  while (!((bits >> bit) & 1)) ++bit;
+#endif
+  bits &= bits - 1;
+  return bit;
+}
+
+inline int PPrErrorDecoder::detailBlock(int bit, int channel)
+{
+  if (bit == 0) return channel/2;
+  return (bit == 1) ? 2 : bit/2 + 2;
+}
+
+inline int PPrErrorDecoder::detailX(int bit, int channel, int submodule)
+{
+  if (bit == 0) return (channel%2)*16 + submodule;
+  return (bit >= 3 && (bit%2)) ? 16 + submodule : submodule;
+}
+
+#endif
@@ -11,11 +11,17 @@
 #ifndef PPRMON_H
 #define PPRMON_H
 
+#include <stdint.h>
 #include <string>
 #include <vector>
 
 #include "AthenaMonitoring/ManagedMonitorToolBase.h"
 #include "GaudiKernel/ToolHandle.h"
+#include "TrigT1CaloMonitoring/PPrErrorDecoder.h"
+#include "TrigT1CaloMonitoring/PPrPeakFinder.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloLazyHists.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloProfileStore.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloTowerTableTool.h"
 
 class TH1F_LW;
 class TH2F_LW;
@@ -27,10 +33,7 @@ class StatusCode;
 
 class TrigT1CaloMonErrorTool;
 class TrigT1CaloLWHistogramTool;
-
-namespace LVL1 {
-  class IL1TriggerTowerTool;
-}
+class TrigT1CaloErrorBoardTool;
 
 /** Monitoring of the Preprocessor
  *
@@ -77,7 +80,17 @@ namespace LVL1 {
  *  <tr><th> Histogram                                     </th><th> Comment                                 </th></tr>
  *  <tr><td> @c L1Calo/PPM/ADC/Timeslices/                 <br>
  *           @c ppm_{em|had}_2d_etaPhi_tt_adc_MaxTimeslice </td><td> Timeslices are numbered 1-nslice so empty bins can be distinguished </td></tr>
- *  <tr><td> @c ppm_{em|had}_1d_tt_adc_SignalProfileXXXXXX </td><td> Average ADC values each slice for Lut>0 </td></tr>
+ *  <tr><td> @c ppm_{em|had}_1d_tt_adc_SignalProfileXXXXXX </td><td> Average ADC values each slice for Lut>0.
+ *                                                           Updated with the LUT hitmaps </td></tr>
+ *  <tr><td> @c L1Calo/PPM/LUT-{CP|JEP}/EtaPhiMaps/      </td><td> Filled from counts kept per tower at the end
+ *                                                           of each lumiblock and run, and online also
+ *                                                           every @c LUTHitMap_UpdateEvents events, so
+ *                                                           published maps can lag by that many events </td></tr>
+ *  <tr><td> <tt>L1Calo/PPM/LUT-{CP|JEP}/EtaPhiMaps/lumi_N </tt></td><td> Ring of slots booked once per run, N
+ *                                                           being the slot not the age.  At the start
+ *                                                           of each lumiblock the oldest slot is cleared
+ *                                                           for it, and its title gets the lumiblock
+ *                                                           number at the first event </td></tr>
  *  </table>
  *
  *  <b>Custom Merges Used (Tier0):</b>
@@ -94,18 +107,16 @@ namespace LVL1 {
  *  <tr><td> @c DataVector
  *           @c <LVL1::TriggerTower>   </td><td> PPM data                                 </td></tr>
  *  <tr><td> @c EventInfo              </td><td> For bunch crossing number via @c EventID </td></tr>
- *  <tr><td> @c std::vector<int>       <br>
- *           @c "L1CaloPPMErrorVector" </td><td> Output.
- *                                               Error summary bits for global histograms </td></tr>
  *  </table>
  *
  *  <b>Tools Used:</b>
  *
  *  <table>
- *  <tr><th> Tool                         </th><th> Description          </th></tr>
- *  <tr><td> @c TrigT1CaloMonErrorTool    </td><td> @copydoc m_errorTool </td></tr>
- *  <tr><td> @c TrigT1CaloLWHistogramTool </td><td> @copydoc m_histTool  </td></tr>
- *  <tr><td> @c LVL1::IL1TriggerTowerTool </td><td> @copydoc m_ttTool    </td></tr>
+ *  <tr><th> Tool                         </th><th> Description           </th></tr>
+ *  <tr><td> @c TrigT1CaloMonErrorTool    </td><td> @copydoc m_errorTool  </td></tr>
+ *  <tr><td> @c TrigT1CaloLWHistogramTool </td><td> @copydoc m_histTool   </td></tr>
+ *  <tr><td> @c TrigT1CaloErrorBoardTool  </td><td> @copydoc m_errorBoard </td></tr>
+ *  <tr><td> @c TrigT1CaloTowerTableTool  </td><td> @copydoc m_towerTable </td></tr>
  *  </table>
  *
  *  <b>JobOption Properties:</b>
@@ -123,6 +134,8 @@ namespace LVL1 {
  *  <tr><td> @c ErrorPathInRootFile      </td><td> @copydoc m_ErrorPathInRootFile       </td></tr>
  *  <tr><td> @c OnlineTest               </td><td> @copydoc m_onlineTest                </td></tr>
  *  <tr><td> @c LUTHitMap_ThreshVec      </td><td> @copydoc m_TT_HitMap_ThreshVec       </td></tr>
+ *  <tr><td> @c LUTHitMap_UpdateEvents   </td><td> @copydoc m_TT_HitMap_UpdateEvents    </td></tr>
+ *  <tr><td> @c LazyBooking              </td><td> @copydoc m_lazyBooking               </td></tr>
  *  </table>
  *
  *  <b>Related Documentation:</b>
@@ -147,20 +160,28 @@ class PPrMon: public ManagedMonitorToolBase
   virtual StatusCode initialize();
   virtual StatusCode bookHistogramsRecurrent();
   virtual StatusCode fillHistograms();
+  virtual StatusCode procHistograms();
 private:
-  
-  /// Subdetector partitions
-  enum CaloPartitions { LArFCAL1C, LArEMECC, LArOverlapC, LArEMBC, LArEMBA,
-      LArOverlapA, LArEMECA, LArFCAL1A, LArFCAL23C, LArHECC,
-      TileEBC, TileLBC, TileLBA, TileEBA, LArHECA, LArFCAL23A,
-      MaxPartitions };
 
-  /// Find signal maximum FADC slice
-  double recTime(const std::vector<int>& vFAdc, int cut);
-  /// Return subdetector partition
-  int partition(int layer, double eta);
-  /// Return subdetector partition name
-  std::string partitionName(int part);
+  /// LUT threshold hitmap types
+  enum HitMapTypes { EmLutCp, HadLutCp, EmLutJep, HadLutJep, MaxHitMapTypes };
+
+  /// Count tower LUT Et in Et occupancy store
+  void countEt(int tower, int type, int et);
+  /// Fill error histograms and overview for one tower layer error word
+  void fillErrors(int error, const TrigT1CaloTowerTableTool::Channel& chan,
+                  std::vector<int>& overview);
+  /// Add Et occupancy store to threshold hitmaps and clear it
+  void flushHitMaps();
+  /// Update signal profiles from the signal shape store
+  void flushProfiles();
+  /// Return name and title of online hitmap for threshold, slot and lumiblock (-1 if not known)
+  void lumiHitMapNames(int type, int thresh, int block, int lumiNumber,
+                       std::string& name, std::string& title);
+  /// Make the oldest online lumiblock hitmap slot current and clear it
+  void rotateLumiHitMaps();
+  /// Put lumiblock number in titles of current online lumiblock hitmaps
+  void setLumiHitMapTitles(int lumiNumber);
 
   /// TriggerTower Container key
   std::string m_TriggerTowerContainerName;
@@ -168,6 +189,9 @@ private:
   std::vector<unsigned int> m_TT_HitMap_ThreshVec;
   /// The number of back lumiblocks for separate LUT hitmaps online
   int m_TT_HitMap_LumiBlocks;
+  /// The number of events between LUT hitmap updates online, also updated
+  /// at end of lumiblock.  Published hitmaps can lag by up to this many events
+  int m_TT_HitMap_UpdateEvents;
   /// ADC cut for hitmaps
   int m_TT_ADC_HitMap_Thresh;
   /// The maximum number of ADC slices
@@ -182,9 +206,36 @@ private:
   int m_EMFADCCut;
   /// Flag to test online code offline
   bool m_onlineTest;
+  /// Only write error detail histograms which are filled (offline)
+  bool m_lazyBooking;
   /// Histograms booked flag
   bool m_histBooked;
 
+  /// Et bin (number of hitmap thresholds below Et) for each LUT Et
+  std::vector<int> m_etBin;
+  /// Number of hitmap thresholds below each hitmap threshold
+  std::vector<int> m_threshBin;
+  /// Tower counts by hitmap type and Et bin since last hitmap update
+  std::vector<uint32_t> m_etCounts;
+  /// Et occupancy store not empty flag
+  bool m_etCountsFilled;
+  /// Events since last hitmap update
+  int m_eventsSinceFlush;
+  /// Online lumiblock hitmap slot of the current lumiblock
+  int m_hitMapSlot;
+  /// Current lumiblock hitmap titles need lumiblock number flag
+  bool m_hitMapTitlePending;
+  /// EM FADC signal peak finder
+  PPrPeakFinder m_emPeakFinder;
+  /// HAD FADC signal peak finder
+  PPrPeakFinder m_hadPeakFinder;
+  /// Error word decoding tables
+  PPrErrorDecoder m_errorDecoder;
+  /// Signal shape sums by partition and slice for the run
+  TrigT1CaloProfileStore m_signalProfiles;
+  /// Error detail histograms written only if filled
+  TrigT1CaloLazyHists m_lazyHists;
+
   /// Root directory
   std::string m_PathInRootFile;
   /// Root directory for error plots
@@ -194,8 +245,10 @@ private:
   ToolHandle<TrigT1CaloMonErrorTool>      m_errorTool;
   /// Histogram helper tool
   ToolHandle<TrigT1CaloLWHistogramTool>   m_histTool;
-  /// TT simulation tool for Identifiers
-  ToolHandle<LVL1::IL1TriggerTowerTool>   m_ttTool; 
+  /// Shared error summary board for global histograms
+  ToolHandle<TrigT1CaloErrorBoardTool>    m_errorBoard;
+  /// Per-run table of tower identifiers and hardware coordinates
+  ToolHandle<TrigT1CaloTowerTableTool>    m_towerTable;
 
   // ADC hitmaps
   TH2F_LW* m_h_ppm_em_2d_etaPhi_tt_adc_HitMap;                  ///< eta-phi Map of EM FADC > cut for triggered timeslice
@@ -0,0 +1,93 @@
+// ********************************************************************
+//
+// NAME:     PPrPeakFinder.h
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+#ifndef PPRPEAKFINDER_H
+#define PPRPEAKFINDER_H
+
+#include <utility>
+#include <vector>
+
+/** Batched FADC signal peak finder for PPM timing plots.
+ *
+ *  Finds for each tower the FADC slice with the maximum ADC value.
+ *  The peak is rejected if the maximum is zero or is shared by more than
+ *  one slice, or if the signal, the sum over a window of up to five
+ *  slices around the peak less the window minimum, is not above a cut.
+ *  ADC values below pedestal are raised to pedestal before summing.
+ *
+ *  The ADC samples of all towers in an event are buffered slice-major
+ *  so that process() can handle several towers at once with SSE2
+ *  integer compares.  Towers with a different number of slices from the
+ *  buffer, and all towers on platforms without SSE2 or with
+ *  setVectorised(false), use the scalar method.  Results of both are
+ *  identical to the former PPrMon::recTime, as checked by the
+ *  PPrPeakFinder unit test.
+ *
+ *  Usage per event: clear(), add() each tower, process(), then peak()
+ *  by the position returned from add().
+ */
+
+class PPrPeakFinder
+{
+
+ public:
+
+  PPrPeakFinder();
+
+  /// Empty the buffer and size it for towers with the given slices
+  void clear(int slices, int towers);
+  /// Add tower ADC samples and return tower position in buffer
+  int add(const std::vector<int>& adc);
+  /// Find peaks of all buffered towers
+  void process(int pedestal, int cut);
+
+  /// Return peak slice of tower at position, or -1 if no peak
+  int peak(int pos) const;
+
+  /// Use SSE2 where available (default true), false for scalar only
+  void setVectorised(bool vectorised);
+
+  /// Return peak slice of one tower, or -1 if no peak (scalar version)
+  static int peak(const std::vector<int>& adc, int pedestal, int cut);
+
+ private:
+
+  /// Towers handled together
+  static const int s_lanes = 4;
+
+  /// Find peaks of buffered towers from first to last
+  void processScalar(int first, int last, int pedestal, int cut);
+  /// Find peaks of buffered towers in blocks of lanes
+  int processVector(int pedestal, int cut);
+
+  /// Use SSE2 flag
+  bool m_vectorised;
+  /// Number of slices of buffered towers
+  int m_slices;
+  /// Number of towers added
+  int m_towers;
+  /// Buffer stride between slices
+  int m_stride;
+  /// ADC samples, slice-major
+  std::vector<int> m_adc;
+  /// Peak slice by tower position
+  std::vector<int> m_peak;
+  /// Towers not buffered because of a different number of slices
+  std::vector<std::pair<int, const std::vector<int>*> > m_others;
+
+};
+
+inline int PPrPeakFinder::peak(int pos) const
+{
+  return m_peak[pos];
+}
+
+inline void PPrPeakFinder::setVectorised(bool vectorised)
+{
+  m_vectorised = vectorised;
+}
+
+#endif
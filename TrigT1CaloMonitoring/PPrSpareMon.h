@@ -15,6 +15,8 @@
 
 #include "AthenaMonitoring/ManagedMonitorToolBase.h"
 #include "GaudiKernel/ToolHandle.h"
+#include "TrigT1CaloMonitoring/PPrErrorDecoder.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloLazyHists.h"
 
 class TH1F_LW;
 class TH2F_LW;
@@ -61,10 +63,6 @@ class TrigT1CaloLWHistogramTool;
  *  <tr><th> Container                      </th><th> Comment                                  </th></tr>
  *  <tr><td> @c DataVector
  *           @c <LVL1::TriggerTower>        </td><td> PPM data spare channels only             </td></tr>
- *  <tr><td> @c std::vector<int>            <br>
- *           @c "L1CaloPPMSpareErrorVector" </td><td> Output.
- *                                                    Error summary bits for global histograms <br>
- *                                                    (currently disabled)                     </td></tr>
  *  </table>
  *
  *  <b>Tools Used:</b>
@@ -83,6 +81,7 @@ class TrigT1CaloLWHistogramTool;
  *  <tr><td> @c ADCHitMap_Thresh         </td><td> @copydoc m_TT_ADC_HitMap_Thresh      </td></tr>
  *  <tr><td> @c PathInRootFile           </td><td> @copydoc m_PathInRootFile            </td></tr>
  *  <tr><td> @c ErrorPathInRootFile      </td><td> @copydoc m_ErrorPathInRootFile       </td></tr>
+ *  <tr><td> @c LazyBooking              </td><td> @copydoc m_lazyBooking               </td></tr>
  *  </table>
  *
  *  <b>Related Documentation:</b>
@@ -117,8 +116,14 @@ private:
   int m_TT_ADC_HitMap_Thresh;
   /// The maximum number of ADC slices
   int m_SliceNo;
+  /// Only write error detail histograms which are filled (offline)
+  bool m_lazyBooking;
   /// Histograms booked flag
   bool m_histBooked;
+  /// Error word decoding tables
+  PPrErrorDecoder m_errorDecoder;
+  /// Error detail histograms written only if filled
+  TrigT1CaloLazyHists m_lazyHists;
 
   /// Root directory
   std::string m_PathInRootFile;
@@ -13,21 +13,32 @@
 #define TRIGT1CALOMONITORING_PPRSTABILITYMON_H
 
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "AthenaMonitoring/ManagedMonitorToolBase.h"
 #include "GaudiKernel/ToolHandle.h"
 
+#include "TrigT1CaloMonitoring/TrigT1CaloChannelStats.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloEventSampler.h"
+
 class StatusCode;
 class EventInfo;
+class Identifier;
+class TProfile_LW;
+class TProfile2D_LW;
 
 class TrigT1CaloMonErrorTool;
 class TrigT1CaloLWHistogramTool;
+class TrigT1CaloTowerTableTool;
 class L1CaloPprFineTimePlotManager;
 class L1CaloPprPedestalPlotManager;
 class L1CaloPprEtCorrelationPlotManager;
 
 namespace LVL1 {
   class IL1TriggerTowerTool;
+  class IL1CaloMonitoringCaloTool;
+  class TriggerTower;
 }
 
 /** This class does stability monitoring by lumiblock
@@ -40,6 +51,58 @@ namespace LVL1 {
  *  and L1CaloPprPedestalPlotManager, sub-classes of L1CaloPprPlotManager,
  *  from the package TrigT1CaloCalibTools to generate the monitoring histograms.
  *
+ *  Optionally (@c CompactStore) the plot managers are replaced by
+ *  TrigT1CaloChannelStats stores of the mean and variance of each
+ *  quantity for each channel and lumiblock, one update per channel instead
+ *  of several histogram fills.  The quantities are:
+ *
+ *  <table>
+ *  <tr><th> Quantity       </th><th> Value stored                            </th></tr>
+ *  <tr><td> Pedestal       </td><td> Mean ADC of a layer with zero Et        </td></tr>
+ *  <tr><td> Fine time      </td><td> Peak time from a parabola through the
+ *                                    peak slice and its neighbours, in ns,
+ *                                    less the reference and times the
+ *                                    calibration factor from the database.
+ *                                    Peak ADC must be above @c ppmADCMinValue
+ *                                    and below @c ppmADCMaxValue, the result
+ *                                    within @c fineTimeCut, and with
+ *                                    @c doCaloQualCut the calo quality at
+ *                                    most @c CaloQualityMax              </td></tr>
+ *  <tr><td> Et correlation </td><td> Calo Et over L1Calo Et of a layer with
+ *                                    Et above @c EtMinForEtCorrelation    </td></tr>
+ *  </table>
+ *
+ *  A store takes 84 kB per lumiblock with data, about 40 MB for all three
+ *  in a run of 150 lumiblocks, rather than the several thousand
+ *  per-channel histograms of the plot managers, so that stability can be
+ *  monitored in the main monitoring process.  At the end of each
+ *  lumiblock the by lumiblock plots get that lumiblock and the eta/phi
+ *  maps are remade from the run so far.  The pedestal plots show the
+ *  difference from the channel mean of the run so far, the same reference
+ *  for all lumiblocks, so they are remade at each update and at the end
+ *  of the run are relative to the end-of-run mean.  Per-channel plots are
+ *  made only for the channels listed in @c ChannelPlots.
+ *
+ *  @c CompactStore is off by default because its fine time and Et
+ *  correlation are computed here rather than by the plot managers of
+ *  TrigT1CaloCalibTools, and its plots have different names from those
+ *  the data quality configuration and Tier0 merges expect.
+ *
+ *  @c TimeSeriesFile names a columnar binary file (see
+ *  TrigT1CaloTimeSeriesFile) to which the mean, RMS and entries of each
+ *  quantity monitored, as @c pedestal, @c fineTime and @c etCorrelation
+ *  columns, are written by channel and lumiblock at the end of each run,
+ *  with @c _run.l1ts appended to the name.  A whole run can then be read
+ *  for stability analysis without iterating over histograms.  Setting it
+ *  fills the stores alongside the plot managers if @c CompactStore is
+ *  off.
+ *
+ *  If @c CpuBudget is set only a prescaled sample of events is analysed,
+ *  the prescale being adjusted every @c SamplingWindow seconds to keep
+ *  the processing time within the budget.  The by lumiblock plots are averages
+ *  so are unbiased by the prescale.  The fraction of events sampled is
+ *  recorded by lumiblock in @c ppm_1d_stability_SamplingFraction.
+ *
  *  <b>ROOT Histogram Directories (Tier0):</b>
  *
  *  <table>
@@ -56,6 +119,23 @@ namespace LVL1 {
  *                                                           from mean                       </td></tr>
  *  </table>
  *
+ *  <b>ROOT Histogram Directories (compact store):</b>
+ *
+ *  <table>
+ *  <tr><th> Directory                             </th><th> Contents                        </th></tr>
+ *  <tr><td> @c L1Calo/PPrStabilityMon/Pedestal    </td><td> Pedestal difference from channel mean
+ *                                                           by lumiblock for each partition <br>
+ *                                                           Eta/phi profiles of pedestal mean
+ *                                                           and RMS by TriggerTower         </td></tr>
+ *  <tr><td> @c L1Calo/PPrStabilityMon/Pedestal/Channels </td><td> Pedestal by lumiblock for each
+ *                                                           channel requested               </td></tr>
+ *  <tr><td> @c L1Calo/PPrStabilityMon/FineTime    <br>
+ *           @c L1Calo/PPrStabilityMon/FineTime/Channels </td><td> Ditto for fine time, by lumiblock
+ *                                                           not as a difference             </td></tr>
+ *  <tr><td> @c L1Calo/PPrStabilityMon/EtCorrelation <br>
+ *           @c L1Calo/PPrStabilityMon/EtCorrelation/Channels </td><td> Ditto for Et correlation </td></tr>
+ *  </table>
+ *
  *  <b>ROOT Histogram Directories (online):</b>
  *
  *  <table>
@@ -96,17 +176,20 @@ namespace LVL1 {
  *  <tr><th> Container               </th><th> Comment                                      </th></tr>
  *  <tr><td> @c DataVector
  *           @c <LVL1::TriggerTower> </td><td> PPM data                                     </td></tr>
- *  <tr><td> @c CaloCellContainer    </td><td> Calo data. EtCorrelation and FineTime only   </td></tr>
+ *  <tr><td> @c CaloCellContainer    </td><td> Calo data. EtCorrelation and FineTime only,
+ *                                             via @c m_caloTool with the compact store     </td></tr>
  *  <tr><td> @c EventInfo            </td><td> For run and lumiblock numbers via @c EventID </td></tr>
  *  </table>
  *
  *  <b>Tools Used:</b>
  *
  *  <table>
- *  <tr><th> Tool                         </th><th> Description          </th></tr>
- *  <tr><td> @c LVL1::IL1TriggerTowerTool </td><td> @copydoc m_ttTool    </td></tr>
- *  <tr><td> @c TrigT1CaloMonErrorTool    </td><td> @copydoc m_errorTool </td></tr>
- *  <tr><td> @c TrigT1CaloLWHistogramTool </td><td> @copydoc m_histTool  </td></tr>
+ *  <tr><th> Tool                         </th><th> Description           </th></tr>
+ *  <tr><td> @c LVL1::IL1TriggerTowerTool </td><td> @copydoc m_ttTool     </td></tr>
+ *  <tr><td> @c TrigT1CaloMonErrorTool    </td><td> @copydoc m_errorTool  </td></tr>
+ *  <tr><td> @c TrigT1CaloLWHistogramTool </td><td> @copydoc m_histTool   </td></tr>
+ *  <tr><td> @c TrigT1CaloTowerTableTool  </td><td> @copydoc m_towerTable </td></tr>
+ *  <tr><td> @c LVL1::IL1CaloMonitoringCaloTool </td><td> @copydoc m_caloTool </td></tr>
  *  </table>
  *
  *  <b>JobOption Properties:</b>
@@ -125,6 +208,12 @@ namespace LVL1 {
  *  <tr><td> @c pedestalMaxWidth          </td><td> @copydoc m_pedestalMaxWidth          </td></tr>
  *  <tr><td> @c EtMinForEtCorrelation     </td><td> @copydoc m_EtMinForEtCorrelation     </td></tr>
  *  <tr><td> @c doCaloQualCut             </td><td> @copydoc m_doCaloQualCut             </td></tr>
+ *  <tr><td> @c CompactStore              </td><td> @copydoc m_compactStore              </td></tr>
+ *  <tr><td> @c ChannelPlots              </td><td> @copydoc m_channelPlots              </td></tr>
+ *  <tr><td> @c CaloQualityMax            </td><td> @copydoc m_caloQualityMax            </td></tr>
+ *  <tr><td> @c TimeSeriesFile            </td><td> @copydoc m_timeSeriesFile            </td></tr>
+ *  <tr><td> @c CpuBudget                 </td><td> @copydoc m_cpuBudget                 </td></tr>
+ *  <tr><td> @c SamplingWindow            </td><td> @copydoc m_samplingWindow            </td></tr>
  *  </table>
  *
  *  <!--
@@ -145,10 +234,40 @@ class PPrStabilityMon: public ManagedMonitorToolBase
 
   virtual StatusCode initialize();
   virtual StatusCode finalize();
+  virtual StatusCode bookHistogramsRecurrent();
   virtual StatusCode fillHistograms();
   virtual StatusCode procHistograms();
 
 private:
+  /// Load fine time references and snapshot per-channel conditions
+  StatusCode loadConditions();
+  /// Quantities kept in compact stores
+  enum StoreQuantities { Pedestal, FineTime, EtCorrelation, MaxStores };
+  /// Plots made from one compact store
+  struct StoreHists {
+    TProfile2D_LW* emMean;                      ///< EM mean by eta/phi
+    TProfile2D_LW* hadMean;                     ///< HAD mean by eta/phi
+    TProfile2D_LW* emRMS;                       ///< EM RMS by eta/phi
+    TProfile2D_LW* hadRMS;                      ///< HAD RMS by eta/phi
+    std::vector<TProfile_LW*> byLumi;           ///< By lumiblock by partition
+    std::vector<TProfile_LW*> channelByLumi;    ///< By lumiblock by channel, 0 if none
+  };
+
+  /// Add both layers of a tower to the compact stores
+  void fillStores(const LVL1::TriggerTower* tt, int index, int lumiBlock);
+  /// Add mean of ADC slices to pedestal store for channel and lumiblock
+  void fillPedestalStats(const std::vector<int>& adc, int channel,
+                         int lumiBlock);
+  /// Add fine time to store for channel and lumiblock if it passes cuts
+  void fillFineTimeStats(const std::vector<int>& adc, int peak, int channel,
+                         const Identifier& id, int lumiBlock);
+  /// Book plots made from the compact stores
+  void bookStoreHists();
+  /// Update plots from a compact store at the end of lumiblock
+  void fillStoreHists(int quantity, int lumiBlock);
+  /// Write compact stores to columnar time-series file
+  void writeTimeSeries();
+
   /// Cut on ADC minimum value, used for fine time monitoring
   unsigned int m_ppmADCMinValue;
   /// Cut on ADC maximum value, used for fine time monitoring
@@ -162,6 +281,10 @@ private:
   ToolHandle<TrigT1CaloLWHistogramTool> m_histTool;
   /// Tool for identifiers and database info
   ToolHandle<LVL1::IL1TriggerTowerTool> m_ttTool;
+  /// Per-run table of tower identifiers and hardware coordinates
+  ToolHandle<TrigT1CaloTowerTableTool>  m_towerTable;
+  /// Calo cell Et and quality by TriggerTower for the compact store
+  ToolHandle<LVL1::IL1CaloMonitoringCaloTool> m_caloTool;
   /// Manager for fine time plots
   L1CaloPprFineTimePlotManager*         m_fineTimePlotManager;
   /// Manager for pedestal plots
@@ -191,6 +314,48 @@ private:
   double m_EtMinForEtCorrelation;
   /// Switch for calo quality cut via job options in fine time 
   bool m_doCaloQualCut;
+  /// Use compact stores instead of plot managers
+  bool m_compactStore;
+  /// COOL channel IDs for per-channel plots from compact stores
+  std::vector<unsigned int> m_channelPlots;
+  /// Maximum calo quality for fine time with calo quality cut, compact store only
+  double m_caloQualityMax;
+  /// Fill compact stores flag
+  bool m_useStores;
+  /// Calo cells needed by compact stores flag
+  bool m_storeCaloCells;
+  /// Time-series file name prefix, empty for none
+  std::string m_timeSeriesFile;
+  /// Processing seconds per second budget, 0 for no sampling
+  double m_cpuBudget;
+  /// Sampling prescale adjustment interval in seconds
+  int m_samplingWindow;
+  /// Event prescale within time budget
+  TrigT1CaloEventSampler m_sampler;
+  /// Fraction of events sampled by lumiblock
+  TProfile_LW* m_h_ppm_1d_stability_SamplingFraction;
+
+  /// Conditions snapshot valid for current lumiblock flag
+  bool m_conditionsValid;
+  /// Number of conditions snapshots
+  int m_conditionsLoads;
+  /// Number of events processed
+  int m_events;
+  /// Current run number
+  unsigned int m_runNumber;
+  /// Current lumiblock
+  int m_lumiBlock;
+  /// Last lumiblock added to plots from the compact stores, -1 if none
+  int m_storeLumiBlockDone;
+  /// Channel disabled flags by channel (2*tower index + layer)
+  std::vector<char> m_channelDisabled;
+  /// Fine time reference and calibration factor by channel
+  std::vector<std::pair<double, double> > m_fineTimeRefs;
+
+  /// Moments by channel (2*tower index + layer) and lumiblock, by quantity
+  TrigT1CaloChannelStats m_stats[MaxStores];
+  /// Plots from the compact stores, by quantity
+  StoreHists m_storeHists[MaxStores];
   
 };
 
@@ -0,0 +1,141 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloCPTowerArray.h
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+#ifndef TRIGT1CALOCPTOWERARRAY_H
+#define TRIGT1CALOCPTOWERARRAY_H
+
+#include <cmath>
+#include <vector>
+
+#include <stdint.h>
+
+/** Per-event table of towers in the CP region, indexed by eta-phi bin.
+ *
+ *  Replaces a map keyed on TriggerTowerKey for tower-by-tower
+ *  comparisons.  The 50 eta bins of 0.1 covering |eta| < 2.5 each hold
+ *  64 phi bins, so index() is <tt>etaBin*64 + phiBin</tt> and the
+ *  occupancy of one eta bin fits in a 64-bit word.  Occupied towers are
+ *  visited in index order by scanning the words with nextBit(), and
+ *  clear() only touches occupied entries, so the cost per event follows
+ *  the number of towers rather than the size of the table.
+ *
+ *  Only the first object inserted at an index is kept.
+ */
+
+template <class T>
+class TrigT1CaloCPTowerArray
+{
+
+ public:
+
+  /// Number of eta bins, also the number of occupancy words
+  static const int s_etaBins = 50;
+  /// Number of phi bins
+  static const int s_phiBins = 64;
+  /// Number of table entries
+  static const int s_size = s_etaBins*s_phiBins;
+
+  TrigT1CaloCPTowerArray();
+
+  /// Return index for tower eta, phi, or -1 if outside the CP region
+  static int index(double eta, double phi);
+
+  /// Remove all towers
+  void clear();
+  /// Add tower at index unless already occupied
+  void insert(int index, T* tower);
+  /// Return tower at index, or 0 if none
+  T* operator[](int index) const;
+  /// Return occupancy word for eta bin
+  uint64_t word(int etaBin) const;
+  /// Return true if no towers
+  bool empty() const;
+
+  /// Return lowest set bit number of word and clear it
+  static int nextBit(uint64_t& bits);
+
+ private:
+
+  /// Towers by index
+  std::vector<T*> m_towers;
+  /// Occupancy bits by eta bin
+  std::vector<uint64_t> m_occupied;
+  /// Number of towers
+  int m_count;
+
+};
+
+template <class T>
+TrigT1CaloCPTowerArray<T>::TrigT1CaloCPTowerArray()
+  : m_towers(s_size, static_cast<T*>(0)),
+    m_occupied(s_etaBins, 0),
+    m_count(0)
+{
+}
+
+template <class T>
+int TrigT1CaloCPTowerArray<T>::index(double eta, double phi)
+{
+  const int etaBin = static_cast<int>(std::floor((eta + 2.5)/0.1));
+  const int phiBin = static_cast<int>(std::floor(phi/(2.*M_PI/s_phiBins)));
+  if (etaBin < 0 || etaBin >= s_etaBins ||
+      phiBin < 0 || phiBin >= s_phiBins) return -1;
+  return etaBin*s_phiBins + phiBin;
+}
+
+template <class T>
+void TrigT1CaloCPTowerArray<T>::clear()
+{
+  if (m_count == 0) return;
+  for (int etaBin = 0; etaBin < s_etaBins; ++etaBin) {
+    uint64_t bits = m_occupied[etaBin];
+    while (bits) m_towers[etaBin*s_phiBins + nextBit(bits)] = 0;
+    m_occupied[etaBin] = 0;
+  }
+  m_count = 0;
+}
+
+template <class T>
+inline void TrigT1CaloCPTowerArray<T>::insert(int index, T* tower)
+{
+  if (index < 0 || m_towers[index]) return;
+  m_towers[index] = tower;
+  m_occupied[index/s_phiBins] |= (uint64_t(1) << (index%s_phiBins));
+  ++m_count;
+}
+
+template <class T>
+inline T* TrigT1CaloCPTowerArray<T>::operator[](int index) const
+{
+  return m_towers[index];
+}
+
+template <class T>
+inline uint64_t TrigT1CaloCPTowerArray<T>::word(int etaBin) const
+{
+  return m_occupied[etaBin];
+}
+
+template <class T>
+inline bool TrigT1CaloCPTowerArray<T>::empty() const
+{
+  return m_count == 0;
+}
+
+template <class T>
+inline int TrigT1CaloCPTowerArray<T>::nextBit(uint64_t& bits)
+{
+#if defined(__GNUC__)
+  const int bit = __builtin_ctzll(bits);
+#else
+  int bit = 0;
+  while (!((bits >> bit) & 1)) ++bit;
+#endif
+  bits &= bits - 1;
+  return bit;
+}
+
+#endif
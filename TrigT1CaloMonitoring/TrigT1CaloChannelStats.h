@@ -0,0 +1,167 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloChannelStats.h
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+#ifndef TRIGT1CALOCHANNELSTATS_H
+#define TRIGT1CALOCHANNELSTATS_H
+
+#include <cmath>
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+/** Running mean and variance by channel and lumiblock.
+ *
+ *  Keeps for each channel and lumiblock the number of entries, mean and
+ *  sum of squared deviations from the mean (Welford's method), so that
+ *  stability plots by lumiblock, by channel or by partition can be made
+ *  from it whenever wanted instead of being filled for every entry.
+ *
+ *  A lumiblock record is a 32-bit count and two floats, 12 bytes, so the
+ *  7168 PPM channels take 84 kB for each lumiblock with data.  Records are
+ *  held in slabs of all channels, allocated @c s_chunkSlabs lumiblocks at
+ *  a time when a lumiblock is first filled, so that records never move
+ *  once allocated.  Slabs are kept by clear() for reuse in the next run.
+ *  Running totals over all lumiblocks are kept in double precision for
+ *  each channel, so that total() does not walk the lumiblocks.
+ *  Lumiblocks outside the range given to setup() are ignored.
+ */
+
+class TrigT1CaloChannelStats
+{
+
+ public:
+
+  /// Running moments with fields of type T
+  template <typename T>
+  struct BasicMoments {
+    BasicMoments() : entries(0), mean(0), m2(0) {}
+    /// Add one value
+    void add(double x);
+    /// Merge moments of an independent sample (Chan et al.)
+    template <typename U> void add(const BasicMoments<U>& other);
+    /// Return sample variance, zero for fewer than two entries
+    double variance() const { return (entries > 1) ? m2/(entries - 1) : 0.; }
+    /// Return square root of variance
+    double rms() const { return std::sqrt(variance()); }
+    /// Number of entries
+    uint32_t entries;
+    /// Mean
+    T mean;
+    /// Sum of squared deviations from the mean
+    T m2;
+  };
+  /// Moments of one channel in one lumiblock
+  typedef BasicMoments<float>  Moments;
+  /// Moments of one channel over all lumiblocks
+  typedef BasicMoments<double> Totals;
+
+  /// Lumiblock slabs allocated together
+  static const int s_chunkSlabs = 16;
+
+  TrigT1CaloChannelStats();
+
+  /// Set dimensions and clear
+  void setup(int channels, int lumiBlocks);
+  /// Clear all entries, keeping dimensions and allocated slabs
+  void clear();
+
+  /// Add value x for channel in lumiblock
+  void fill(int channel, int lumiBlock, double x);
+
+  /// Return moments for channel in lumiblock, 0 if lumiblock has no data
+  const Moments* moments(int channel, int lumiBlock) const;
+  /// Return moments for channel merged over all lumiblocks
+  const Totals& total(int channel) const;
+
+  /// Return the number of channels
+  int channels() const;
+  /// Return the number of lumiblocks
+  int lumiBlocks() const;
+  /// Return true if any channel has data in lumiblock
+  bool filled(int lumiBlock) const;
+  /// Return bytes of moments storage allocated
+  std::size_t memory() const;
+
+ private:
+
+  /// Return slab for a new lumiblock, allocating a chunk if needed
+  Moments* newSlab();
+
+  /// Number of channels
+  int m_channels;
+  /// Number of lumiblocks
+  int m_lumiBlocks;
+  /// Slabs in use
+  int m_slabsUsed;
+  /// Slab of moments by channel for each lumiblock, 0 if none
+  std::vector<Moments*> m_slab;
+  /// Chunks of s_chunkSlabs slabs, reserved so never reallocated
+  std::vector<std::vector<Moments> > m_chunks;
+  /// Moments over all lumiblocks by channel
+  std::vector<Totals> m_totals;
+
+};
+
+template <typename T>
+inline void TrigT1CaloChannelStats::BasicMoments<T>::add(double x)
+{
+  ++entries;
+  const double delta = x - mean;
+  const double newMean = mean + delta/entries;
+  m2  += delta*(x - newMean);
+  mean = newMean;
+}
+
+template <typename T> template <typename U>
+inline void TrigT1CaloChannelStats::BasicMoments<T>::add(
+                                                const BasicMoments<U>& other)
+{
+  if (other.entries == 0) return;
+  const double n1 = entries;
+  const double n2 = other.entries;
+  const double n  = n1 + n2;
+  const double delta = double(other.mean) - mean;
+  m2      += other.m2 + delta*delta*n1*n2/n;
+  mean    += delta*n2/n;
+  entries += other.entries;
+}
+
+inline const TrigT1CaloChannelStats::Moments*
+      TrigT1CaloChannelStats::moments(int channel, int lumiBlock) const
+{
+  if (lumiBlock < 0 || lumiBlock >= m_lumiBlocks) return 0;
+  const Moments* slab = m_slab[lumiBlock];
+  return (slab) ? slab + channel : 0;
+}
+
+inline const TrigT1CaloChannelStats::Totals&
+      TrigT1CaloChannelStats::total(int channel) const
+{
+  return m_totals[channel];
+}
+
+inline int TrigT1CaloChannelStats::channels() const
+{
+  return m_channels;
+}
+
+inline int TrigT1CaloChannelStats::lumiBlocks() const
+{
+  return m_lumiBlocks;
+}
+
+inline bool TrigT1CaloChannelStats::filled(int lumiBlock) const
+{
+  return (lumiBlock >= 0 && lumiBlock < m_lumiBlocks && m_slab[lumiBlock]);
+}
+
+inline std::size_t TrigT1CaloChannelStats::memory() const
+{
+  return m_chunks.size() * s_chunkSlabs * m_channels * sizeof(Moments)
+       + m_totals.size() * sizeof(Totals);
+}
+
+#endif
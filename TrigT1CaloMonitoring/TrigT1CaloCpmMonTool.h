@@ -26,6 +26,7 @@ class StatusCode;
 
 class TrigT1CaloMonErrorTool;
 class TrigT1CaloLWHistogramTool;
+class TrigT1CaloErrorBoardTool;
 
 namespace LVL1 {
   class CPMTower;
@@ -103,9 +104,6 @@ namespace LVL1 {
  *           @c <LVL1::CPMHits>        </td><td> CPM Hits data                            </td></tr>
  *  <tr><td> @c DataVector
  *           @c <LVL1::CMMCPHits>      </td><td> CMM-CP Hits data                         </td></tr>
- *  <tr><td> @c std::vector<int>       <br>
- *           @c "L1CaloCPMErrorVector" </td><td> Output.
- *                                               Error summary bits for global histograms </td></tr>
  *  </table>
  *
  *  <b>Tools Used:</b>
@@ -114,6 +112,7 @@ namespace LVL1 {
  *  <tr><th> Tool                         </th><th> Description          </th></tr>
  *  <tr><td> @c TrigT1CaloMonErrorTool    </td><td> @copydoc m_errorTool </td></tr>
  *  <tr><td> @c TrigT1CaloLWHistogramTool </td><td> @copydoc m_histTool  </td></tr>
+ *  <tr><td> @c TrigT1CaloErrorBoardTool  </td><td> @copydoc m_errorBoard </td></tr>
  *  </table>
  *
  *  <b>JobOption Properties:</b>
@@ -185,6 +184,8 @@ private:
   ToolHandle<TrigT1CaloMonErrorTool>    m_errorTool;
   /// Histogram helper tool
   ToolHandle<TrigT1CaloLWHistogramTool> m_histTool;
+  /// Shared error summary board for global histograms
+  ToolHandle<TrigT1CaloErrorBoardTool>  m_errorBoard;
 
   /// Core CPM tower container StoreGate key
   std::string m_cpmTowerLocation;
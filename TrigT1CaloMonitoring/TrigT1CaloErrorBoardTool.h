@@ -0,0 +1,102 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloErrorBoardTool.h
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+#ifndef TRIGT1CALOERRORBOARDTOOL_H
+#define TRIGT1CALOERRORBOARDTOOL_H
+
+#include <string>
+#include <vector>
+
+#include "AthenaBaseComps/AthAlgTool.h"
+#include "GaudiKernel/IIncidentListener.h"
+
+class Incident;
+class StatusCode;
+
+static const InterfaceID IID_TrigT1CaloErrorBoardTool(
+                                       "TrigT1CaloErrorBoardTool", 1, 1);
+
+/** Per-event error and mismatch summary bits for the global histograms.
+ *
+ *  Each monitoring tool which contributes to the global overview writes
+ *  its per-crate error bits here with set(), and TrigT1CaloGlobalMonTool
+ *  reads them back with errors().  This replaces a std::vector<int>
+ *  recorded in StoreGate by each tool every event.  Storage is fixed,
+ *  so nothing is allocated per event, and the board is cleared on each
+ *  BeginEvent incident so that a tool which skips an event leaves no
+ *  stale bits.
+ *
+ *  The tool is public and shared, so clients should use the default
+ *  instance name.
+ *
+ *  <table>
+ *  <tr><th> Source        </th><th> Writer               </th><th> Crates </th></tr>
+ *  <tr><td> PPMError      </td><td> PPrMon               </td><td>   8    </td></tr>
+ *  <tr><td> PPMSpareError </td><td> PPrSpareMon (disabled) </td><td> 8    </td></tr>
+ *  <tr><td> CPMError      </td><td> TrigT1CaloCpmMonTool </td><td>   4    </td></tr>
+ *  <tr><td> JEMError      </td><td> JEMMon               </td><td>   2    </td></tr>
+ *  <tr><td> JEMCMMError   </td><td> CMMMon               </td><td>   2    </td></tr>
+ *  <tr><td> RODError      </td><td> TrigT1CaloRodMonTool </td><td>  14    </td></tr>
+ *  <tr><td> PPMMismatch   </td><td> PPMSimBSMon          </td><td>   8    </td></tr>
+ *  <tr><td> CPMMismatch   </td><td> CPMSimBSMon          </td><td>   4    </td></tr>
+ *  <tr><td> JEMMismatch   </td><td> JEPSimBSMon          </td><td>   2    </td></tr>
+ *  </table>
+ */
+
+class TrigT1CaloErrorBoardTool: public AthAlgTool,
+                                virtual public IIncidentListener
+{
+
+ public:
+
+  /// Error summary sources
+  enum Source { PPMError, PPMSpareError, CPMError, JEMError, JEMCMMError,
+                RODError, PPMMismatch, CPMMismatch, JEMMismatch,
+                NumberOfSources };
+
+  TrigT1CaloErrorBoardTool(const std::string& type, const std::string& name,
+                           const IInterface* parent);
+  virtual ~TrigT1CaloErrorBoardTool();
+
+  /// AlgTool InterfaceID
+  static const InterfaceID& interfaceID();
+
+  virtual StatusCode initialize();
+  virtual StatusCode finalize();
+
+  /// Clear the board at the start of each event
+  virtual void handle(const Incident& incident);
+
+  /// Store per-crate bits for source, false if wrong number of crates
+  bool set(Source source, const std::vector<int>& crateErr);
+  /// Return per-crate bits for source, or 0 if not set this event
+  const int* errors(Source source) const;
+  /// Return the number of crates for source
+  static int crates(Source source);
+
+ private:
+
+  /// Largest number of crates of any source
+  static const int s_maxCrates = 14;
+
+  /// Per-crate bits by source
+  int m_errors[NumberOfSources][s_maxCrates];
+  /// Set this event flags by source
+  bool m_set[NumberOfSources];
+
+};
+
+inline const InterfaceID& TrigT1CaloErrorBoardTool::interfaceID()
+{
+  return IID_TrigT1CaloErrorBoardTool;
+}
+
+inline const int* TrigT1CaloErrorBoardTool::errors(Source source) const
+{
+  return (m_set[source]) ? m_errors[source] : 0;
+}
+
+#endif
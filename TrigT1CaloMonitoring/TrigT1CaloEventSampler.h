@@ -0,0 +1,100 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloEventSampler.h
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+#ifndef TRIGT1CALOEVENTSAMPLER_H
+#define TRIGT1CALOEVENTSAMPLER_H
+
+#include <ctime>
+
+/** Event prescale keeping a monitoring tool within a time budget.
+ *
+ *  The budget is given in seconds of the tool's own processing time per
+ *  second of wall time.  Processing time is the elapsed wall time between
+ *  accept() and done(), so it covers work the tool hands to its own
+ *  worker threads but not other tools or threads running meanwhile, as
+ *  a process CPU clock would.  Over each window of wall time the sampler
+ *  measures the mean processing time of the events processed and the
+ *  rate of events offered.  At the end of the window it sets the prescale to the
+ *  smallest which keeps the expected cost within the budget, up to a
+ *  maximum of 1000.  Events are accepted when the event number is a
+ *  multiple of the prescale, so the selection is reproducible.
+ *
+ *  With a budget of zero the sampler is disabled and accepts every event.
+ *  Clients should record the fraction accepted so that normalisations
+ *  can be corrected.
+ */
+
+class TrigT1CaloEventSampler
+{
+
+ public:
+
+  TrigT1CaloEventSampler();
+
+  /// Set budget in processing seconds per second, 0 to disable, and window in seconds
+  void setup(double budget, int window);
+  /// Return true if sampling is enabled
+  bool enabled() const;
+
+  /// Return true if event should be processed, and start timing it
+  bool accept(unsigned int eventNumber);
+  /// Stop timing accepted event
+  void done();
+
+  /// Return the current prescale
+  int prescale() const;
+  /// Return the number of prescale changes
+  int changes() const;
+
+ private:
+
+  /// Maximum prescale
+  static const int s_maxPrescale = 1000;
+
+  /// Set prescale from the measurements of the last window
+  void update(std::time_t now);
+  /// Return wall clock time in seconds
+  static double wallTime();
+
+  /// Processing seconds per second budget
+  double m_budget;
+  /// Measurement window in seconds
+  int m_window;
+  /// Current prescale
+  int m_prescale;
+  /// Number of prescale changes
+  int m_changes;
+  /// Start of current window
+  std::time_t m_windowStart;
+  /// Events offered in current window
+  unsigned int m_offered;
+  /// Events timed in current window
+  unsigned int m_processed;
+  /// Processing seconds used in current window
+  double m_used;
+  /// Wall clock time at start of current event
+  double m_start;
+  /// Timing current event flag
+  bool m_timing;
+
+};
+
+inline bool TrigT1CaloEventSampler::enabled() const
+{
+  return m_budget > 0.;
+}
+
+inline int TrigT1CaloEventSampler::prescale() const
+{
+  return m_prescale;
+}
+
+inline int TrigT1CaloEventSampler::changes() const
+{
+  return m_changes;
+}
+
+#endif
@@ -22,10 +22,12 @@ class TH2F;
 class StatusCode;
 class TrigT1CaloMonErrorTool;
 class TrigT1CaloLWHistogramTool;
+class TrigT1CaloErrorBoardTool;
 
 /** Summary error plots across all L1Calo sub-detectors.
  *
- *  Error info is passed from other monitoring tools via StoreGate.
+ *  Error info is passed from other monitoring tools via
+ *  TrigT1CaloErrorBoardTool.
  *
  *  <b>ROOT Histogram Directories:</b>
  *
@@ -148,34 +150,15 @@ class TrigT1CaloLWHistogramTool;
  *  <table>
  *  <tr><th> Container                      </th><th> Comment                             </th></tr>
  *  <tr><td> @c EventInfo                   </td><td> For lumiblock number                </td></tr>
- *  <tr><td> @c std::vector<int>            <br>
- *           @c "L1CaloPPMErrorVector"      </td><td> Error summary bits from PPrMon      </td></tr>
- *  <tr><td> @c std::vector<int>            <br>
- *           @c "L1CaloPPMSpareErrorVector" </td><td> Error summary bits from PPrSpareMon </td></tr>
- *  <tr><td> @c std::vector<int>            <br>
- *           @c "L1CaloCPMErrorVector"      </td><td> Error summary bits from TrigT1CaloCpmMonTool
- *                                                                                        </td></tr>
- *  <tr><td> @c std::vector<int>            <br>
- *           @c "L1CaloJEMErrorVector"      </td><td> Error summary bits from JEMMon      </td></tr>
- *  <tr><td> @c std::vector<int>            <br>
- *           @c "L1CaloJEMCMMErrorVector"   </td><td> Error summary bits from CMMMon      </td></tr>
- *  <tr><td> @c std::vector<int>            <br>
- *           @c "L1CaloRODErrorVector"      </td><td> Error summary bits from TrigT1CaloRodMonTool
- *                                                                                        </td></tr>
- *  <tr><td> @c std::vector<int>            <br>
- *           @c "L1CaloPPMMismatchVector"   </td><td> Error summary bits from PPMSimBSMon </td></tr>
- *  <tr><td> @c std::vector<int>            <br>
- *           @c "L1CaloCPMMismatchVector"   </td><td> Error summary bits from CPMSimBSMon </td></tr>
- *  <tr><td> @c std::vector<int>            <br>
- *           @c "L1CaloJEMMismatchVector"   </td><td> Error summary bits from JEPSimBSMon </td></tr>
  *  </table>
  *
  *  <b>Tools Used:</b>
  *
  *  <table>
- *  <tr><th> Tool                         </th><th> Description          </th></tr>
- *  <tr><td> @c TrigT1CaloMonErrorTool    </td><td> @copydoc m_errorTool </td></tr>
- *  <tr><td> @c TrigT1CaloLWHistogramTool </td><td> @copydoc m_histTool  </td></tr>
+ *  <tr><th> Tool                         </th><th> Description           </th></tr>
+ *  <tr><td> @c TrigT1CaloMonErrorTool    </td><td> @copydoc m_errorTool  </td></tr>
+ *  <tr><td> @c TrigT1CaloLWHistogramTool </td><td> @copydoc m_histTool   </td></tr>
+ *  <tr><td> @c TrigT1CaloErrorBoardTool  </td><td> @copydoc m_errorBoard </td></tr>
  *  </table>
  *
  *  <b>JobOption Properties:</b>
@@ -257,8 +240,6 @@ private:
 		      RODStatus, RODMissing, ROBStatus, Unpacking,
 		      NumberOfGlobalErrors };
 
-  typedef std::vector<int> ErrorVector;
-
   /// Book and label global overview plot
   TH2F* bookOverview(const std::string& name, const std::string& title);
 
@@ -266,6 +247,8 @@ private:
   ToolHandle<TrigT1CaloMonErrorTool>    m_errorTool;
   /// Histogram helper tool
   ToolHandle<TrigT1CaloLWHistogramTool> m_histTool;
+  /// Shared error summary board, written by the other monitoring tools
+  ToolHandle<TrigT1CaloErrorBoardTool>  m_errorBoard;
 
   /// Root directory
   std::string m_rootDir;
@@ -286,7 +269,6 @@ private:
   //========================
 
   TH2F* m_h_l1calo_2d_GlobalOverview;       ///< L1Calo Global Error Overview
-  TH2F* m_h_l1calo_2d_CurrentEventOverview; ///< L1Calo Current Event Error Overview (temporary)
   TH2F* m_h_l1calo_2d_GlobalOverviewRecent; ///< L1Calo Global Error Overview Last m_recentLumi Lumiblocks
   TH1F* m_h_l1calo_1d_ErrorsByLumiblock;    ///< Events with Errors by Lumiblock
   TH1F* m_h_l1calo_1d_ErrorsByTime;         ///< Time of First Event in Lumiblock with Error/Events with Errors by Time
@@ -0,0 +1,142 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloJetWindowEngine.h
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+#ifndef TRIGT1CALOJETWINDOWENGINE_H
+#define TRIGT1CALOJETWINDOWENGINE_H
+
+#include <vector>
+
+/** Summed-area table jet window engine for JEM RoI simulation.
+ *
+ *  Holds the Jet Element ET of an event on the dense eta/phi grid of
+ *  Jet Elements (32 x 32, phi periodic) and builds a summed-area table
+ *  over it, so that the sum of any window is four lookups.  process()
+ *  evaluates the 2x2 RoI core at every grid position and the
+ *  local-maximum test against the eight overlapping neighbouring cores
+ *  in one pass over contiguous arrays.
+ *
+ *  A JEM RoI needs its core to be non-zero and not below any of its
+ *  neighbours, whichever way the jet algorithm breaks ties, so the
+ *  positions passing that test are a superset of the RoIs.  Their core
+ *  Jet Elements are marked.  Everything the jet algorithm looks at for an
+ *  RoI lies within two Jet Elements of its core, so those elements are
+ *  flagged as needed.  Jet Elements with ET at or above saturation mark
+ *  all elements within two positions, as the algorithm may then compare
+ *  saturated rather than summed values.
+ *
+ *  Running LVL1::IL1JetTools::findRoIs on the needed elements only and
+ *  keeping the RoIs whose reference Jet Element is marked gives the same
+ *  RoIs, with the same threshold configuration and RoI words, as running
+ *  it on all elements.  This is checked against a direct sliding-window
+ *  RoI finder by the TrigT1CaloJetWindowEngine unit test, and against
+ *  findRoIs itself in JEPSimBSMon.
+ *
+ *  Usage per event: clear(), add() each Jet Element, process(), then
+ *  needed() and marked() by grid position.
+ */
+
+class TrigT1CaloJetWindowEngine
+{
+
+ public:
+
+  TrigT1CaloJetWindowEngine();
+
+  /// Set grid dimensions and saturation ET, and clear
+  void setup(int etaBins, int phiBins, int saturation);
+  /// Clear all ET
+  void clear();
+
+  /// Add ET at grid position, return false if outside the grid
+  bool add(int eta, int phi, int et);
+  /// Build summed-area table and find RoI candidates
+  void process();
+
+  /// Return sum of window with lower corner at grid position
+  int sum(int eta, int phi, int etaSize, int phiSize) const;
+  /// Return true if Jet Element at grid position may be an RoI reference
+  bool marked(int eta, int phi) const;
+  /// Return true if Jet Element at grid position is needed for marked RoIs
+  bool needed(int eta, int phi) const;
+  /// Return the number of RoI candidate positions found by process()
+  int candidates() const;
+
+  /// Return Jet Element grid eta bin, -1 if outside
+  static int etaIndex(double eta);
+  /// Return Jet Element grid phi bin
+  static int phiIndex(double phi);
+  /// Number of Jet Element grid eta bins
+  static const int s_etaBins = 32;
+  /// Number of Jet Element grid phi bins
+  static const int s_phiBins = 32;
+
+ private:
+
+  /// Padding around grid, enough for windows at the grid edges
+  static const int s_pad = 3;
+
+  /// Return offset of grid position in padded arrays
+  int cell(int eta, int phi) const;
+  /// Build summed-area table of padded array into table
+  void buildTable(const std::vector<int>& cells, std::vector<int>& table);
+  /// Sum from table of window with lower corner at grid position
+  int tableSum(const std::vector<int>& table, int eta, int phi,
+               int etaSize, int phiSize) const;
+
+  /// Grid eta bins
+  int m_etaBins;
+  /// Grid phi bins
+  int m_phiBins;
+  /// Saturation ET
+  int m_saturation;
+  /// Padded array eta stride
+  int m_stride;
+  /// Padded array phi rows
+  int m_rows;
+  /// RoI candidates found
+  int m_candidates;
+  /// True if any ET added since clear()
+  bool m_filled;
+  /// ET by padded cell, phi padding wrapped by process()
+  std::vector<int> m_et;
+  /// Summed-area table of m_et
+  std::vector<int> m_table;
+  /// 2x2 core sums by padded cell of lower corner
+  std::vector<int> m_core;
+  /// Marked RoI references by padded cell, phi padding wrapped
+  std::vector<int> m_marked;
+  /// Summed-area table of m_marked
+  std::vector<int> m_markedTable;
+
+};
+
+inline int TrigT1CaloJetWindowEngine::cell(int eta, int phi) const
+{
+  return (phi + s_pad) * m_stride + eta + s_pad;
+}
+
+inline int TrigT1CaloJetWindowEngine::sum(int eta, int phi,
+                                          int etaSize, int phiSize) const
+{
+  return tableSum(m_table, eta, phi, etaSize, phiSize);
+}
+
+inline bool TrigT1CaloJetWindowEngine::marked(int eta, int phi) const
+{
+  return m_marked[cell(eta, phi)] != 0;
+}
+
+inline bool TrigT1CaloJetWindowEngine::needed(int eta, int phi) const
+{
+  return tableSum(m_markedTable, eta - 2, phi - 2, 5, 5) > 0;
+}
+
+inline int TrigT1CaloJetWindowEngine::candidates() const
+{
+  return m_candidates;
+}
+
+#endif
@@ -0,0 +1,97 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloLazyHists.h
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+#ifndef TRIGT1CALOLAZYHISTS_H
+#define TRIGT1CALOLAZYHISTS_H
+
+#include <utility>
+#include <vector>
+
+#include "AthenaMonitoring/ManagedMonitorToolBase.h"
+
+class LWHist;
+
+/** Deferred registration of histograms which are usually empty.
+ *
+ *  Error detail, mismatch and event number histograms are booked at
+ *  every run but in a good run most of them are never filled.  When
+ *  enabled, defer() takes such a histogram out of its MonGroup straight
+ *  after booking.  Being an LWHist it allocates no bin storage until its
+ *  first fill, so it costs little more than its booking.  At end of run
+ *  registerFilled() registers again those which have been filled and
+ *  keeps the rest unregistered, so that empty histograms are omitted
+ *  from the output file.
+ *
+ *  The owning tool still holds pointers to the omitted histograms, and
+ *  may fill them after end of run, so they are not deleted until the
+ *  next setup(), made when the next run is booked, or until the object
+ *  is destroyed.
+ *
+ *  Intended for offline running only; online the histograms are wanted
+ *  from the start of the run.  When disabled defer() does nothing and
+ *  all histograms are written as usual.
+ */
+
+class TrigT1CaloLazyHists
+{
+
+ public:
+
+  TrigT1CaloLazyHists();
+  ~TrigT1CaloLazyHists();
+
+  /// Enable or disable deferred registration, deleting previous omitted ones
+  void setup(bool enabled);
+  /// Return true if deferred registration is enabled
+  bool enabled() const;
+
+  /// Deregister histogram from group until it is known to be filled
+  StatusCode defer(LWHist* hist, const ManagedMonitorToolBase::MonGroup& group);
+  /// Deregister each histogram of vector from group
+  template <class T>
+  StatusCode defer(const std::vector<T*>& hists,
+                   const ManagedMonitorToolBase::MonGroup& group);
+
+  /// Register filled deferred histograms, keeping empty ones for deletion
+  StatusCode registerFilled(int& registered, int& dropped);
+
+ private:
+
+  /// Not copyable, owns the omitted histograms
+  TrigT1CaloLazyHists(const TrigT1CaloLazyHists&);
+  TrigT1CaloLazyHists& operator=(const TrigT1CaloLazyHists&);
+
+  /// Delete omitted histograms
+  void deleteDropped();
+
+  /// Enabled flag
+  bool m_enabled;
+  /// Deferred histograms and their groups
+  std::vector<std::pair<LWHist*, ManagedMonitorToolBase::MonGroup> > m_hists;
+  /// Omitted histograms, possibly still referenced by the owning tool
+  std::vector<LWHist*> m_dropped;
+
+};
+
+inline bool TrigT1CaloLazyHists::enabled() const
+{
+  return m_enabled;
+}
+
+template <class T>
+StatusCode TrigT1CaloLazyHists::defer(const std::vector<T*>& hists,
+                               const ManagedMonitorToolBase::MonGroup& group)
+{
+  StatusCode sc = StatusCode::SUCCESS;
+  typename std::vector<T*>::const_iterator it  = hists.begin();
+  typename std::vector<T*>::const_iterator itE = hists.end();
+  for (; it != itE; ++it) {
+    if (defer(*it, group).isFailure()) sc = StatusCode::FAILURE;
+  }
+  return sc;
+}
+
+#endif
@@ -0,0 +1,61 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloMapCompare.h
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+#ifndef TRIGT1CALOMAPCOMPARE_H
+#define TRIGT1CALOMAPCOMPARE_H
+
+/** Quick test for complete agreement of simulation and data.
+ *
+ *  The simulation monitoring compare() methods merge a map of simulated
+ *  objects with a map of data objects, keyed alike, and classify every
+ *  pair.  Nearly always the two agree entirely, and agree() detects this
+ *  with a single pass comparing keys and payloads, so that the caller can
+ *  fill the match histograms directly and run the full classification
+ *  only when something differs.
+ *
+ *  The Policy supplies <tt>bool empty(const T*)</tt>, true for objects
+ *  the detailed comparison would skip (no energy or hits), and
+ *  <tt>bool equal(const T*, const T*)</tt>, true if the detailed
+ *  comparison would count the pair as a match.  Empty objects are
+ *  ignored on both sides, so a map holding zero entries still agrees
+ *  with one that omits them.  The test is exact; unlike a digest it
+ *  cannot hide a mismatch.
+ */
+
+class TrigT1CaloMapCompare
+{
+
+ public:
+
+  /// Return true if non-empty entries have the same keys and equal payloads
+  template <class Map, class Policy>
+  static bool agree(const Map& simMap, const Map& datMap,
+                    const Policy& policy);
+
+};
+
+template <class Map, class Policy>
+bool TrigT1CaloMapCompare::agree(const Map& simMap, const Map& datMap,
+                                 const Policy& policy)
+{
+  typename Map::const_iterator simIter  = simMap.begin();
+  typename Map::const_iterator simIterE = simMap.end();
+  typename Map::const_iterator datIter  = datMap.begin();
+  typename Map::const_iterator datIterE = datMap.end();
+  while (true) {
+    while (simIter != simIterE && policy.empty(simIter->second)) ++simIter;
+    while (datIter != datIterE && policy.empty(datIter->second)) ++datIter;
+    if (simIter == simIterE || datIter == datIterE) {
+      return simIter == simIterE && datIter == datIterE;
+    }
+    if (simIter->first != datIter->first ||
+        !policy.equal(simIter->second, datIter->second)) return false;
+    ++simIter;
+    ++datIter;
+  }
+}
+
+#endif
@@ -0,0 +1,85 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloObjectPool.h
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+#ifndef TRIGT1CALOOBJECTPOOL_H
+#define TRIGT1CALOOBJECTPOOL_H
+
+#include <vector>
+
+/** Per-tool store of reusable objects for simulated collections.
+ *
+ *  get() hands out objects in turn, allocating a new one only when all
+ *  those allocated so far are in use, and release() makes them all
+ *  available again.  Objects are owned by the pool, so any collection
+ *  holding them must be a view (SG::VIEW_ELEMENTS) and must be cleared
+ *  before release().  Objects are returned in whatever state they were
+ *  last left, so the caller assigns a complete new value.
+ *
+ *  T must be default constructible and assignable.
+ */
+
+template <class T>
+class TrigT1CaloObjectPool
+{
+
+ public:
+
+  TrigT1CaloObjectPool();
+  ~TrigT1CaloObjectPool();
+
+  /// Return an unused object
+  T* get();
+  /// Make all objects available again
+  void release();
+  /// Return the number of objects allocated
+  int allocated() const;
+
+ private:
+
+  /// All objects allocated
+  std::vector<T*> m_objects;
+  /// Number of objects in use
+  unsigned int m_used;
+
+  /// Not copyable
+  TrigT1CaloObjectPool(const TrigT1CaloObjectPool&);
+  TrigT1CaloObjectPool& operator=(const TrigT1CaloObjectPool&);
+
+};
+
+template <class T>
+TrigT1CaloObjectPool<T>::TrigT1CaloObjectPool() : m_used(0)
+{
+}
+
+template <class T>
+TrigT1CaloObjectPool<T>::~TrigT1CaloObjectPool()
+{
+  typename std::vector<T*>::iterator it  = m_objects.begin();
+  typename std::vector<T*>::iterator itE = m_objects.end();
+  for (; it != itE; ++it) delete *it;
+}
+
+template <class T>
+inline T* TrigT1CaloObjectPool<T>::get()
+{
+  if (m_used == m_objects.size()) m_objects.push_back(new T);
+  return m_objects[m_used++];
+}
+
+template <class T>
+inline void TrigT1CaloObjectPool<T>::release()
+{
+  m_used = 0;
+}
+
+template <class T>
+inline int TrigT1CaloObjectPool<T>::allocated() const
+{
+  return m_objects.size();
+}
+
+#endif
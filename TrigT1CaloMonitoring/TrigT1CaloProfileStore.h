@@ -0,0 +1,74 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloProfileStore.h
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+#ifndef TRIGT1CALOPROFILESTORE_H
+#define TRIGT1CALOPROFILESTORE_H
+
+#include <vector>
+
+class TProfile_LW;
+
+/** Deferred accumulation of unit weight profile fills.
+ *
+ *  Holds for each cell the count, sum and sum of squares of the filled
+ *  values so that a profile fill costs three array adds.  The sums are
+ *  copied to the profile bins only by flush(), typically at the end of
+ *  each lumiblock and at online update intervals.
+ *
+ *  The store keeps the sums since setup(), which should be called when
+ *  the profiles are booked, and flush() sets each changed bin from them.
+ *  Bin contents are thus never recovered from the rounded bin errors.
+ *  Cell @c i of the range flushed is bin @c i+1.
+ *
+ *  Profiles are assumed to have the default error option and to be
+ *  filled only from the store.
+ */
+
+class TrigT1CaloProfileStore
+{
+
+ public:
+
+  TrigT1CaloProfileStore();
+
+  /// Size the store for cells and clear it
+  void setup(int cells);
+
+  /// Add value to cell
+  void fill(int cell, double value);
+  /// Return the number of values in cell since setup
+  double entries(int cell) const;
+
+  /// Set bins of 1D profile from cells first to first+nbins-1
+  void flush(TProfile_LW* hist, int first, int nbins);
+
+ private:
+
+  /// Count by cell
+  std::vector<double> m_n;
+  /// Sum by cell
+  std::vector<double> m_sum;
+  /// Sum of squares by cell
+  std::vector<double> m_sum2;
+  /// Count since last flush by cell
+  std::vector<double> m_pending;
+
+};
+
+inline void TrigT1CaloProfileStore::fill(int cell, double value)
+{
+  m_n[cell]    += 1.;
+  m_sum[cell]  += value;
+  m_sum2[cell] += value*value;
+  m_pending[cell] += 1.;
+}
+
+inline double TrigT1CaloProfileStore::entries(int cell) const
+{
+  return m_n[cell];
+}
+
+#endif
@@ -26,10 +26,7 @@ class TH2I_LW;
 class StatusCode;
 class TrigT1CaloMonErrorTool;
 class TrigT1CaloLWHistogramTool;
-
-namespace LVL1 {
-  class RODHeader;
-}
+class TrigT1CaloErrorBoardTool;
 
 /** Monitoring of ROD errors.
  *
@@ -106,10 +103,10 @@ namespace LVL1 {
  *           @c <LVL1::RODHeader>      </td><td> RoIB CP ROD data                         </td></tr>
  *  <tr><td> @c DataVector
  *           @c <LVL1::RODHeader>      </td><td> RoIB JEP ROD data                        </td></tr>
+ *  <tr><td> @c TrigT1CaloRodSummary   <br>
+ *           @c "RODHeadersSummary"    </td><td> Decoded ROD headers, shared with
+ *                                               CPMSimBSMon and JEPSimBSMon          </td></tr>
  *  <tr><td> @c EventInfo              </td><td> For Full event status error bits         </td></tr>
- *  <tr><td> @c std::vector<int>       <br>
- *           @c "L1CaloRODErrorVector" </td><td> Output.
- *                                               Error summary bits for global histograms </td></tr>
  *  </table>
  *
  *  <b>Tools Used:</b>
@@ -118,6 +115,7 @@ namespace LVL1 {
  *  <tr><th> Tool                         </th><th> Description          </th></tr>
  *  <tr><td> @c TrigT1CaloMonErrorTool    </td><td> @copydoc m_errorTool </td></tr>
  *  <tr><td> @c TrigT1CaloLWHistogramTool </td><td> @copydoc m_histTool  </td></tr>
+ *  <tr><td> @c TrigT1CaloErrorBoardTool  </td><td> @copydoc m_errorBoard </td></tr>
  *  </table>
  *
  *  <b>JobOption Properties:</b>
@@ -167,10 +165,11 @@ private:
 		    NumberOfStatusBins, NoPayload = LimitedRoI,
 		    ROBStatusError = NumberOfStatusBins, UnpackingError };
 
-  typedef DataVector<LVL1::RODHeader> RodHeaderCollection;
   typedef std::vector<unsigned int>   ROBErrorCollection;
   typedef std::vector<int>            ErrorVector;
   
+  /// Return status bin for TrigT1CaloRodSummary status bit
+  static int statusBin(int bit);
   /// Label ROD error status bins
   void setLabelsStatus(LWHist* hist, bool xAxis = true);
   /// Label ROB status Generic bins
@@ -186,13 +185,11 @@ private:
   ToolHandle<TrigT1CaloMonErrorTool>    m_errorTool;
   /// Histogram helper tool
   ToolHandle<TrigT1CaloLWHistogramTool> m_histTool;
+  /// Shared error summary board for global histograms
+  ToolHandle<TrigT1CaloErrorBoardTool>  m_errorBoard;
 
   /// DAQ ROD header container StoreGate key
   std::string m_rodHeaderLocation;
-  /// CP RoIB ROD header container StoreGate key
-  std::string m_cpRoibRodHeaderLocation;
-  /// JEP RoIB ROD header container StoreGate key
-  std::string m_jepRoibRodHeaderLocation;
   
   /// Root directory
   std::string m_rootDir;
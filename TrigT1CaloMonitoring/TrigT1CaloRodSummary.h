@@ -0,0 +1,127 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloRodSummary.h
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+#ifndef TRIGT1CALORODSUMMARY_H
+#define TRIGT1CALORODSUMMARY_H
+
+#include <string>
+#include <vector>
+
+#include "DataModel/DataVector.h"
+#include "SGTools/CLASS_DEF.h"
+
+class StoreGateSvc;
+
+namespace LVL1 {
+  class RODHeader;
+}
+
+/** Decoded ROD headers for one event, shared by the monitoring tools.
+ *
+ *  The DAQ ROD headers and the CP and JEP RoIB ROD headers are decoded
+ *  once per event by the first tool to call get(), which records the
+ *  summary in StoreGate under the DAQ ROD header key with "Summary"
+ *  appended.  Later calls in the same event retrieve it.
+ *
+ *  Each ROD slink has a position <tt>(crate + dataType*6)*4 + slink</tt>,
+ *  the numbering used by TrigT1CaloRodMonTool, giving 80 positions.
+ *  Headers with impossible crate, slink or payload size are skipped.
+ *  Headers at the same position, as the DAQ RoI RODs and their RoIB
+ *  copies are, are merged: payload sizes are summed and status bits
+ *  counted per header, so each header still counts once in the status
+ *  plots.
+ *
+ *  The status bits are interpreted here, including the known quirks of
+ *  the RODHeader accessors, so all tools see the same meaning.
+ */
+
+class TrigT1CaloRodSummary
+{
+
+ public:
+
+  /// Status bits
+  enum StatusBits { GLinkError, LVDSLinkError, FIFOOverflow,
+                    DataTransportError, GLinkTimeout, BCNMismatch,
+                    TriggerTypeTimeout, LimitedRoISet, NumberOfStatusBits };
+
+  /// Number of slink positions
+  static const int s_positions = 80;
+  /// Number of crates
+  static const int s_crates = 14;
+
+  /// Summary of one ROD slink
+  struct Rod {
+    Rod();
+    /// Fragment present
+    bool present;
+    /// Number of headers merged
+    int headers;
+    /// Crate number
+    int crate;
+    /// Data type, 0 for DAQ and 1 for RoI
+    int dataType;
+    /// Total payload size
+    int payloadSize;
+    /// Firmware major version
+    int majorVersion;
+    /// Firmware minor version
+    int minorVersion;
+    /// Number of headers with each of StatusBits set
+    int statusCounts[NumberOfStatusBits];
+  };
+
+  typedef DataVector<LVL1::RODHeader> RodHeaderCollection;
+
+  TrigT1CaloRodSummary();
+
+  /// Return summary for the current event, decoding the headers if needed
+  static const TrigT1CaloRodSummary* get(StoreGateSvc& store,
+                                   const std::string& rodHeaderLocation);
+
+  /// Add headers from one collection, daq true for the DAQ ROD headers
+  void add(const RodHeaderCollection* rods, bool daq);
+
+  /// Return slink summary for position
+  const Rod& rod(int pos) const;
+  /// Return true if LimitedRoISet is set in a DAQ RoI ROD header for crate
+  bool limitedRoI(int crate) const;
+  /// Return minor version from DAQ RoI ROD header for crate, -1 if none
+  int roiMinorVersion(int crate) const;
+
+  /// Return position for crate, slink and data type, -1 if invalid
+  static int position(int crate, int slink, int dataType);
+
+ private:
+
+  /// Slink summaries by position
+  std::vector<Rod> m_rods;
+  /// DAQ RoI ROD LimitedRoISet bits by crate
+  unsigned int m_limitedRoi;
+  /// DAQ RoI ROD minor versions by crate
+  std::vector<int> m_roiMinorVersion;
+
+};
+
+inline const TrigT1CaloRodSummary::Rod&
+                                TrigT1CaloRodSummary::rod(int pos) const
+{
+  return m_rods[pos];
+}
+
+inline bool TrigT1CaloRodSummary::limitedRoI(int crate) const
+{
+  return (crate >= 0 && crate < s_crates && ((m_limitedRoi>>crate)&0x1));
+}
+
+inline int TrigT1CaloRodSummary::roiMinorVersion(int crate) const
+{
+  return (crate >= 0 && crate < s_crates) ? m_roiMinorVersion[crate] : -1;
+}
+
+CLASS_DEF(TrigT1CaloRodSummary, 37268461, 1)
+
+#endif
@@ -0,0 +1,92 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloTaskPool.h
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+#ifndef TRIGT1CALOTASKPOOL_H
+#define TRIGT1CALOTASKPOOL_H
+
+#include <vector>
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+/** Small pool of worker threads for independent tasks within one event.
+ *
+ *  run() hands a list of tasks to the workers, takes part in executing
+ *  them itself, and returns only when all are done.  Tasks must not
+ *  share output, so the caller can merge their results afterwards in
+ *  list order and the outcome does not depend on scheduling.
+ *
+ *  If the pool has not been started, or its threads could not be
+ *  created, run() executes the tasks serially in the calling thread.
+ */
+
+class TrigT1CaloTaskPool
+{
+
+ public:
+
+  /// Interface for one task
+  class Task {
+   public:
+    virtual ~Task() {}
+    /// Do the work of the task
+    virtual void execute() = 0;
+  };
+
+  TrigT1CaloTaskPool();
+  ~TrigT1CaloTaskPool();
+
+  /// Start threads so that nthreads including the caller share the work
+  bool start(int nthreads);
+  /// Stop and join all worker threads
+  void stop();
+  /// Return the number of worker threads
+  int workers() const;
+
+  /// Execute all tasks and wait for them, return false if any threw
+  bool run(const std::vector<Task*>& tasks);
+
+ private:
+
+  /// Worker thread main loop
+  void work();
+  /// Execute tasks until none left, lock held on entry and exit
+  void drain(boost::unique_lock<boost::mutex>& lock);
+
+  /// Worker threads
+  std::vector<boost::thread*> m_threads;
+  /// Guards all members below
+  boost::mutex m_mutex;
+  /// Signals new tasks or stop to workers
+  boost::condition_variable m_wake;
+  /// Signals completion of all tasks to run()
+  boost::condition_variable m_done;
+  /// Current task list
+  const std::vector<Task*>* m_tasks;
+  /// Next task to be taken
+  unsigned int m_next;
+  /// Number of tasks finished
+  unsigned int m_finished;
+  /// Incremented for each new task list
+  unsigned long m_generation;
+  /// Set if a task threw an exception
+  bool m_failed;
+  /// Stop flag for workers
+  bool m_stop;
+
+  /// Not copyable
+  TrigT1CaloTaskPool(const TrigT1CaloTaskPool&);
+  TrigT1CaloTaskPool& operator=(const TrigT1CaloTaskPool&);
+
+};
+
+inline int TrigT1CaloTaskPool::workers() const
+{
+  return m_threads.size();
+}
+
+#endif
@@ -0,0 +1,168 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloTimeSeriesFile.h
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+#ifndef TRIGT1CALOTIMESERIESFILE_H
+#define TRIGT1CALOTIMESERIESFILE_H
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+class TrigT1CaloChannelStats;
+
+/** Columnar binary file of per-channel quantities by lumiblock.
+ *
+ *  write() saves one or more TrigT1CaloChannelStats stores, sharing the
+ *  same channels, at the end of a run; read() loads a whole file into
+ *  memory for stability analysis without touching the ROOT file.
+ *
+ *  Only lumiblocks with data in some store are written.  The layout,
+ *  in native byte order, is:
+ *
+ *  <table>
+ *  <tr><th> Field                 </th><th> Type and size                    </th></tr>
+ *  <tr><td> Magic @c "L1TS"       </td><td> 4 chars                          </td></tr>
+ *  <tr><td> Version, run          </td><td> 2 x uint32                       </td></tr>
+ *  <tr><td> Channels, lumiblocks,
+ *           quantities            </td><td> 3 x uint32                       </td></tr>
+ *  <tr><td> Quantity names        </td><td> uint32 length + chars, each      </td></tr>
+ *  <tr><td> Channel identifiers   </td><td> uint32 x channels                </td></tr>
+ *  <tr><td> Lumiblock numbers     </td><td> uint32 x lumiblocks              </td></tr>
+ *  <tr><td> Per quantity: entries,
+ *           mean, RMS columns     </td><td> uint32, float, float
+ *                                           x channels x lumiblocks         </td></tr>
+ *  </table>
+ *
+ *  Columns are ordered channel by channel, so the lumiblock series of one
+ *  channel is contiguous.  Entries are zero where a channel had no data.
+ */
+
+class TrigT1CaloTimeSeriesFile
+{
+
+ public:
+
+  TrigT1CaloTimeSeriesFile();
+
+  /// Write stores with names and channel identifiers, false on failure
+  static bool write(const std::string& fileName, unsigned int run,
+                    const std::vector<std::string>& names,
+                    const std::vector<const TrigT1CaloChannelStats*>& stats,
+                    const std::vector<unsigned int>& channelIds);
+
+  /// Read whole file, false on failure or if shorter than its header says
+  bool read(const std::string& fileName);
+
+  /// Return run number
+  unsigned int run() const;
+  /// Return number of channels
+  int channels() const;
+  /// Return number of lumiblocks
+  int lumiBlocks() const;
+  /// Return number of quantities
+  int quantities() const;
+  /// Return name of quantity
+  const std::string& name(int quantity) const;
+  /// Return index of named quantity, -1 if absent
+  int quantity(const std::string& name) const;
+  /// Return identifier of channel
+  unsigned int channelId(int channel) const;
+  /// Return lumiblock number at position
+  unsigned int lumiBlock(int position) const;
+
+  /// Return entries column of quantity, channels x lumiblocks (0 if none)
+  const unsigned int* entries(int quantity) const;
+  /// Return mean column of quantity, channels x lumiblocks
+  const float* mean(int quantity) const;
+  /// Return RMS column of quantity, channels x lumiblocks
+  const float* rms(int quantity) const;
+
+ private:
+
+  /// Read file contents after opening, false on failure
+  bool load(std::ifstream& in);
+  /// Read entries, mean and RMS columns of all quantities
+  bool readColumns(std::ifstream& in, unsigned int nQuantities,
+                   std::size_t nCells);
+  /// Clear contents
+  void clear();
+
+  /// File format version
+  static const unsigned int s_version = 1;
+
+  /// Run number
+  unsigned int m_run;
+  /// Quantity names
+  std::vector<std::string> m_names;
+  /// Channel identifiers
+  std::vector<unsigned int> m_channelIds;
+  /// Lumiblock numbers
+  std::vector<unsigned int> m_lumiBlocks;
+  /// Entries columns, concatenated by quantity
+  std::vector<unsigned int> m_entries;
+  /// Mean columns, concatenated by quantity
+  std::vector<float> m_mean;
+  /// RMS columns, concatenated by quantity
+  std::vector<float> m_rms;
+
+};
+
+inline unsigned int TrigT1CaloTimeSeriesFile::run() const
+{
+  return m_run;
+}
+
+inline int TrigT1CaloTimeSeriesFile::channels() const
+{
+  return m_channelIds.size();
+}
+
+inline int TrigT1CaloTimeSeriesFile::lumiBlocks() const
+{
+  return m_lumiBlocks.size();
+}
+
+inline int TrigT1CaloTimeSeriesFile::quantities() const
+{
+  return m_names.size();
+}
+
+inline const std::string& TrigT1CaloTimeSeriesFile::name(int quantity) const
+{
+  return m_names[quantity];
+}
+
+inline unsigned int TrigT1CaloTimeSeriesFile::channelId(int channel) const
+{
+  return m_channelIds[channel];
+}
+
+inline unsigned int TrigT1CaloTimeSeriesFile::lumiBlock(int position) const
+{
+  return m_lumiBlocks[position];
+}
+
+inline const unsigned int*
+                    TrigT1CaloTimeSeriesFile::entries(int quantity) const
+{
+  return (m_entries.empty()) ? 0
+                         : &m_entries[quantity * channels() * lumiBlocks()];
+}
+
+inline const float* TrigT1CaloTimeSeriesFile::mean(int quantity) const
+{
+  return (m_mean.empty()) ? 0
+                         : &m_mean[quantity * channels() * lumiBlocks()];
+}
+
+inline const float* TrigT1CaloTimeSeriesFile::rms(int quantity) const
+{
+  return (m_rms.empty()) ? 0
+                         : &m_rms[quantity * channels() * lumiBlocks()];
+}
+
+#endif
@@ -0,0 +1,171 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloTowerTableTool.h
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+#ifndef TRIGT1CALOTOWERTABLETOOL_H
+#define TRIGT1CALOTOWERTABLETOOL_H
+
+#include <string>
+#include <vector>
+
+#include "AthenaBaseComps/AthAlgTool.h"
+#include "GaudiKernel/ToolHandle.h"
+#include "Identifier/Identifier.h"
+#include "TrigT1CaloCalibConditions/L1CaloCoolChannelId.h"
+
+class StatusCode;
+
+namespace LVL1 {
+  class IL1TriggerTowerTool;
+}
+
+static const InterfaceID IID_TrigT1CaloTowerTableTool(
+                                       "TrigT1CaloTowerTableTool", 1, 1);
+
+/** Run-scoped lookup table of PPM trigger tower geometry.
+ *
+ *  Holds for each of the 3584 PPM eta-phi positions, and for both layers,
+ *  the COOL channel ID and offline Identifier, the hardware crate, module,
+ *  submodule and channel, and the calorimeter partition.  The table is
+ *  filled from IL1TriggerTowerTool once per run so that the PPM monitoring
+ *  tools need not repeat the mapping for every tower in every event.
+ *
+ *  Client tools should call update() from @c bookHistogramsRecurrent
+ *  when @c newRun is set.  The table is only rebuilt if the run number
+ *  has changed since the last call, so it is shared between tools.
+ *
+ *  Towers are numbered C-side then A-side, within a side by increasing
+ *  |eta| bin then by phi bin:
+ *
+ *  <table>
+ *  <tr><th> Region          </th><th> Eta bins </th><th> Phi bins </th></tr>
+ *  <tr><td> |eta| < 2.5     </td><td>    25    </td><td>    64    </td></tr>
+ *  <tr><td> 2.5 < |eta| < 3.2 </td><td>   4    </td><td>    32    </td></tr>
+ *  <tr><td> |eta| > 3.2     </td><td>     4    </td><td>    16    </td></tr>
+ *  </table>
+ *
+ *  <b>Tools Used:</b>
+ *
+ *  <table>
+ *  <tr><th> Tool                         </th><th> Description       </th></tr>
+ *  <tr><td> @c LVL1::IL1TriggerTowerTool </td><td> @copydoc m_ttTool </td></tr>
+ *  </table>
+ *
+ *  <b>JobOption Properties:</b>
+ *
+ *  <table>
+ *  <tr><th> Property             </th><th> Description       </th></tr>
+ *  <tr><td> @c TriggerTowerTool  </td><td> @copydoc m_ttTool </td></tr>
+ *  </table>
+ *
+ */
+
+class TrigT1CaloTowerTableTool: public AthAlgTool
+{
+
+ public:
+
+  /// Subdetector partitions
+  enum CaloPartitions { LArFCAL1C, LArEMECC, LArOverlapC, LArEMBC, LArEMBA,
+      LArOverlapA, LArEMECA, LArFCAL1A, LArFCAL23C, LArHECC,
+      TileEBC, TileLBC, TileLBA, TileEBA, LArHECA, LArFCAL23A,
+      MaxPartitions };
+
+  /// Mapping information for one layer of a tower
+  struct Channel {
+    L1CaloCoolChannelId coolId;     ///< COOL channel ID
+    Identifier          identifier; ///< Offline TT Identifier
+    int crate;                      ///< PPM crate 0-7
+    int module;                     ///< PPM module 0-15
+    int subModule;                  ///< MCM 0-15
+    int channel;                    ///< MCM channel 0-3
+    int partition;                  ///< Subdetector partition
+  };
+
+  /// Table entry for one eta-phi position
+  struct Tower {
+    double  eta;                    ///< Tower centre eta
+    double  phi;                    ///< Tower centre phi
+    Channel layer[2];               ///< EM and HAD layers
+  };
+
+  TrigT1CaloTowerTableTool(const std::string& type, const std::string& name,
+                           const IInterface* parent);
+  virtual ~TrigT1CaloTowerTableTool();
+
+  /// AlgTool InterfaceID
+  static const InterfaceID& interfaceID();
+
+  virtual StatusCode initialize();
+  virtual StatusCode finalize();
+
+  /// Build the table if not yet built or the run number has changed
+  StatusCode update();
+
+  /// Return table index for tower eta, phi
+  int index(double eta, double phi) const;
+  /// Return table entry for index
+  const Tower& tower(int index) const;
+  /// Return table entry for tower eta, phi
+  const Tower& tower(double eta, double phi) const;
+  /// Return the number of table entries
+  static int numberOfTowers();
+
+  /// Return subdetector partition
+  static int partition(int layer, double eta);
+  /// Return subdetector partition name
+  static std::string partitionName(int part);
+
+  /// Return the number of times the table has been built
+  int builds() const;
+
+ private:
+
+  /// Number of towers per side
+  static const int s_towersPerSide = 1792;
+
+  /// Return centre eta of |eta| bin
+  double etaCentre(int absEtaBin) const;
+
+  /// Tool for identifiers and hardware mapping
+  ToolHandle<LVL1::IL1TriggerTowerTool> m_ttTool;
+
+  /// Table of towers
+  std::vector<Tower> m_towers;
+  /// Run number for which table was built
+  unsigned int m_runNumber;
+  /// Number of table builds
+  int m_builds;
+
+};
+
+inline const InterfaceID& TrigT1CaloTowerTableTool::interfaceID()
+{
+  return IID_TrigT1CaloTowerTableTool;
+}
+
+inline const TrigT1CaloTowerTableTool::Tower&
+                           TrigT1CaloTowerTableTool::tower(int index) const
+{
+  return m_towers[index];
+}
+
+inline const TrigT1CaloTowerTableTool::Tower&
+               TrigT1CaloTowerTableTool::tower(double eta, double phi) const
+{
+  return m_towers[index(eta, phi)];
+}
+
+inline int TrigT1CaloTowerTableTool::numberOfTowers()
+{
+  return 2*s_towersPerSide;
+}
+
+inline int TrigT1CaloTowerTableTool::builds() const
+{
+  return m_builds;
+}
+
+#endif
@@ -86,7 +86,12 @@ not supported by Light Weight Histograms.
 
 @section RODsection ROD Monitoring Tool
                                                                <hr><p>
-  TrigT1CaloRodMonTool    <p> @copydoc TrigT1CaloRodMonTool
+  TrigT1CaloRodMonTool    <p> @copydoc TrigT1CaloRodMonTool    <hr>
+
+@section Helpersection Helper Tools
+                                                               <hr><p>
+  TrigT1CaloTowerTableTool <p> @copydoc TrigT1CaloTowerTableTool <hr>
+  TrigT1CaloErrorBoardTool <p> @copydoc TrigT1CaloErrorBoardTool
 
 */
 
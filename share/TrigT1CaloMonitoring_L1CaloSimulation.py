@@ -123,3 +123,12 @@ job.CPCMMMaker.CMMCPHitsLocation = "Sim_CMMCPHits"
 job.CPCMMMaker.CPBSCollectionLocation = "Sim_CPBS"
 #job.CPCMMMaker.OutputLevel = DEBUG
 
+
+# The simulation monitoring tools can use these containers instead of
+# repeating the same simulation steps.  For the first UpstreamCheckEvents
+# events (default 100) they are also simulated locally and compared, and
+# reuse is switched off on any difference (eg. a different JetTrigger
+# threshold configuration), so histograms are unchanged, eg.
+#ToolSvc.JEPSimBSMonTool.SimJEMRoILocation = "Sim_JEMRoIs"
+#ToolSvc.JEPSimBSMonTool.SimJEMEtSumsLocation = "Sim_JEMEtSums"
+#ToolSvc.CPMSimBSMonTool.SimCPMRoILocation = "Sim_CPMRoIs"
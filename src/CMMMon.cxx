@@ -20,11 +20,11 @@
 
 #include "GaudiKernel/MsgStream.h"
 #include "GaudiKernel/StatusCode.h"
-#include "SGTools/StlVectorClids.h"
 
 #include "AthenaMonitoring/AthenaMonManager.h"
 
 #include "TrigT1CaloMonitoring/CMMMon.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloErrorBoardTool.h"
 #include "TrigT1CaloMonitoringTools/TrigT1CaloMonErrorTool.h"
 #include "TrigT1CaloMonitoringTools/TrigT1CaloLWHistogramTool.h"
 
@@ -48,6 +48,7 @@ CMMMon::CMMMon( const std::string & type, const std::string & name,
   : ManagedMonitorToolBase( type, name, parent ),
     m_errorTool("TrigT1CaloMonErrorTool"),
     m_histTool("TrigT1CaloLWHistogramTool"),
+    m_errorBoard("TrigT1CaloErrorBoardTool"),
     m_histBooked(false),
     m_h_cmm_1d_thresh_TotalMainHits(0),
     m_h_cmm_1d_thresh_TotalFwdHitsRight(0),
@@ -134,6 +135,13 @@ StatusCode CMMMon::initialize()
     return sc;
   }
 
+  sc = m_errorBoard.retrieve();
+  if( sc.isFailure() ) {
+    msg(MSG::ERROR) << "Unable to locate Tool TrigT1CaloErrorBoardTool"
+                    << endreq;
+    return sc;
+  }
+
   return StatusCode::SUCCESS;
 }
 
@@ -715,14 +723,8 @@ StatusCode CMMMon::fillHistograms()
            
   }
 
-  // Write overview vector to StoreGate
-  std::vector<int>* save = new std::vector<int>(overview);
-  sc = evtStore()->record(save, "L1CaloJEMCMMErrorVector");
-  if (sc != StatusCode::SUCCESS) {
-    msg(MSG::ERROR) << "Error recording JEM CMM error vector in TES "
-                    << endreq;
-    return sc;
-  }
+  // Write overview vector to error board
+  m_errorBoard->set(TrigT1CaloErrorBoardTool::JEMCMMError, overview);
 
   return StatusCode::SUCCESS;
 }
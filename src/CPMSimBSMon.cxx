@@ -8,6 +8,7 @@
 //
 // ********************************************************************
 
+#include <algorithm>
 #include <utility>
 #include <cmath>
 
@@ -18,7 +19,6 @@
 
 #include "GaudiKernel/MsgStream.h"
 #include "GaudiKernel/StatusCode.h"
-#include "SGTools/StlVectorClids.h"
 
 #include "AthenaMonitoring/AthenaMonManager.h"
 
@@ -26,7 +26,6 @@
 #include "TrigT1CaloEvent/CPMHits.h"
 #include "TrigT1CaloEvent/CPMTower.h"
 #include "TrigT1CaloEvent/CPMRoI.h"
-#include "TrigT1CaloEvent/RODHeader.h"
 #include "TrigT1CaloEvent/TriggerTower.h"
 #include "TrigT1CaloUtils/CoordToHardware.h"
 #include "TrigT1CaloUtils/CPAlgorithm.h"
@@ -40,9 +39,55 @@
 #include "TrigT1Interfaces/TrigT1CaloDefs.h"
 
 #include "TrigT1CaloMonitoring/CPMSimBSMon.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloErrorBoardTool.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloMapCompare.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloRodSummary.h"
 #include "TrigT1CaloMonitoringTools/TrigT1CaloMonErrorTool.h"
 #include "TrigT1CaloMonitoringTools/TrigT1CaloLWHistogramTool.h"
 
+/*---------------------------------------------------------*/
+class CPMSimBSMon::CrateRoiTask : public TrigT1CaloTaskPool::Task
+/*---------------------------------------------------------*/
+{
+ public:
+  CrateRoiTask(LVL1::IL1EmTauTools* tool) : m_tool(tool), m_towers(0) {}
+  /// Set towers for next execute
+  void setTowers(CpmTowerMap* towers) { m_towers = towers; }
+  /// Find RoIs into this task's own collection
+  virtual void execute() {
+    m_rois.clear();
+    m_tool->findRoIs(m_towers, &m_rois);
+  }
+  InternalRoiCollection* rois() { return &m_rois; }
+ private:
+  LVL1::IL1EmTauTools*  m_tool;
+  CpmTowerMap*          m_towers;
+  InternalRoiCollection m_rois;
+};
+
+// Match criteria of the compare() methods for TrigT1CaloMapCompare
+
+namespace {
+
+struct CpmRoiPolicy {
+  bool empty(const LVL1::CPMRoI* roi) const { return !roi->hits(); }
+  bool equal(const LVL1::CPMRoI* sim, const LVL1::CPMRoI* dat) const {
+    return sim->hits() == dat->hits();
+  }
+};
+
+struct CpmHitsPolicy {
+  bool empty(const LVL1::CPMHits* hits) const {
+    return !hits->HitWord0() && !hits->HitWord1();
+  }
+  bool equal(const LVL1::CPMHits* sim, const LVL1::CPMHits* dat) const {
+    return sim->HitWord0() == dat->HitWord0() &&
+           sim->HitWord1() == dat->HitWord1();
+  }
+};
+
+}
+
 /*---------------------------------------------------------*/
 CPMSimBSMon::CPMSimBSMon(const std::string & type, 
 			 const std::string & name,
@@ -52,8 +97,12 @@ CPMSimBSMon::CPMSimBSMon(const std::string & type,
     m_cpHitsTool("LVL1::L1CPHitsTools/L1CPHitsTools"),
     m_errorTool("TrigT1CaloMonErrorTool"),
     m_histTool("TrigT1CaloLWHistogramTool"),
-    m_debug(false), m_rodTES(0), m_overlapPresent(false), m_limitedRoi(0),
-    m_histBooked(false),
+    m_errorBoard("TrigT1CaloErrorBoardTool"),
+    m_debug(false), m_upstreamOn(true), m_upstreamUsed(0),
+    m_upstreamChecked(0), m_upstreamDiffer(0), m_rodSummary(0),
+    m_overlapPresent(false),
+    m_histBooked(false), m_roiThreads(0), m_intRois(0), m_cpmRoiSim(0),
+    m_cpmHitsSim(0), m_cmmCpHitsSim(0),
     m_h_cpm_em_2d_etaPhi_tt_PpmEqCore(0),
     m_h_cpm_em_2d_etaPhi_tt_PpmNeCore(0),
     m_h_cpm_em_2d_etaPhi_tt_PpmNoCore(0),
@@ -127,14 +176,29 @@ CPMSimBSMon::CPMSimBSMon(const std::string & type,
 		                 LVL1::TrigT1CaloDefs::TriggerTowerLocation);
   declareProperty("RodHeaderLocation",
                  m_rodHeaderLocation = "RODHeaders");
+  declareProperty("SimCPMRoILocation", m_simCpmRoiLocation = "",
+                  "Upstream CPM RoIs simulated from Trigger Towers");
+  declareProperty("UpstreamCheckEvents", m_upstreamCheckEvents = 100,
+                  "Events with upstream CPM RoIs checked before reuse");
 
   declareProperty("RootDirectory", m_rootDir = "L1Calo");
+  declareProperty("LazyBooking", m_lazyBooking = false,
+                  "Only write mismatch histograms which are filled (offline)");
+  declareProperty("RoIThreads", m_roiThreads = 0,
+                  "Threads for per-crate RoI simulation, 0 or 1 for serial");
 }
 
 /*---------------------------------------------------------*/
 CPMSimBSMon::~CPMSimBSMon()
 /*---------------------------------------------------------*/
 {
+  std::vector<CrateRoiTask*>::iterator it  = m_crateTasks.begin();
+  std::vector<CrateRoiTask*>::iterator itE = m_crateTasks.end();
+  for (; it != itE; ++it) delete *it;
+  delete m_intRois;
+  delete m_cpmRoiSim;
+  delete m_cpmHitsSim;
+  delete m_cmmCpHitsSim;
 }
 
 #ifndef PACKAGE_VERSION
@@ -160,6 +224,12 @@ StatusCode CPMSimBSMon::initialize()
     msg(MSG::ERROR) << "Unable to locate Tool L1EmTauTools" << endreq;
     return sc;
   }
+  if (m_crateTasks.empty()) {
+    const int ncrates = 4;
+    for (int crate = 0; crate < ncrates; ++crate) {
+      m_crateTasks.push_back(new CrateRoiTask(&(*m_emTauTool)));
+    }
+  }
 
   sc = m_cpHitsTool.retrieve();
   if( sc.isFailure() ) {
@@ -181,6 +251,32 @@ StatusCode CPMSimBSMon::initialize()
     return sc;
   }
 
+  sc = m_errorBoard.retrieve();
+  if( sc.isFailure() ) {
+    msg(MSG::ERROR) << "Unable to locate Tool TrigT1CaloErrorBoardTool"
+                    << endreq;
+    return sc;
+  }
+
+  // Scratch collections reused every event
+  if (!m_intRois) {
+    m_intRois      = new InternalRoiCollection;
+    m_cpmRoiSim    = new CpmRoiCollection(SG::VIEW_ELEMENTS);
+    m_cpmHitsSim   = new CpmHitsCollection;
+    m_cmmCpHitsSim = new CmmCpHitsCollection;
+  }
+
+  if (m_roiThreads > 1) {
+    const int nthreads = std::min(m_roiThreads, 4);
+    if (m_roiPool.start(nthreads)) {
+      msg(MSG::INFO) << "Per-crate RoI simulation using " << nthreads
+                     << " threads" << endreq;
+    } else {
+      msg(MSG::WARNING) << "Unable to start RoI simulation threads,"
+                        << " running serially" << endreq;
+    }
+  }
+
   return StatusCode::SUCCESS;
 }
 
@@ -188,6 +284,14 @@ StatusCode CPMSimBSMon::initialize()
 StatusCode CPMSimBSMon::finalize()
 /*---------------------------------------------------------*/
 {
+  m_roiPool.stop();
+  if (!m_simCpmRoiLocation.empty()) {
+    msg(MSG::INFO) << "Upstream simulated CPM RoIs used in "
+                   << m_upstreamUsed << " events" << endreq;
+    msg(MSG::INFO) << "Upstream simulated CPM RoIs checked in "
+                   << m_upstreamChecked << " events, differing from local "
+		   << "simulation in " << m_upstreamDiffer << endreq;
+  }
   return StatusCode::SUCCESS;
 }
 
@@ -435,6 +539,68 @@ StatusCode CPMSimBSMon::bookHistogramsRecurrent()
   m_v_2d_MismatchEvents[5] = hist;
 
   m_histTool->unsetMonGroup();
+
+  // Mismatch plots only written if filled
+
+  m_lazyHists.setup(m_lazyBooking &&
+                    m_environment != AthenaMonManager::online);
+  if (m_lazyHists.enabled()) {
+    std::vector<LWHist*> lazyCPMin;
+    lazyCPMin.push_back(m_h_cpm_em_2d_etaPhi_tt_PpmNeCore);
+    lazyCPMin.push_back(m_h_cpm_em_2d_etaPhi_tt_PpmNoCore);
+    lazyCPMin.push_back(m_h_cpm_em_2d_etaPhi_tt_CoreNoPpm);
+    lazyCPMin.push_back(m_h_cpm_had_2d_etaPhi_tt_PpmNeCore);
+    lazyCPMin.push_back(m_h_cpm_had_2d_etaPhi_tt_PpmNoCore);
+    lazyCPMin.push_back(m_h_cpm_had_2d_etaPhi_tt_CoreNoPpm);
+    lazyCPMin.push_back(m_h_cpm_em_2d_etaPhi_tt_PpmNeOverlap);
+    lazyCPMin.push_back(m_h_cpm_em_2d_etaPhi_tt_PpmNoOverlap);
+    lazyCPMin.push_back(m_h_cpm_em_2d_etaPhi_tt_OverlapNoPpm);
+    lazyCPMin.push_back(m_h_cpm_had_2d_etaPhi_tt_PpmNeOverlap);
+    lazyCPMin.push_back(m_h_cpm_had_2d_etaPhi_tt_PpmNoOverlap);
+    lazyCPMin.push_back(m_h_cpm_had_2d_etaPhi_tt_OverlapNoPpm);
+    lazyCPMin.push_back(m_h_cpm_2d_tt_PpmNeCpmFpga);
+    lazyCPMin.push_back(m_h_cpm_2d_tt_PpmNoCpmFpga);
+    lazyCPMin.push_back(m_h_cpm_2d_tt_CpmNoPpmFpga);
+    std::vector<LWHist*> lazyRoIs;
+    lazyRoIs.push_back(m_h_cpm_2d_roi_SimNeData);
+    lazyRoIs.push_back(m_h_cpm_2d_roi_SimNoData);
+    lazyRoIs.push_back(m_h_cpm_2d_roi_DataNoSim);
+    lazyRoIs.push_back(m_h_cpm_2d_roi_ThreshSimNeData);
+    lazyRoIs.push_back(m_h_cpm_2d_etaPhi_roi_SimNeData);
+    lazyRoIs.push_back(m_h_cpm_2d_etaPhi_roi_SimNoData);
+    lazyRoIs.push_back(m_h_cpm_2d_etaPhi_roi_DataNoSim);
+    std::vector<LWHist*> lazyCPMout;
+    lazyCPMout.push_back(m_h_cpm_2d_thresh_SimNeData);
+    lazyCPMout.push_back(m_h_cpm_2d_thresh_SimNoData);
+    lazyCPMout.push_back(m_h_cpm_2d_thresh_DataNoSim);
+    lazyCPMout.push_back(m_h_cpm_2d_thresh_ThreshSimNeData);
+    std::vector<LWHist*> lazyCMMin;
+    lazyCMMin.push_back(m_h_cmm_2d_thresh_CpmNeCmm);
+    lazyCMMin.push_back(m_h_cmm_2d_thresh_CpmNoCmm);
+    lazyCMMin.push_back(m_h_cmm_2d_thresh_CmmNoCpm);
+    lazyCMMin.push_back(m_h_cmm_2d_thresh_ThreshCpmNeCmm);
+    std::vector<LWHist*> lazyCMMout;
+    lazyCMMout.push_back(m_h_cmm_1d_thresh_SumsSimNeData);
+    lazyCMMout.push_back(m_h_cmm_1d_thresh_SumsSimNoData);
+    lazyCMMout.push_back(m_h_cmm_1d_thresh_SumsDataNoSim);
+    lazyCMMout.push_back(m_h_cmm_2d_thresh_SumsThreshSimNeData);
+    std::vector<LWHist*> lazyEvent1(m_v_2d_MismatchEvents.begin(),
+                                    m_v_2d_MismatchEvents.begin() + 4);
+    std::vector<LWHist*> lazyEvent2(m_v_2d_MismatchEvents.begin() + 4,
+                                    m_v_2d_MismatchEvents.end());
+    StatusCode sc = m_lazyHists.defer(lazyCPMin, monCPMin);
+    if (sc.isSuccess()) sc = m_lazyHists.defer(lazyRoIs, monRoIs);
+    if (sc.isSuccess()) sc = m_lazyHists.defer(lazyCPMout, monCPMout);
+    if (sc.isSuccess()) sc = m_lazyHists.defer(lazyCMMin, monCMMin);
+    if (sc.isSuccess()) sc = m_lazyHists.defer(lazyCMMout, monCMMout);
+    if (sc.isSuccess()) sc = m_lazyHists.defer(lazyEvent1, monEvent1);
+    if (sc.isSuccess()) sc = m_lazyHists.defer(lazyEvent2, monEvent2);
+    if (sc.isFailure()) {
+      msg(MSG::ERROR) << "Failed to deregister mismatch histograms" << endreq;
+      return sc;
+    }
+  }
+
   m_histBooked = true;
 
   } // end if (newRun ...
@@ -496,14 +662,10 @@ StatusCode CPMSimBSMon::fillHistograms()
     msg(MSG::DEBUG) << "No DAQ CPM RoIs container found" << endreq;
   }
 
-  //Retrieve ROD Headers from SG
-  m_limitedRoi = 0;
-  m_rodTES = 0;
-  if (evtStore()->contains<RodHeaderCollection>(m_rodHeaderLocation)) {
-    sc = evtStore()->retrieve( m_rodTES, m_rodHeaderLocation);
-  } else sc = StatusCode::FAILURE;
-  if( sc.isFailure()  ||  !m_rodTES ) {
-    msg(MSG::DEBUG) << "No ROD Header container found" << endreq;
+  //Retrieve decoded ROD Headers, shared with other tools
+  m_rodSummary = TrigT1CaloRodSummary::get(*evtStore(), m_rodHeaderLocation);
+  if ( !m_rodSummary ) {
+    msg(MSG::DEBUG) << "No ROD Header summary available" << endreq;
   }
   
   //Retrieve CPM Hits from SG
@@ -520,17 +682,14 @@ StatusCode CPMSimBSMon::fillHistograms()
     msg(MSG::DEBUG) << "No CMM-CP Hits container found" << endreq; 
   }
 
-  // Maps to simplify comparisons
+  // Tower arrays and maps to simplify comparisons
   
-  TriggerTowerMap ttMap;
-  CpmTowerMap     cpMap;
-  CpmTowerMap     ovMap;
   CpmRoiMap       crMap;
   CpmHitsMap      chMap;
   CmmCpHitsMap    cmMap;
-  setupMap(triggerTowerTES, ttMap);
-  setupMap(cpmTowerTES, cpMap);
-  setupMap(cpmTowerOvTES, ovMap);
+  setupMap(triggerTowerTES, m_ttArray);
+  setupMap(cpmTowerTES, m_cpArray);
+  setupMap(cpmTowerOvTES, m_ovArray);
   setupMap(cpmRoiTES, crMap);
   setupMap(cpmHitsTES, chMap);
   setupMap(cmmCpHitsTES, cmMap);
@@ -549,41 +708,54 @@ StatusCode CPMSimBSMon::fillHistograms()
   bool overlap = false;
   bool mismatchCore = false;
   bool mismatchOverlap = false;
-  mismatchCore = compare(ttMap, cpMap, errorsCPM, overlap);
+  mismatchCore = compare(m_ttArray, m_cpArray, errorsCPM, overlap);
   if (m_overlapPresent) {
     overlap = true;
-    mismatchOverlap = compare(ttMap, ovMap, errorsCPM, overlap);
+    mismatchOverlap = compare(m_ttArray, m_ovArray, errorsCPM, overlap);
   }
 
   // Compare RoIs simulated from CPM Towers with CPM RoIs from data
 
   CpmRoiCollection* cpmRoiSIM = 0;
+  const CpmRoiCollection* cpmRoiUP = 0;
+  bool roisOk = true;
   if (cpmTowerTES || cpmTowerOvTES) {
-    cpmRoiSIM = new CpmRoiCollection;
     if (mismatchCore || mismatchOverlap) {
-      simulate(cpMap, ovMap, cpmRoiSIM);
+      cpmRoiSIM = m_cpmRoiSim;
+      roisOk = simulate(m_cpArray, m_ovArray, cpmRoiSIM);
     } else {
-      simulate(cpMap, cpmRoiSIM);
+      if (triggerTowerTES && m_upstreamOn) cpmRoiUP = upstreamRois();
+      if (!cpmRoiUP || m_debug ||
+          m_upstreamChecked < (unsigned long)m_upstreamCheckEvents) {
+        cpmRoiSIM = m_cpmRoiSim;
+        simulate(m_cpArray, cpmRoiSIM);
+        if (cpmRoiUP) checkUpstream(cpmRoiUP, cpmRoiSIM);
+        cpmRoiUP = 0;
+      }
     }
   }
-  CpmRoiMap crSimMap;
-  setupMap(cpmRoiSIM, crSimMap);
-  compare(crSimMap, crMap, errorsCPM);
-  crSimMap.clear();
-  delete cpmRoiSIM;
+  if (cpmRoiUP) ++m_upstreamUsed;
+  if (roisOk) {
+    CpmRoiMap crSimMap;
+    if (cpmRoiUP) setupMap(cpmRoiUP, crSimMap);
+    else          setupMap(cpmRoiSIM, crSimMap);
+    compare(crSimMap, crMap, errorsCPM);
+  }
+  m_cpmRoiSim->clear();
+  m_roiObjects.release();
 
   // Compare CPM Hits simulated from CPM RoIs with CPM Hits from data
 
   CpmHitsCollection* cpmHitsSIM = 0;
   if (cpmRoiTES) {
-    cpmHitsSIM = new CpmHitsCollection;
+    cpmHitsSIM = m_cpmHitsSim;
     simulate(cpmRoiTES, cpmHitsSIM);
   }
   CpmHitsMap chSimMap;
   setupMap(cpmHitsSIM, chSimMap);
   compare(chSimMap, chMap, errorsCPM);
   chSimMap.clear();
-  delete cpmHitsSIM;
+  m_cpmHitsSim->clear();
 
   // Compare CPM hits with CMM Hits from data
 
@@ -593,14 +765,14 @@ StatusCode CPMSimBSMon::fillHistograms()
 
   CmmCpHitsCollection* cmmLocalSIM = 0;
   if (cmmCpHitsTES) {
-    cmmLocalSIM = new CmmCpHitsCollection;
+    cmmLocalSIM = m_cmmCpHitsSim;
     simulate(cmmCpHitsTES, cmmLocalSIM, LVL1::CMMCPHits::LOCAL);
   }
   CmmCpHitsMap cmmLocalSimMap;
   setupMap(cmmLocalSIM, cmmLocalSimMap);
   compare(cmmLocalSimMap, cmMap, errorsCMM, LVL1::CMMCPHits::LOCAL);
   cmmLocalSimMap.clear();
-  delete cmmLocalSIM;
+  m_cmmCpHitsSim->clear();
 
   // Compare Local sums with Remote sums from data
 
@@ -610,14 +782,14 @@ StatusCode CPMSimBSMon::fillHistograms()
 
   CmmCpHitsCollection* cmmTotalSIM = 0;
   if (cmmCpHitsTES) {
-    cmmTotalSIM = new CmmCpHitsCollection;
+    cmmTotalSIM = m_cmmCpHitsSim;
     simulate(cmmCpHitsTES, cmmTotalSIM, LVL1::CMMCPHits::TOTAL);
   }
   CmmCpHitsMap cmmTotalSimMap;
   setupMap(cmmTotalSIM, cmmTotalSimMap);
   compare(cmmTotalSimMap, cmMap, errorsCMM, LVL1::CMMCPHits::TOTAL);
   cmmTotalSimMap.clear();
-  delete cmmTotalSIM;
+  m_cmmCpHitsSim->clear();
 
   // Update error summary plots
 
@@ -661,13 +833,7 @@ StatusCode CPMSimBSMon::fillHistograms()
 
   // Save error vector for global summary
 
-  ErrorVector* save = new ErrorVector(crateErr);
-  sc = evtStore()->record(save, "L1CaloCPMMismatchVector");
-  if (sc != StatusCode::SUCCESS) {
-    msg(MSG::ERROR) << "Error recording CPM mismatch vector in TES "
-                    << endreq;
-    return sc;
-  }
+  m_errorBoard->set(TrigT1CaloErrorBoardTool::CPMMismatch, crateErr);
 
   if (m_debug) msg(MSG::DEBUG) << "Leaving fillHistograms" << endreq;
 
@@ -683,13 +849,25 @@ StatusCode CPMSimBSMon::procHistograms()
   if (endOfLumiBlock || endOfRun) {
   }
 
+  if (endOfRun && m_lazyHists.enabled()) {
+    int registered = 0;
+    int dropped    = 0;
+    StatusCode sc = m_lazyHists.registerFilled(registered, dropped);
+    if (sc.isFailure()) {
+      msg(MSG::ERROR) << "Failed to register mismatch histograms" << endreq;
+      return sc;
+    }
+    msg(MSG::DEBUG) << "Mismatch histograms written: " << registered
+                    << " omitted: " << dropped << endreq;
+  }
+
   return StatusCode::SUCCESS;
 }
 
 //  Compare Trigger Towers and CPM Towers
 
-bool CPMSimBSMon::compare(const TriggerTowerMap& ttMap,
-                          const CpmTowerMap& cpMap, ErrorVector& errors,
+bool CPMSimBSMon::compare(const TriggerTowerArray& ttArray,
+                          const CpmTowerArray& cpArray, ErrorVector& errors,
 			  bool overlap)
 {
   if (m_debug) {
@@ -700,160 +878,146 @@ bool CPMSimBSMon::compare(const TriggerTowerMap& ttMap,
   const int nCrates = 4;
   const int nCPMs   = 14;
   LVL1::CoordToHardware converter;
-  TriggerTowerMap::const_iterator ttMapIter    = ttMap.begin();
-  TriggerTowerMap::const_iterator ttMapIterEnd = ttMap.end();
-  CpmTowerMap::const_iterator     cpMapIter    = cpMap.begin();
-  CpmTowerMap::const_iterator     cpMapIterEnd = cpMap.end();
-
-  while (ttMapIter != ttMapIterEnd || cpMapIter != cpMapIterEnd) {
-
-    int ttKey = 0;
-    int cpKey = 0;
-    int ttEm  = 0;
-    int ttHad = 0;
-    int cpEm  = 0;
-    int cpHad = 0;
-    double eta = 0.;
-    double phi = 0.;
-    int key = 0;
-
-    if (ttMapIter != ttMapIterEnd) ttKey = ttMapIter->first;
-    if (cpMapIter != cpMapIterEnd) cpKey = cpMapIter->first;
-
-    if ((cpMapIter == cpMapIterEnd) ||
-                 ((ttMapIter != ttMapIterEnd) && (cpKey > ttKey))) {
-
-      // TriggerTower but no CPMTower
-
-      const LVL1::TriggerTower* tt = ttMapIter->second;
-      ++ttMapIter;
-      eta = tt->eta();
-      phi = tt->phi();
-      if (overlap) { // skip non-overlap TTs
-        const LVL1::Coordinate coord(phi, eta);
-	const int crate = converter.cpCrateOverlap(coord);
-        if (crate >= nCrates) continue;
-      }
-      ttEm  = tt->emEnergy();
-      ttHad = tt->hadEnergy();
-      key = ttKey;
-
-    } else if ((ttMapIter == ttMapIterEnd) ||
-                 ((cpMapIter != cpMapIterEnd) && (ttKey > cpKey))) {
 
-      // CPMTower but no TriggerTower
-
-      const LVL1::CPMTower* cp = cpMapIter->second;
-      ++cpMapIter;
-      eta = cp->eta();
-      phi = cp->phi();
-      cpEm  = cp->emEnergy();
-      cpHad = cp->hadEnergy();
-      key = cpKey;
+  // Visit towers present in either array in index order
+
+  for (int etaBin = 0; etaBin < TriggerTowerArray::s_etaBins; ++etaBin) {
+    uint64_t bits = ttArray.word(etaBin) | cpArray.word(etaBin);
+    while (bits) {
+
+      const int key = etaBin*TriggerTowerArray::s_phiBins
+                                   + TriggerTowerArray::nextBit(bits);
+      const LVL1::TriggerTower* tt = ttArray[key];
+      const LVL1::CPMTower*     cp = cpArray[key];
+      int ttEm  = 0;
+      int ttHad = 0;
+      int cpEm  = 0;
+      int cpHad = 0;
+      double eta = 0.;
+      double phi = 0.;
+
+      if (!cp) {
+
+        // TriggerTower but no CPMTower
+
+        eta = tt->eta();
+        phi = tt->phi();
+        if (overlap) { // skip non-overlap TTs
+          const LVL1::Coordinate coord(phi, eta);
+	  const int crate = converter.cpCrateOverlap(coord);
+          if (crate >= nCrates) continue;
+        }
+        ttEm  = tt->emEnergy();
+        ttHad = tt->hadEnergy();
 
-    } else {
+      } else if (!tt) {
 
-      // Have both
+        // CPMTower but no TriggerTower
 
-      const LVL1::TriggerTower* tt = ttMapIter->second;
-      const LVL1::CPMTower*     cp = cpMapIter->second;
-      ++ttMapIter;
-      ++cpMapIter;
-      eta = tt->eta();
-      phi = tt->phi();
-      ttEm  = tt->emEnergy();
-      ttHad = tt->hadEnergy();
-      cpEm  = cp->emEnergy();
-      cpHad = cp->hadEnergy();
-      key = ttKey;
-    }
+        eta = cp->eta();
+        phi = cp->phi();
+        cpEm  = cp->emEnergy();
+        cpHad = cp->hadEnergy();
 
-    if (!ttEm && !ttHad && !cpEm && !cpHad) continue;
-    
-    //  Fill in error plots
+      } else {
 
-    const LVL1::Coordinate coord(phi, eta);
-    const int crate = (overlap) ? converter.cpCrateOverlap(coord)
-                                : converter.cpCrate(coord);
-    const int cpm   = (overlap) ? converter.cpModuleOverlap(coord)
-                                : converter.cpModule(coord);
-    if (crate >= nCrates || cpm > nCPMs) continue;
-    const int loc = crate * nCPMs + cpm - 1;
-    const int cpmBins = nCrates * nCPMs;
-    const int bitEm  = (1 << EMTowerMismatch);
-    const int bitHad = (1 << HadTowerMismatch);
-    double phiFPGA = phi;
-    if (overlap) {
-      const double twoPi    = 2.*M_PI;
-      const double piByFour = M_PI/4.;
-      if (phi > 7.*piByFour)   phiFPGA -= twoPi;
-      else if (phi < piByFour) phiFPGA += twoPi;
-    }
-    const int loc2 = fpga(crate, phiFPGA);
+        // Have both
 
-    TH2F_LW* hist1 = 0;
-    TH2F_LW* hist2 = 0;
-    if (ttEm && ttEm == cpEm) { // non-zero match
-      errors[loc] |= bitEm;
-      hist1 = (overlap) ? m_h_cpm_em_2d_etaPhi_tt_PpmEqOverlap
-                        : m_h_cpm_em_2d_etaPhi_tt_PpmEqCore;
-      hist2 = m_h_cpm_2d_tt_PpmEqCpmFpga;
-    } else if (ttEm != cpEm) {  // mis-match
-      mismatch = true;
-      errors[loc+cpmBins] |= bitEm;
-      if (ttEm && cpEm) {       // non-zero mis-match
-        hist1 = (overlap) ? m_h_cpm_em_2d_etaPhi_tt_PpmNeOverlap
-	                  : m_h_cpm_em_2d_etaPhi_tt_PpmNeCore;
-        hist2 = m_h_cpm_2d_tt_PpmNeCpmFpga;
-      } else if (!cpEm) {       // no cp
-	hist1 = (overlap) ? m_h_cpm_em_2d_etaPhi_tt_PpmNoOverlap
-	                  : m_h_cpm_em_2d_etaPhi_tt_PpmNoCore;
-	hist2 = m_h_cpm_2d_tt_PpmNoCpmFpga;
-      } else {                  // no tt
-	hist1 = (overlap) ? m_h_cpm_em_2d_etaPhi_tt_OverlapNoPpm
-	                  : m_h_cpm_em_2d_etaPhi_tt_CoreNoPpm;
-	hist2 = m_h_cpm_2d_tt_CpmNoPpmFpga;
+        eta = tt->eta();
+        phi = tt->phi();
+        ttEm  = tt->emEnergy();
+        ttHad = tt->hadEnergy();
+        cpEm  = cp->emEnergy();
+        cpHad = cp->hadEnergy();
       }
-      if (m_debug) {
-        msg(MSG::DEBUG) << " EMTowerMismatch key/eta/phi/crate/cpm/tt/cp: "
-                        << key << "/" << eta << "/" << phi << "/" << crate
-			<< "/" << cpm << "/" << ttEm << "/" << cpEm << endreq;
+
+      if (!ttEm && !ttHad && !cpEm && !cpHad) continue;
+    
+      //  Fill in error plots
+
+      const LVL1::Coordinate coord(phi, eta);
+      const int crate = (overlap) ? converter.cpCrateOverlap(coord)
+                                  : converter.cpCrate(coord);
+      const int cpm   = (overlap) ? converter.cpModuleOverlap(coord)
+                                  : converter.cpModule(coord);
+      if (crate >= nCrates || cpm > nCPMs) continue;
+      const int loc = crate * nCPMs + cpm - 1;
+      const int cpmBins = nCrates * nCPMs;
+      const int bitEm  = (1 << EMTowerMismatch);
+      const int bitHad = (1 << HadTowerMismatch);
+      double phiFPGA = phi;
+      if (overlap) {
+        const double twoPi    = 2.*M_PI;
+        const double piByFour = M_PI/4.;
+        if (phi > 7.*piByFour)   phiFPGA -= twoPi;
+        else if (phi < piByFour) phiFPGA += twoPi;
       }
-    }
-    if (hist1) m_histTool->fillCPMEtaVsPhi(hist1, eta, phi);
-    if (hist2) hist2->Fill(loc, loc2);
-
-    hist1 = 0;
-    hist2 = 0;
-    if (ttHad && ttHad == cpHad) { // non-zero match
-      errors[loc] |= bitHad;
-      hist1 = (overlap) ? m_h_cpm_had_2d_etaPhi_tt_PpmEqOverlap
-                        : m_h_cpm_had_2d_etaPhi_tt_PpmEqCore;
-      hist2 = m_h_cpm_2d_tt_PpmEqCpmFpga;
-    } else if (ttHad != cpHad) {   // mis-match
-      mismatch = true;
-      errors[loc+cpmBins] |= bitHad;
-      if (ttHad && cpHad) {        // non-zero mis-match
-        hist1 = (overlap) ? m_h_cpm_had_2d_etaPhi_tt_PpmNeOverlap
-	                  : m_h_cpm_had_2d_etaPhi_tt_PpmNeCore;
-        hist2 = m_h_cpm_2d_tt_PpmNeCpmFpga;
-      } else if (!cpHad) {         // no cp
-	hist1 = (overlap) ? m_h_cpm_had_2d_etaPhi_tt_PpmNoOverlap
-	                  : m_h_cpm_had_2d_etaPhi_tt_PpmNoCore;
-	hist2 = m_h_cpm_2d_tt_PpmNoCpmFpga;
-      } else {                     // no tt
-	hist1 = (overlap) ? m_h_cpm_had_2d_etaPhi_tt_OverlapNoPpm
-	                  : m_h_cpm_had_2d_etaPhi_tt_CoreNoPpm;
-	hist2 = m_h_cpm_2d_tt_CpmNoPpmFpga;
+      const int loc2 = fpga(crate, phiFPGA);
+
+      TH2F_LW* hist1 = 0;
+      TH2F_LW* hist2 = 0;
+      if (ttEm && ttEm == cpEm) { // non-zero match
+        errors[loc] |= bitEm;
+        hist1 = (overlap) ? m_h_cpm_em_2d_etaPhi_tt_PpmEqOverlap
+                          : m_h_cpm_em_2d_etaPhi_tt_PpmEqCore;
+        hist2 = m_h_cpm_2d_tt_PpmEqCpmFpga;
+      } else if (ttEm != cpEm) {  // mis-match
+        mismatch = true;
+        errors[loc+cpmBins] |= bitEm;
+        if (ttEm && cpEm) {       // non-zero mis-match
+          hist1 = (overlap) ? m_h_cpm_em_2d_etaPhi_tt_PpmNeOverlap
+			    : m_h_cpm_em_2d_etaPhi_tt_PpmNeCore;
+          hist2 = m_h_cpm_2d_tt_PpmNeCpmFpga;
+        } else if (!cpEm) {       // no cp
+	  hist1 = (overlap) ? m_h_cpm_em_2d_etaPhi_tt_PpmNoOverlap
+			    : m_h_cpm_em_2d_etaPhi_tt_PpmNoCore;
+	  hist2 = m_h_cpm_2d_tt_PpmNoCpmFpga;
+        } else {                  // no tt
+	  hist1 = (overlap) ? m_h_cpm_em_2d_etaPhi_tt_OverlapNoPpm
+			    : m_h_cpm_em_2d_etaPhi_tt_CoreNoPpm;
+	  hist2 = m_h_cpm_2d_tt_CpmNoPpmFpga;
+        }
+        if (m_debug) {
+          msg(MSG::DEBUG) << " EMTowerMismatch key/eta/phi/crate/cpm/tt/cp: "
+                          << key << "/" << eta << "/" << phi << "/" << crate
+			  << "/" << cpm << "/" << ttEm << "/" << cpEm << endreq;
+        }
       }
-      if (m_debug) {
-        msg(MSG::DEBUG) << " HadTowerMismatch key/eta/phi/crate/cpm/tt/cp: "
-                        << key << "/" << eta << "/" << phi << "/" << crate
-			<< "/" << cpm << "/" << ttHad << "/" << cpHad << endreq;
+      if (hist1) m_histTool->fillCPMEtaVsPhi(hist1, eta, phi);
+      if (hist2) hist2->Fill(loc, loc2);
+
+      hist1 = 0;
+      hist2 = 0;
+      if (ttHad && ttHad == cpHad) { // non-zero match
+        errors[loc] |= bitHad;
+        hist1 = (overlap) ? m_h_cpm_had_2d_etaPhi_tt_PpmEqOverlap
+                          : m_h_cpm_had_2d_etaPhi_tt_PpmEqCore;
+        hist2 = m_h_cpm_2d_tt_PpmEqCpmFpga;
+      } else if (ttHad != cpHad) {   // mis-match
+        mismatch = true;
+        errors[loc+cpmBins] |= bitHad;
+        if (ttHad && cpHad) {        // non-zero mis-match
+          hist1 = (overlap) ? m_h_cpm_had_2d_etaPhi_tt_PpmNeOverlap
+			    : m_h_cpm_had_2d_etaPhi_tt_PpmNeCore;
+          hist2 = m_h_cpm_2d_tt_PpmNeCpmFpga;
+        } else if (!cpHad) {         // no cp
+	  hist1 = (overlap) ? m_h_cpm_had_2d_etaPhi_tt_PpmNoOverlap
+			    : m_h_cpm_had_2d_etaPhi_tt_PpmNoCore;
+	  hist2 = m_h_cpm_2d_tt_PpmNoCpmFpga;
+        } else {                     // no tt
+	  hist1 = (overlap) ? m_h_cpm_had_2d_etaPhi_tt_OverlapNoPpm
+			    : m_h_cpm_had_2d_etaPhi_tt_CoreNoPpm;
+	  hist2 = m_h_cpm_2d_tt_CpmNoPpmFpga;
+        }
+        if (m_debug) {
+          msg(MSG::DEBUG) << " HadTowerMismatch key/eta/phi/crate/cpm/tt/cp: "
+                          << key << "/" << eta << "/" << phi << "/" << crate
+			  << "/" << cpm << "/" << ttHad << "/" << cpHad << endreq;
+        }
       }
+      if (hist1) m_histTool->fillCPMEtaVsPhi(hist1, eta, phi);
+      if (hist2) hist2->Fill(loc, loc2+1);
     }
-    if (hist1) m_histTool->fillCPMEtaVsPhi(hist1, eta, phi);
-    if (hist2) hist2->Fill(loc, loc2+1);
   }
 
   return mismatch;
@@ -869,6 +1033,29 @@ void CPMSimBSMon::compare(const CpmRoiMap& roiSimMap, const CpmRoiMap& roiMap,
   const int nCrates = 4;
   const int nCPMs = 14;
   LVL1::CPRoIDecoder decoder;
+
+  // All match - fill match plots only
+
+  if (TrigT1CaloMapCompare::agree(roiSimMap, roiMap, CpmRoiPolicy())) {
+    CpmRoiMap::const_iterator iter  = roiMap.begin();
+    CpmRoiMap::const_iterator iterE = roiMap.end();
+    for (; iter != iterE; ++iter) {
+      const LVL1::CPMRoI* roi = iter->second;
+      const unsigned int hits = roi->hits();
+      if (!hits) continue;
+      const int locX = roi->crate() * nCPMs + roi->cpm() - 1;
+      const int locY = roi->chip() * 8 + roi->location();
+      const LVL1::CoordinateRange coord(decoder.coordinate(roi->roiWord()));
+      errors[locX] |= (1 << RoIMismatch);
+      m_h_cpm_2d_roi_SimEqData->Fill(locX, locY);
+      m_histTool->fillCPMRoIEtaVsPhi(m_h_cpm_2d_etaPhi_roi_SimEqData,
+                                     coord.eta(), coord.phi());
+      m_histTool->fillXVsThresholds(m_h_cpm_2d_roi_ThreshSimEqData, locX,
+                                                               hits, 16, 1);
+    }
+    return;
+  }
+
   CpmRoiMap::const_iterator simMapIter    = roiSimMap.begin();
   CpmRoiMap::const_iterator simMapIterEnd = roiSimMap.end();
   CpmRoiMap::const_iterator datMapIter    = roiMap.begin();
@@ -981,6 +1168,34 @@ void CPMSimBSMon::compare(const CpmHitsMap& cpmSimMap, const CpmHitsMap& cpmMap,
     msg(MSG::DEBUG) << "Compare simulated CPM Hits with data" << endreq;
   }
 
+  // All match - fill match plots only
+
+  if (TrigT1CaloMapCompare::agree(cpmSimMap, cpmMap, CpmHitsPolicy())) {
+    const int nCPMs   = 14;
+    const int nThresh = 8;
+    const int thrLen  = 3;
+    CpmHitsMap::const_iterator iter  = cpmMap.begin();
+    CpmHitsMap::const_iterator iterE = cpmMap.end();
+    for (; iter != iterE; ++iter) {
+      const LVL1::CPMHits* ch = iter->second;
+      const unsigned int hits0 = ch->HitWord0();
+      const unsigned int hits1 = ch->HitWord1();
+      if (!hits0 && !hits1) continue;
+      const int crate = ch->crate();
+      const int cpm   = ch->module();
+      const int loc   = crate * nCPMs + cpm - 1;
+      errors[loc] |= (1 << CPMHitsMismatch);
+      m_h_cpm_2d_thresh_SimEqData->Fill(cpm, crate);
+      int same = m_histTool->thresholdsSame(hits0, hits0, nThresh, thrLen);
+      m_histTool->fillXVsThresholds(m_h_cpm_2d_thresh_ThreshSimEqData, loc,
+                                                        same, nThresh, 1);
+      same = m_histTool->thresholdsSame(hits1, hits1, nThresh, thrLen);
+      m_histTool->fillXVsThresholds(m_h_cpm_2d_thresh_ThreshSimEqData, loc,
+                                                same, nThresh, 1, nThresh);
+    }
+    return;
+  }
+
   CpmHitsMap::const_iterator simMapIter    = cpmSimMap.begin();
   CpmHitsMap::const_iterator simMapIterEnd = cpmSimMap.end();
   CpmHitsMap::const_iterator datMapIter    = cpmMap.begin();
@@ -1452,10 +1667,10 @@ void CPMSimBSMon::setLabels(LWHist* hist, bool xAxis)
 }
 
 void CPMSimBSMon::setupMap(const TriggerTowerCollection* coll,
-                                 TriggerTowerMap& map)
+                                 TriggerTowerArray& array)
 {
+  array.clear();
   if (coll) {
-    LVL1::TriggerTowerKey towerKey;
     TriggerTowerCollection::const_iterator pos  = coll->begin();
     TriggerTowerCollection::const_iterator posE = coll->end();
     for (; pos != posE; ++pos) {
@@ -1463,24 +1678,23 @@ void CPMSimBSMon::setupMap(const TriggerTowerCollection* coll,
       if (eta > -2.5 && eta < 2.5 &&
                      ((*pos)->emEnergy() > 0 || (*pos)->hadEnergy() > 0)) {
         const double phi = (*pos)->phi();
-        const int key = towerKey.ttKey(phi, eta);
-        map.insert(std::make_pair(key, *pos));
+        array.insert(TriggerTowerArray::index(eta, phi), *pos);
       }
     }
   }
 }
 
-void CPMSimBSMon::setupMap(const CpmTowerCollection* coll, CpmTowerMap& map)
+void CPMSimBSMon::setupMap(const CpmTowerCollection* coll,
+                                 CpmTowerArray& array)
 {
+  array.clear();
   if (coll) {
-    LVL1::TriggerTowerKey towerKey;
     CpmTowerCollection::const_iterator pos  = coll->begin();
     CpmTowerCollection::const_iterator posE = coll->end();
     for (; pos != posE; ++pos) {
       const double eta = (*pos)->eta();
       const double phi = (*pos)->phi();
-      const int key = towerKey.ttKey(phi, eta);
-      map.insert(std::make_pair(key, *pos));
+      array.insert(CpmTowerArray::index(eta, phi), *pos);
     }
   }
 }
@@ -1529,65 +1743,113 @@ void CPMSimBSMon::setupMap(const CmmCpHitsCollection* coll, CmmCpHitsMap& map)
   }
 }
 
-void CPMSimBSMon::simulate(const CpmTowerMap towers, const CpmTowerMap towersOv,
+bool CPMSimBSMon::simulate(const CpmTowerArray& towers,
+                           const CpmTowerArray& towersOv,
                                  CpmRoiCollection* rois)
 {
   if (m_debug) msg(MSG::DEBUG) << "Simulate CPM RoIs from CPM Towers" << endreq;
 
   // Process a crate at a time to use overlap data
+  // The RoI tool needs maps keyed by TriggerTowerKey
   const int ncrates = 4;
   std::vector<CpmTowerMap> crateMaps(ncrates);
   LVL1::CoordToHardware converter;
-  CpmTowerCollection* tempColl = new CpmTowerCollection;
-  CpmTowerMap::const_iterator iter  = towers.begin();
-  CpmTowerMap::const_iterator iterE = towers.end();
-  for (; iter != iterE; ++iter) {
-    LVL1::CPMTower* tt = ttCheck(iter->second, tempColl);
-    const LVL1::Coordinate coord(tt->phi(), tt->eta());
-    const int crate = converter.cpCrate(coord);
-    if (crate >= ncrates) continue;
-    crateMaps[crate].insert(std::make_pair(iter->first, tt));
+  LVL1::TriggerTowerKey towerKey;
+  m_towerObjects.release();
+  for (int etaBin = 0; etaBin < CpmTowerArray::s_etaBins; ++etaBin) {
+    uint64_t bits = towers.word(etaBin);
+    while (bits) {
+      const int index = etaBin*CpmTowerArray::s_phiBins
+                                     + CpmTowerArray::nextBit(bits);
+      LVL1::CPMTower* tt = ttCheck(towers[index]);
+      const LVL1::Coordinate coord(tt->phi(), tt->eta());
+      const int crate = converter.cpCrate(coord);
+      if (crate >= ncrates) continue;
+      const int key = towerKey.ttKey(tt->phi(), tt->eta());
+      crateMaps[crate].insert(std::make_pair(key, tt));
+    }
   }
   // If overlap data not present take from core data
-  iter  = (m_overlapPresent) ? towersOv.begin() : towers.begin();
-  iterE = (m_overlapPresent) ? towersOv.end()   : towers.end();
-  for (; iter != iterE; ++iter) {
-    LVL1::CPMTower* tt = ttCheck(iter->second, tempColl);
-    const LVL1::Coordinate coord(tt->phi(), tt->eta());
-    const int crate = converter.cpCrateOverlap(coord);
-    if (crate >= ncrates) continue;
-    crateMaps[crate].insert(std::make_pair(iter->first, tt));
+  const CpmTowerArray& overlap((m_overlapPresent) ? towersOv : towers);
+  for (int etaBin = 0; etaBin < CpmTowerArray::s_etaBins; ++etaBin) {
+    uint64_t bits = overlap.word(etaBin);
+    while (bits) {
+      const int index = etaBin*CpmTowerArray::s_phiBins
+                                     + CpmTowerArray::nextBit(bits);
+      LVL1::CPMTower* tt = ttCheck(overlap[index]);
+      const LVL1::Coordinate coord(tt->phi(), tt->eta());
+      const int crate = converter.cpCrateOverlap(coord);
+      if (crate >= ncrates) continue;
+      const int key = towerKey.ttKey(tt->phi(), tt->eta());
+      crateMaps[crate].insert(std::make_pair(key, tt));
+    }
+  }
+  // Find RoIs for each crate, in parallel if threads available and
+  // no debug output, then merge in crate order
+  std::vector<TrigT1CaloTaskPool::Task*> tasks;
+  for (int crate = 0; crate < ncrates; ++crate) {
+    m_crateTasks[crate]->setTowers(&crateMaps[crate]);
+    tasks.push_back(m_crateTasks[crate]);
+  }
+  bool ok = true;
+  if (m_roiPool.workers() > 0 && !m_debug) ok = m_roiPool.run(tasks);
+  else {
+    for (int crate = 0; crate < ncrates; ++crate) tasks[crate]->execute();
+  }
+  if (!ok) {
+    msg(MSG::ERROR) << "Exception in per-crate RoI simulation,"
+                    << " RoIs not compared" << endreq;
+    for (int crate = 0; crate < ncrates; ++crate) {
+      m_crateTasks[crate]->rois()->clear();
+    }
+    return false;
   }
   for (int crate = 0; crate < ncrates; ++crate) {
-    InternalRoiCollection* intRois = new InternalRoiCollection;
-    m_emTauTool->findRoIs(&crateMaps[crate], intRois);
+    InternalRoiCollection* intRois = m_crateTasks[crate]->rois();
     InternalRoiCollection::iterator roiIter  = intRois->begin();
     InternalRoiCollection::iterator roiIterE = intRois->end();
     for (; roiIter != roiIterE; ++roiIter) {
-      LVL1::CPMRoI* roi = new LVL1::CPMRoI((*roiIter)->RoIWord());
-      if (roi->crate() == crate) rois->push_back(roi);
-      else delete roi;
+      const LVL1::CPMRoI roi((*roiIter)->RoIWord());
+      if (roi.crate() == crate) {
+        LVL1::CPMRoI* simRoi = m_roiObjects.get();
+        *simRoi = roi;
+        rois->push_back(simRoi);
+      }
     }
-    delete intRois;
+    intRois->clear();
   }
-  delete tempColl;
+  return true;
 }
 
 // Quicker version when overlap same as core
 
-void CPMSimBSMon::simulate(const CpmTowerMap towers, CpmRoiCollection* rois)
+void CPMSimBSMon::simulate(const CpmTowerArray& towers,
+                                 CpmRoiCollection* rois)
 {
   if (m_debug) msg(MSG::DEBUG) << "Simulate CPM RoIs from CPM Towers" << endreq;
 
-  InternalRoiCollection* intRois = new InternalRoiCollection;
-  m_emTauTool->findRoIs(&towers, intRois);
-  InternalRoiCollection::iterator roiIter  = intRois->begin();
-  InternalRoiCollection::iterator roiIterE = intRois->end();
+  // The RoI tool needs a map keyed by TriggerTowerKey
+  CpmTowerMap towerMap;
+  LVL1::TriggerTowerKey towerKey;
+  for (int etaBin = 0; etaBin < CpmTowerArray::s_etaBins; ++etaBin) {
+    uint64_t bits = towers.word(etaBin);
+    while (bits) {
+      const int index = etaBin*CpmTowerArray::s_phiBins
+                                     + CpmTowerArray::nextBit(bits);
+      LVL1::CPMTower* tt = towers[index];
+      const int key = towerKey.ttKey(tt->phi(), tt->eta());
+      towerMap.insert(std::make_pair(key, tt));
+    }
+  }
+  m_emTauTool->findRoIs(&towerMap, m_intRois);
+  InternalRoiCollection::iterator roiIter  = m_intRois->begin();
+  InternalRoiCollection::iterator roiIterE = m_intRois->end();
   for (; roiIter != roiIterE; ++roiIter) {
-    LVL1::CPMRoI* roi = new LVL1::CPMRoI((*roiIter)->RoIWord());
+    LVL1::CPMRoI* roi = m_roiObjects.get();
+    *roi = LVL1::CPMRoI((*roiIter)->RoIWord());
     rois->push_back(roi);
   }
-  delete intRois;
+  m_intRois->clear();
 }
 
 void CPMSimBSMon::simulate(const CpmRoiCollection* rois,
@@ -1623,8 +1885,7 @@ int CPMSimBSMon::fpga(int crate, double phi)
 
 // Return a tower with zero energy if parity bit is set
 
-LVL1::CPMTower* CPMSimBSMon::ttCheck(LVL1::CPMTower* tt,
-                                     CpmTowerCollection* coll)
+LVL1::CPMTower* CPMSimBSMon::ttCheck(LVL1::CPMTower* tt)
 {
   const LVL1::DataError emError(tt->emError());
   const LVL1::DataError hadError(tt->hadError());
@@ -1638,9 +1899,9 @@ LVL1::CPMTower* CPMSimBSMon::ttCheck(LVL1::CPMTower* tt,
     std::vector<int> hadErrorVec(tt->hadErrorVec());
     if (emParity)  emEnergyVec[peak]  = 0;
     if (hadParity) hadEnergyVec[peak] = 0;
-    LVL1::CPMTower* ct = new LVL1::CPMTower(tt->phi(), tt->eta(),
+    LVL1::CPMTower* ct = m_towerObjects.get();
+    *ct = LVL1::CPMTower(tt->phi(), tt->eta(),
         emEnergyVec, emErrorVec, hadEnergyVec, hadErrorVec, peak);
-    coll->push_back(ct);
     return ct;
   }
   return tt;
@@ -1650,20 +1911,42 @@ LVL1::CPMTower* CPMSimBSMon::ttCheck(LVL1::CPMTower* tt,
 
 bool CPMSimBSMon::limitedRoiSet(int crate)
 {
-  if (m_rodTES) {
-    m_limitedRoi = 0;
-    const int nCrates = 4;
-    RodHeaderCollection::const_iterator rodIter  = m_rodTES->begin();
-    RodHeaderCollection::const_iterator rodIterE = m_rodTES->end();
-    for (; rodIter != rodIterE; ++rodIter) {
-      const LVL1::RODHeader* rod = *rodIter;
-      const int rodCrate = rod->crate() - 8;
-      if (rodCrate >= 0 && rodCrate < nCrates
-          && rod->dataType() == 1 && rod->limitedRoISet()) {
-        m_limitedRoi |= (1<<rodCrate);
-      }
+  // CP crates are ROD crates 8-11
+  return (m_rodSummary && m_rodSummary->limitedRoI(crate + 8));
+}
+
+// Compare upstream RoIs with RoIs simulated here from the same CPM Towers,
+// switching reuse off on any difference
+
+void CPMSimBSMon::checkUpstream(const CpmRoiCollection* rois,
+                                const CpmRoiCollection* simRois)
+{
+  CpmRoiMap upMap;
+  CpmRoiMap simMap;
+  setupMap(rois, upMap);
+  setupMap(simRois, simMap);
+  ++m_upstreamChecked;
+  if (!TrigT1CaloMapCompare::agree(upMap, simMap, CpmRoiPolicy())) {
+    ++m_upstreamDiffer;
+    if (m_upstreamOn) {
+      msg(MSG::WARNING) << "Upstream CPM RoIs " << m_simCpmRoiLocation
+                        << " differ from local simulation, simulating"
+			<< " locally from now on" << endreq;
+      m_upstreamOn = false;
     }
-    m_rodTES = 0;
   }
-  return (((m_limitedRoi>>crate)&0x1) == 1);
+}
+
+const CPMSimBSMon::CpmRoiCollection* CPMSimBSMon::upstreamRois()
+{
+  const CpmRoiCollection* coll = 0;
+  if (!m_simCpmRoiLocation.empty() &&
+      evtStore()->contains<CpmRoiCollection>(m_simCpmRoiLocation)) {
+    if (evtStore()->retrieve(coll, m_simCpmRoiLocation).isFailure()) coll = 0;
+  }
+  if (coll && m_debug) {
+    msg(MSG::DEBUG) << "Upstream simulation available " << m_simCpmRoiLocation
+                    << endreq;
+  }
+  return coll;
 }
@@ -31,8 +31,8 @@
 #include "AnalysisTriggerEvent/LVL1_ROI.h"
 #include "AnalysisTriggerEvent/EmTau_ROI.h"
 #include "AnalysisTriggerEvent/Jet_ROI.h"
-#include "TrigT1CaloToolInterfaces/IL1TriggerTowerTool.h"
 #include "TrigT1CaloCalibToolInterfaces/IL1CaloLArTowerEnergy.h"
+#include "TrigT1CaloToolInterfaces/IL1TriggerTowerTool.h"
 #include "EventInfo/EventInfo.h"
 #include "EventInfo/EventID.h"
 #include "egammaEvent/ElectronContainer.h"
@@ -48,6 +48,7 @@
 #include "Identifier/Identifier.h"
 
 #include "TrigT1CaloMonitoring/EmEfficienciesMonTool.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloTowerTableTool.h"
 #include "TrigT1CaloMonitoringTools/TrigT1CaloMonErrorTool.h"
 #include "TrigT1CaloMonitoringTools/TrigT1CaloLWHistogramTool.h"
 
@@ -57,6 +58,7 @@ EmEfficienciesMonTool::EmEfficienciesMonTool(const std::string & type,
 		  : ManagedMonitorToolBase(type, name, parent),
                         m_errorTool("TrigT1CaloMonErrorTool"),
 			m_histTool("TrigT1CaloLWHistogramTool"),
+			m_towerTable("TrigT1CaloTowerTableTool"),
 			m_ttTool("LVL1::L1TriggerTowerTool/L1TriggerTowerTool"),
 			m_larEnergy("LVL1::L1CaloLArTowerEnergy/L1CaloLArTowerEnergy"),
 			m_trigger("Trig::TrigDecisionTool/TrigDecisionTool"),
@@ -108,7 +110,9 @@ EmEfficienciesMonTool::EmEfficienciesMonTool(const std::string & type,
 {
 
 	declareProperty("HistogramTool", m_histTool);
-	declareProperty("TriggerTowerTool", m_ttTool);
+	declareProperty("TowerTableTool", m_towerTable);
+	declareProperty("TriggerTowerTool", m_ttTool,
+	                "Deprecated, set on TrigT1CaloTowerTableTool instead");
 	declareProperty("LArTowerEnergyTool", m_larEnergy);
 	declareProperty("TrigDecisionTool", m_trigger);
 	declareProperty("DeadChannelsFolder", m_dbPpmDeadChannelsFolder);
@@ -179,9 +183,14 @@ StatusCode EmEfficienciesMonTool::initialize()
 		return sc;
 	}
 
-	sc = m_ttTool.retrieve();
+	if (m_ttTool.typeAndName() != "LVL1::L1TriggerTowerTool/L1TriggerTowerTool") {
+		msg(MSG::WARNING) << "Property TriggerTowerTool is deprecated and ignored, "
+		                  << "set it on TrigT1CaloTowerTableTool instead" << endreq;
+	}
+
+	sc = m_towerTable.retrieve();
 	if (sc.isFailure()) {
-		msg(MSG::ERROR) << "Cannot retrieve L1TriggerTowerTool" << endreq;
+		msg(MSG::ERROR) << "Cannot retrieve TrigT1CaloTowerTableTool" << endreq;
 		return sc;
 	}
 
@@ -228,6 +237,12 @@ StatusCode EmEfficienciesMonTool::bookHistogramsRecurrent()
 
 	if (newRun) {
 
+		StatusCode sc = m_towerTable->update();
+		if (sc.isFailure()) {
+			msg(MSG::ERROR) << "Failed to build tower table" << endreq;
+			return sc;
+		}
+
                 MgmtAttr_t attr = ATTRIB_UNMANAGED;
 		std::string dir(m_rootDir + "/Reco/EmEfficiencies");
 
@@ -1413,8 +1428,9 @@ StatusCode EmEfficienciesMonTool::triggerTowerAnalysis() {
 		// Get the values of eta and phi for the trigger towers
 		double ttEta = (*ttItr)->eta();
 		double ttPhi = (*ttItr)->phi();
-		const L1CaloCoolChannelId emCoolId(m_ttTool->channelID(ttEta, ttPhi, 0));
-		const Identifier emIdent(m_ttTool->identifier(ttEta, ttPhi, 0));
+		const TrigT1CaloTowerTableTool::Channel& emChan(m_towerTable->tower(ttEta, ttPhi).layer[0]);
+		const L1CaloCoolChannelId& emCoolId(emChan.coolId);
+		const Identifier& emIdent(emChan.identifier);
 
 		// The dead channels folder (only has entries for dead channels - no entry = good channel)
 		unsigned int emDead(0);
@@ -25,11 +25,11 @@
 
 #include "GaudiKernel/MsgStream.h"
 #include "GaudiKernel/StatusCode.h"
-#include "SGTools/StlVectorClids.h"
 
 #include "AthenaMonitoring/AthenaMonManager.h"
 
 #include "TrigT1CaloMonitoring/JEMMon.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloErrorBoardTool.h"
 #include "TrigT1CaloMonitoringTools/TrigT1CaloMonErrorTool.h"
 #include "TrigT1CaloMonitoringTools/TrigT1CaloLWHistogramTool.h"
 
@@ -52,6 +52,7 @@ JEMMon::JEMMon( const std::string & type, const std::string & name,
   : ManagedMonitorToolBase( type, name, parent ),
     m_errorTool("TrigT1CaloMonErrorTool"),
     m_histTool("TrigT1CaloLWHistogramTool"),
+    m_errorBoard("TrigT1CaloErrorBoardTool"),
     m_histBooked(false),
     m_h_jem_em_1d_jetEl_Eta(0),
     m_h_jem_had_1d_jetEl_Eta(0),
@@ -147,6 +148,13 @@ StatusCode JEMMon::initialize()
     return sc;
   }
 
+  sc = m_errorBoard.retrieve();
+  if( sc.isFailure() ) {
+    msg(MSG::ERROR) << "Unable to locate Tool TrigT1CaloErrorBoardTool"
+                    << endreq;
+    return sc;
+  }
+
   return StatusCode::SUCCESS;
 }
 
@@ -668,13 +676,8 @@ StatusCode JEMMon::fillHistograms()
     }
   }
 
-  // Write overview vector to StoreGate
-  std::vector<int>* save = new std::vector<int>(overview);
-  sc = evtStore()->record(save, "L1CaloJEMErrorVector");
-  if (sc != StatusCode::SUCCESS) {
-    msg(MSG::ERROR) << "Error recording JEM error vector in TES " << endreq;
-    return sc;
-  }
+  // Write overview vector to error board
+  m_errorBoard->set(TrigT1CaloErrorBoardTool::JEMError, overview);
 
   if (debug) {
     msg(MSG::DEBUG) << "--------------------------------------" << endreq;
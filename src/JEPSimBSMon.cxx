@@ -8,6 +8,7 @@
 //
 // ********************************************************************
 
+#include <algorithm>
 #include <utility>
 
 #include "LWHists/LWHist.h"
@@ -17,7 +18,6 @@
 
 #include "GaudiKernel/MsgStream.h"
 #include "GaudiKernel/StatusCode.h"
-#include "SGTools/StlVectorClids.h"
 
 #include "AthenaMonitoring/AthenaMonManager.h"
 
@@ -28,7 +28,6 @@
 #include "TrigT1CaloEvent/CMMRoI.h"
 #include "TrigT1CaloEvent/JEMEtSums.h"
 #include "TrigT1CaloEvent/CMMEtSums.h"
-#include "TrigT1CaloEvent/RODHeader.h"
 #include "TrigT1CaloEvent/TriggerTower.h"
 #include "TrigT1CaloUtils/CoordToHardware.h"
 #include "TrigT1CaloUtils/JetAlgorithm.h"
@@ -41,9 +40,122 @@
 #include "TrigT1Interfaces/TrigT1CaloDefs.h"
 
 #include "TrigT1CaloMonitoring/JEPSimBSMon.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloErrorBoardTool.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloMapCompare.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloRodSummary.h"
 #include "TrigT1CaloMonitoringTools/TrigT1CaloMonErrorTool.h"
 #include "TrigT1CaloMonitoringTools/TrigT1CaloLWHistogramTool.h"
 
+/*---------------------------------------------------------*/
+class JEPSimBSMon::CrateRoiTask : public TrigT1CaloTaskPool::Task
+/*---------------------------------------------------------*/
+{
+ public:
+  CrateRoiTask(LVL1::IL1JetTools* tool)
+    : m_tool(tool), m_elements(SG::VIEW_ELEMENTS) {}
+  /// Find RoIs into this task's own collection
+  virtual void execute() {
+    m_rois.clear();
+    m_tool->findRoIs(&m_elements, &m_rois);
+  }
+  JetElementCollection*  elements() { return &m_elements; }
+  InternalRoiCollection* rois()     { return &m_rois; }
+ private:
+  LVL1::IL1JetTools*    m_tool;
+  JetElementCollection  m_elements;
+  InternalRoiCollection m_rois;
+};
+
+/*---------------------------------------------------------*/
+class JEPSimBSMon::JetChainTask : public TrigT1CaloTaskPool::Task
+/*---------------------------------------------------------*/
+{
+ public:
+  JetChainTask(JEPSimBSMon* parent)
+    : m_parent(parent), m_input(0), m_errorsJEM(0), m_errorsCMM(0),
+      m_upstreamRois(false) {}
+  void set(const JetChainInput* input, ErrorVector* errorsJEM,
+                                       ErrorVector* errorsCMM) {
+    m_input = input;
+    m_errorsJEM = errorsJEM;
+    m_errorsCMM = errorsCMM;
+    m_upstreamRois = false;
+  }
+  virtual void execute() {
+    m_upstreamRois = m_parent->compareJetChain(*m_input, *m_errorsJEM,
+                                                         *m_errorsCMM);
+  }
+  /// True if upstream RoIs were used
+  bool upstreamRois() const { return m_upstreamRois; }
+ private:
+  JEPSimBSMon*         m_parent;
+  const JetChainInput* m_input;
+  ErrorVector*         m_errorsJEM;
+  ErrorVector*         m_errorsCMM;
+  bool                 m_upstreamRois;
+};
+
+/*---------------------------------------------------------*/
+class JEPSimBSMon::EnergySimTask : public TrigT1CaloTaskPool::Task
+/*---------------------------------------------------------*/
+{
+ public:
+  EnergySimTask(JEPSimBSMon* parent)
+    : m_parent(parent), m_elements(0), m_sums(0) {}
+  void set(const JetElementCollection* elements,
+           const CmmEtSumsCollection*  sums) {
+    m_elements = elements;
+    m_sums = sums;
+  }
+  virtual void execute() {
+    m_parent->simulateEnergyChain(m_elements, m_sums);
+  }
+ private:
+  JEPSimBSMon*                m_parent;
+  const JetElementCollection* m_elements;
+  const CmmEtSumsCollection*  m_sums;
+};
+
+// Match criteria of the compare() methods for TrigT1CaloMapCompare
+
+namespace {
+
+struct JetElementPolicy {
+  bool empty(const LVL1::JetElement* je) const {
+    return !je->emEnergy() && !je->hadEnergy();
+  }
+  bool equal(const LVL1::JetElement* sim, const LVL1::JetElement* dat) const {
+    return sim->emEnergy()  == dat->emEnergy() &&
+           sim->hadEnergy() == dat->hadEnergy();
+  }
+};
+
+struct JemRoiPolicy {
+  bool empty(const LVL1::JEMRoI* roi) const { return !roi->hits(); }
+  bool equal(const LVL1::JEMRoI* sim, const LVL1::JEMRoI* dat) const {
+    return sim->hits() == dat->hits();
+  }
+};
+
+struct JemHitsPolicy {
+  bool empty(const LVL1::JEMHits* hits) const { return !hits->JetHits(); }
+  bool equal(const LVL1::JEMHits* sim, const LVL1::JEMHits* dat) const {
+    return sim->JetHits() == dat->JetHits();
+  }
+};
+
+struct JemEtSumsPolicy {
+  bool empty(const LVL1::JEMEtSums* sums) const {
+    return !sums->Et() && !sums->Ex() && !sums->Ey();
+  }
+  bool equal(const LVL1::JEMEtSums* sim, const LVL1::JEMEtSums* dat) const {
+    return sim->Et() == dat->Et() && sim->Ex() == dat->Ex() &&
+           sim->Ey() == dat->Ey();
+  }
+};
+
+}
+
 
 /*---------------------------------------------------------*/
 JEPSimBSMon::JEPSimBSMon(const std::string & type, 
@@ -56,8 +168,16 @@ JEPSimBSMon::JEPSimBSMon(const std::string & type,
     m_etSumsTool("LVL1::L1JEPEtSumsTools/L1JEPEtSumsTools"),
     m_errorTool("TrigT1CaloMonErrorTool"),
     m_histTool("TrigT1CaloLWHistogramTool"),
-    m_debug(false), m_rodTES(0), m_limitedRoi(0), m_versionSig(true),
-    m_histBooked(false),
+    m_errorBoard("TrigT1CaloErrorBoardTool"),
+    m_debug(false), m_upstreamOn(true), m_upstreamUsed(0), m_upstreamEvents(0),
+    m_upstreamChecked(0), m_upstreamDiffer(0), m_rodSummary(0),
+    m_histBooked(false), m_roiThreads(0), m_chainThreads(0),
+    m_jetChainTask(0), m_energySimTask(0), m_towersZ(0), m_intRois(0),
+    m_windowEngineOn(false), m_windowFallback(false), m_windowChecked(0),
+    m_windowDiffer(0), m_elementsNeeded(0), m_intRoisAll(0),
+    m_jetElementSim(0), m_jemRoiSim(0), m_jemHitsSim(0), m_cmmJetHitsSim(0),
+    m_jemEtSumsSim(0), m_cmmEtLocalSim(0), m_cmmEtTotalSim(0),
+    m_cmmSumEtSim(0),
     m_h_jem_em_2d_etaPhi_jetEl_SimEqCore(0),
     m_h_jem_em_2d_etaPhi_jetEl_SimNeCore(0),
     m_h_jem_em_2d_etaPhi_jetEl_SimNoCore(0),
@@ -151,14 +271,47 @@ JEPSimBSMon::JEPSimBSMon(const std::string & type,
 		                 LVL1::TrigT1CaloDefs::TriggerTowerLocation);
   declareProperty("RodHeaderLocation",
                  m_rodHeaderLocation = "RODHeaders");
+  declareProperty("SimJEMRoILocation", m_simJemRoiLocation = "",
+                  "Upstream JEM RoIs simulated from Jet Elements");
+  declareProperty("SimJEMEtSumsLocation", m_simJemEtSumsLocation = "",
+                  "Upstream JEM Et Sums simulated from Jet Elements");
+  declareProperty("UpstreamCheckEvents", m_upstreamCheckEvents = 100,
+                  "Events with upstream containers checked before reuse");
 
   declareProperty("RootDirectory", m_rootDir = "L1Calo");
+  declareProperty("LazyBooking", m_lazyBooking = false,
+                  "Only write mismatch histograms which are filled (offline)");
+  declareProperty("RoIThreads", m_roiThreads = 0,
+                  "Threads for per-crate RoI simulation, 0 or 1 for serial");
+  declareProperty("ChainThreads", m_chainThreads = 0,
+                  "Threads for concurrent jet/energy chains, 0 or 1 for serial");
+  declareProperty("JetWindowEngine", m_jetWindowEngine = true,
+                  "Find JEM RoIs only around summed-area table candidates");
+  declareProperty("JetWindowCheckEvents", m_jetWindowCheckEvents = 100,
+                  "Events with JEM RoIs also found from all Jet Elements");
 }
 
 /*---------------------------------------------------------*/
 JEPSimBSMon::~JEPSimBSMon()
 /*---------------------------------------------------------*/
 {
+  std::vector<CrateRoiTask*>::iterator it  = m_crateTasks.begin();
+  std::vector<CrateRoiTask*>::iterator itE = m_crateTasks.end();
+  for (; it != itE; ++it) delete *it;
+  delete m_jetChainTask;
+  delete m_energySimTask;
+  delete m_towersZ;
+  delete m_intRois;
+  delete m_elementsNeeded;
+  delete m_intRoisAll;
+  delete m_jetElementSim;
+  delete m_jemRoiSim;
+  delete m_jemHitsSim;
+  delete m_cmmJetHitsSim;
+  delete m_jemEtSumsSim;
+  delete m_cmmEtLocalSim;
+  delete m_cmmEtTotalSim;
+  delete m_cmmSumEtSim;
 }
 
 #ifndef PACKAGE_VERSION
@@ -190,6 +343,12 @@ StatusCode JEPSimBSMon:: initialize()
     msg(MSG::ERROR) << "Unable to locate Tool L1JetTools" << endreq;
     return sc;
   }
+  if (m_crateTasks.empty()) {
+    const int ncrates = 2;
+    for (int crate = 0; crate < ncrates; ++crate) {
+      m_crateTasks.push_back(new CrateRoiTask(&(*m_jetTool)));
+    }
+  }
 
   sc = m_jepHitsTool.retrieve();
   if( sc.isFailure() ) {
@@ -217,6 +376,72 @@ StatusCode JEPSimBSMon:: initialize()
     return sc;
   }
 
+  sc = m_errorBoard.retrieve();
+  if( sc.isFailure() ) {
+    msg(MSG::ERROR) << "Unable to locate Tool TrigT1CaloErrorBoardTool"
+                    << endreq;
+    return sc;
+  }
+
+  // Scratch collections reused every event
+  if (!m_towersZ) {
+    m_towersZ       = new TriggerTowerCollection(SG::VIEW_ELEMENTS);
+    m_intRois       = new InternalRoiCollection;
+    m_elementsNeeded = new JetElementCollection(SG::VIEW_ELEMENTS);
+    m_intRoisAll    = new InternalRoiCollection;
+    m_jetElementSim = new JetElementCollection;
+    m_jemRoiSim     = new JemRoiCollection(SG::VIEW_ELEMENTS);
+    m_jemHitsSim    = new JemHitsCollection;
+    m_cmmJetHitsSim = new CmmJetHitsCollection;
+    m_jemEtSumsSim  = new JemEtSumsCollection;
+    m_cmmEtLocalSim = new CmmEtSumsCollection;
+    m_cmmEtTotalSim = new CmmEtSumsCollection;
+    m_cmmSumEtSim   = new CmmEtSumsCollection;
+    m_jetChainTask  = new JetChainTask(this);
+    m_energySimTask = new EnergySimTask(this);
+  }
+
+  m_windowEngineOn = m_jetWindowEngine;
+
+  if (m_roiThreads > 1) {
+    const int nthreads = std::min(m_roiThreads, 2);
+    if (m_roiPool.start(nthreads)) {
+      msg(MSG::INFO) << "Per-crate RoI simulation using " << nthreads
+                     << " threads" << endreq;
+    } else {
+      msg(MSG::WARNING) << "Unable to start RoI simulation threads,"
+                        << " running serially" << endreq;
+    }
+  }
+  if (m_chainThreads > 1) {
+    if (m_chainPool.start(2)) {
+      msg(MSG::INFO) << "Jet and energy chains using 2 threads" << endreq;
+    } else {
+      msg(MSG::WARNING) << "Unable to start jet/energy chain thread,"
+                        << " running serially" << endreq;
+    }
+  }
+
+  return StatusCode::SUCCESS;
+}
+
+/*---------------------------------------------------------*/
+StatusCode JEPSimBSMon::finalize()
+/*---------------------------------------------------------*/
+{
+  m_chainPool.stop();
+  m_roiPool.stop();
+  if (!m_simJemRoiLocation.empty() || !m_simJemEtSumsLocation.empty()) {
+    msg(MSG::INFO) << "Upstream simulated containers used: "
+                   << m_upstreamUsed << endreq;
+    msg(MSG::INFO) << "Upstream simulated containers checked: "
+                   << m_upstreamChecked << " differing from local simulation: "
+		   << m_upstreamDiffer << endreq;
+  }
+  if (m_windowChecked) {
+    msg(MSG::INFO) << "Jet window engine RoIs checked in " << m_windowChecked
+                   << " events, differing in " << m_windowDiffer << endreq;
+  }
   return StatusCode::SUCCESS;
 }
 
@@ -541,6 +766,88 @@ StatusCode JEPSimBSMon::bookHistogramsRecurrent()
   m_v_2d_MismatchEvents[8] = hist;
 
   m_histTool->unsetMonGroup();
+
+  // Mismatch plots only written if filled
+
+  m_lazyHists.setup(m_lazyBooking &&
+                    m_environment != AthenaMonManager::online);
+  if (m_lazyHists.enabled()) {
+    std::vector<LWHist*> lazyElements;
+    lazyElements.push_back(m_h_jem_em_2d_etaPhi_jetEl_SimNeCore);
+    lazyElements.push_back(m_h_jem_em_2d_etaPhi_jetEl_SimNoCore);
+    lazyElements.push_back(m_h_jem_em_2d_etaPhi_jetEl_CoreNoSim);
+    lazyElements.push_back(m_h_jem_had_2d_etaPhi_jetEl_SimNeCore);
+    lazyElements.push_back(m_h_jem_had_2d_etaPhi_jetEl_SimNoCore);
+    lazyElements.push_back(m_h_jem_had_2d_etaPhi_jetEl_CoreNoSim);
+    lazyElements.push_back(m_h_jem_em_2d_etaPhi_jetEl_SimNeOverlap);
+    lazyElements.push_back(m_h_jem_em_2d_etaPhi_jetEl_SimNoOverlap);
+    lazyElements.push_back(m_h_jem_em_2d_etaPhi_jetEl_OverlapNoSim);
+    lazyElements.push_back(m_h_jem_had_2d_etaPhi_jetEl_SimNeOverlap);
+    lazyElements.push_back(m_h_jem_had_2d_etaPhi_jetEl_SimNoOverlap);
+    lazyElements.push_back(m_h_jem_had_2d_etaPhi_jetEl_OverlapNoSim);
+    std::vector<LWHist*> lazyRoIs;
+    lazyRoIs.push_back(m_h_jem_2d_roi_SimNeData);
+    lazyRoIs.push_back(m_h_jem_2d_roi_SimNoData);
+    lazyRoIs.push_back(m_h_jem_2d_roi_DataNoSim);
+    lazyRoIs.push_back(m_h_jem_2d_roi_ThreshSimNeData);
+    lazyRoIs.push_back(m_h_jem_2d_etaPhi_roi_SimNeData);
+    lazyRoIs.push_back(m_h_jem_2d_etaPhi_roi_SimNoData);
+    lazyRoIs.push_back(m_h_jem_2d_etaPhi_roi_DataNoSim);
+    std::vector<LWHist*> lazyHits;
+    lazyHits.push_back(m_h_jem_2d_thresh_SimNeData);
+    lazyHits.push_back(m_h_jem_2d_thresh_SimNoData);
+    lazyHits.push_back(m_h_jem_2d_thresh_DataNoSim);
+    lazyHits.push_back(m_h_jem_2d_thresh_ThreshSimNeData);
+    std::vector<LWHist*> lazyHits2;
+    lazyHits2.push_back(m_h_cmm_2d_thresh_JemNeCmm);
+    lazyHits2.push_back(m_h_cmm_2d_thresh_JemNoCmm);
+    lazyHits2.push_back(m_h_cmm_2d_thresh_CmmNoJem);
+    lazyHits2.push_back(m_h_cmm_2d_thresh_ThreshJemNeCmm);
+    std::vector<LWHist*> lazyHitSums;
+    lazyHitSums.push_back(m_h_cmm_1d_thresh_SumsSimNeData);
+    lazyHitSums.push_back(m_h_cmm_1d_thresh_SumsSimNoData);
+    lazyHitSums.push_back(m_h_cmm_1d_thresh_SumsDataNoSim);
+    lazyHitSums.push_back(m_h_cmm_2d_thresh_SumsThreshSimNeData);
+    std::vector<LWHist*> lazyEnergy;
+    lazyEnergy.push_back(m_h_jem_2d_energy_SimNeData);
+    lazyEnergy.push_back(m_h_jem_2d_energy_SimNoData);
+    lazyEnergy.push_back(m_h_jem_2d_energy_DataNoSim);
+    std::vector<LWHist*> lazyEnergy2;
+    lazyEnergy2.push_back(m_h_cmm_2d_energy_JemNeCmm);
+    lazyEnergy2.push_back(m_h_cmm_2d_energy_JemNoCmm);
+    lazyEnergy2.push_back(m_h_cmm_2d_energy_CmmNoJem);
+    std::vector<LWHist*> lazyEnergySums;
+    lazyEnergySums.push_back(m_h_cmm_2d_energy_SumsSimNeData);
+    lazyEnergySums.push_back(m_h_cmm_2d_energy_SumsSimNoData);
+    lazyEnergySums.push_back(m_h_cmm_2d_energy_SumsDataNoSim);
+    lazyEnergySums.push_back(m_h_cmm_2d_energy_EtMapsThreshSimNeData);
+    std::vector<LWHist*> lazyEvent1;
+    lazyEvent1.push_back(m_v_2d_MismatchEvents[0]);
+    lazyEvent1.push_back(m_v_2d_MismatchEvents[1]);
+    lazyEvent1.push_back(m_v_2d_MismatchEvents[2]);
+    lazyEvent1.push_back(m_v_2d_MismatchEvents[3]);
+    lazyEvent1.push_back(m_v_2d_MismatchEvents[5]);
+    std::vector<LWHist*> lazyEvent2;
+    lazyEvent2.push_back(m_v_2d_MismatchEvents[4]);
+    lazyEvent2.push_back(m_v_2d_MismatchEvents[6]);
+    lazyEvent2.push_back(m_v_2d_MismatchEvents[7]);
+    lazyEvent2.push_back(m_v_2d_MismatchEvents[8]);
+    StatusCode sc = m_lazyHists.defer(lazyElements, monElements);
+    if (sc.isSuccess()) sc = m_lazyHists.defer(lazyRoIs, monRoIs);
+    if (sc.isSuccess()) sc = m_lazyHists.defer(lazyHits, monHits);
+    if (sc.isSuccess()) sc = m_lazyHists.defer(lazyHits2, monHits2);
+    if (sc.isSuccess()) sc = m_lazyHists.defer(lazyHitSums, monHitSums);
+    if (sc.isSuccess()) sc = m_lazyHists.defer(lazyEnergy, monEnergy);
+    if (sc.isSuccess()) sc = m_lazyHists.defer(lazyEnergy2, monEnergy2);
+    if (sc.isSuccess()) sc = m_lazyHists.defer(lazyEnergySums, monEnergySums);
+    if (sc.isSuccess()) sc = m_lazyHists.defer(lazyEvent1, monEvent1);
+    if (sc.isSuccess()) sc = m_lazyHists.defer(lazyEvent2, monEvent2);
+    if (sc.isFailure()) {
+      msg(MSG::ERROR) << "Failed to deregister mismatch histograms" << endreq;
+      return sc;
+    }
+  }
+
   m_histBooked = true;
 
   } // end if (newRun ...
@@ -596,13 +903,10 @@ StatusCode JEPSimBSMon::fillHistograms()
     msg(MSG::DEBUG) << "No DAQ JEM RoIs container found" << endreq; 
   }
 
-  //Retrieve ROD Headers from SG
-  m_rodTES = 0;
-  m_limitedRoi = 0;
-  m_versionSig = true;
-  sc = evtStore()->retrieve( m_rodTES, m_rodHeaderLocation);
-  if( sc.isFailure()  ||  !m_rodTES ) {
-    msg(MSG::DEBUG) << "No ROD Header container found" << endreq;
+  //Retrieve decoded ROD Headers, shared with other tools
+  m_rodSummary = TrigT1CaloRodSummary::get(*evtStore(), m_rodHeaderLocation);
+  if ( !m_rodSummary ) {
+    msg(MSG::DEBUG) << "No ROD Header summary available" << endreq;
   }
   
   //Retrieve JEM Hits from SG
@@ -668,120 +972,86 @@ StatusCode JEPSimBSMon::fillHistograms()
   ErrorVector errorsJEM(vecsizeJem);
   ErrorVector errorsCMM(vecsizeCmm);
 
-  // Compare Jet Elements simulated from Trigger Towers with Jet Elements
-  // from data
-
-  JetElementCollection* jetElementSIM = 0;
-  if (triggerTowerTES) {
-    jetElementSIM = new JetElementCollection;
-    simulate(triggerTowerTES, jetElementSIM);
-  }
-  JetElementMap jeSimMap;
-  setupMap(jetElementSIM, jeSimMap);
-  bool overlap = false;
-  bool mismatchCore = false;
-  bool mismatchOverlap = false;
-  mismatchCore = compare(jeSimMap, jeMap, errorsJEM, overlap);
-  if (jetElementOvTES) {
-    overlap = true;
-    mismatchOverlap = compare(jeSimMap, ovMap, errorsJEM, overlap);
-  }
-  jeSimMap.clear();
-  delete jetElementSIM;
-
-  // Compare RoIs simulated from Jet Elements with JEM RoIs from data
-
-  JemRoiCollection* jemRoiSIM = 0;
-  if (jetElementTES || jetElementOvTES) {
-    jemRoiSIM = new JemRoiCollection;
-    if (mismatchCore || mismatchOverlap) {
-      simulate(jetElementTES, jetElementOvTES, jemRoiSIM);
-    } else {
-      simulate(jetElementTES, jemRoiSIM);
+  // The jet chain (Jet Elements, RoIs, JEM Hits, CMM-Jet Hits) and the
+  // energy simulation are independent so run them concurrently if a
+  // thread is available.  Energy comparisons follow when both are done.
+
+  JetChainInput jetInput;
+  jetInput.triggerTowers = triggerTowerTES;
+  jetInput.jetElements   = jetElementTES;
+  jetInput.jetElementsOv = jetElementOvTES;
+  jetInput.jemRois       = jemRoiTES;
+  jetInput.cmmJetHits    = cmmJetHitsTES;
+  jetInput.cmmRoi        = cmmRoiTES;
+  jetInput.upJemRois     = 0;
+  jetInput.jeMap = &jeMap;
+  jetInput.ovMap = &ovMap;
+  jetInput.jrMap = &jrMap;
+  jetInput.jhMap = &jhMap;
+  jetInput.cmMap = &cmMap;
+  jetInput.checkUpstream = false;
+  const JemEtSumsCollection* jemEtSumsUP = 0;
+  if (jetElementTES && m_upstreamOn) {
+    jetInput.upJemRois = upstreamSim<JemRoiCollection>(m_simJemRoiLocation);
+    jemEtSumsUP = upstreamSim<JemEtSumsCollection>(m_simJemEtSumsLocation);
+    if ((jetInput.upJemRois || jemEtSumsUP) &&
+        (m_debug || m_upstreamEvents < (unsigned long)m_upstreamCheckEvents)) {
+      jetInput.checkUpstream = true;
+      ++m_upstreamEvents;
     }
   }
-  JemRoiMap jrSimMap;
-  setupMap(jemRoiSIM, jrSimMap);
-  compare(jrSimMap, jrMap, errorsJEM);
-  jrSimMap.clear();
-  delete jemRoiSIM;
-
-  // Compare JEM Hits simulated from JEM RoIs with JEM Hits from data
-
-  JemHitsCollection* jemHitsSIM = 0;
-  if (jemRoiTES) {
-    jemHitsSIM = new JemHitsCollection;
-    simulate(jemRoiTES, jemHitsSIM);
+  m_jetChainTask->set(&jetInput, &errorsJEM, &errorsCMM);
+  // Upstream Et Sums being checked are also simulated here
+  m_energySimTask->set((jemEtSumsUP && !jetInput.checkUpstream)
+                                   ? 0 : jetElementTES, cmmEtSumsTES);
+  if (m_chainPool.workers() > 0 && !m_debug) {
+    std::vector<TrigT1CaloTaskPool::Task*> tasks;
+    tasks.push_back(m_jetChainTask);
+    tasks.push_back(m_energySimTask);
+    if (!m_chainPool.run(tasks)) {
+      msg(MSG::ERROR) << "Exception in jet/energy chain" << endreq;
+      m_jetElementSim->clear();
+      m_jemRoiSim->clear();
+      m_roiObjects.release();
+      m_jemHitsSim->clear();
+      m_cmmJetHitsSim->clear();
+      m_jemEtSumsSim->clear();
+      m_cmmEtLocalSim->clear();
+      m_cmmEtTotalSim->clear();
+      m_cmmSumEtSim->clear();
+      return StatusCode::FAILURE;
+    }
+  } else {
+    m_jetChainTask->execute();
+    m_energySimTask->execute();
   }
-  JemHitsMap jhSimMap;
-  setupMap(jemHitsSIM, jhSimMap);
-  compare(jhSimMap, jhMap, errorsJEM);
-  jhSimMap.clear();
-  delete jemHitsSIM;
-
-  // Compare JEM hits with CMM Hits from data
-
-  compare(jhMap, cmMap, errorsJEM, errorsCMM);
-
-  // Compare Local sums simulated from CMM Hits with Local sums from data
-
-  CmmJetHitsCollection* cmmLocalSIM = 0;
-  if (cmmJetHitsTES) {
-    cmmLocalSIM = new CmmJetHitsCollection;
-    simulate(cmmJetHitsTES, cmmLocalSIM, LVL1::CMMJetHits::LOCAL_MAIN);
+  if (m_windowFallback) {
+    msg(MSG::WARNING) << "Jet window engine RoIs differ from RoIs found"
+                      << " from all Jet Elements, engine switched off"
+		      << endreq;
+    m_windowFallback = false;
   }
-  CmmJetHitsMap cmmLocalSimMap;
-  setupMap(cmmLocalSIM, cmmLocalSimMap);
-  compare(cmmLocalSimMap, cmMap, errorsCMM, LVL1::CMMJetHits::LOCAL_MAIN);
-  cmmLocalSimMap.clear();
-  delete cmmLocalSIM;
-
-  // Compare Local sums with Remote sums from data
-
-  compare(cmMap, cmMap, errorsCMM, LVL1::CMMJetHits::REMOTE_MAIN);
-
-  // Compare Total sums simulated from Remote sums with Total sums from data
-
-  CmmJetHitsCollection* cmmTotalSIM = 0;
-  if (cmmJetHitsTES) {
-    cmmTotalSIM = new CmmJetHitsCollection;
-    simulate(cmmJetHitsTES, cmmTotalSIM, LVL1::CMMJetHits::TOTAL_MAIN);
+  if (jemEtSumsUP && jetInput.checkUpstream) {
+    checkUpstream(jemEtSumsUP);
+    jemEtSumsUP = 0;
   }
-  CmmJetHitsMap cmmTotalSimMap;
-  setupMap(cmmTotalSIM, cmmTotalSimMap);
-  compare(cmmTotalSimMap, cmMap, errorsCMM, LVL1::CMMJetHits::TOTAL_MAIN);
-  cmmTotalSimMap.clear();
-  delete cmmTotalSIM;
-
-  // Compare JetEt Map simulated from Total sums with JetEt Map from data
-
-  CmmJetHitsCollection* cmmJetEtSIM = 0;
-  if (cmmJetHitsTES) {
-    cmmJetEtSIM = new CmmJetHitsCollection;
-    simulate(cmmJetHitsTES, cmmJetEtSIM, LVL1::CMMJetHits::ET_MAP);
+  if (m_upstreamDiffer && m_upstreamOn) {
+    msg(MSG::WARNING) << "Upstream simulated containers differ from local"
+                      << " simulation, simulating locally from now on"
+		      << endreq;
+    m_upstreamOn = false;
   }
-  CmmJetHitsMap cmmJetEtSimMap;
-  setupMap(cmmJetEtSIM, cmmJetEtSimMap);
-  compare(cmmJetEtSimMap, cmMap, errorsCMM, LVL1::CMMJetHits::ET_MAP);
-  cmmJetEtSimMap.clear();
-  delete cmmJetEtSIM;
-
-  // Compare JetEt Map with JetEt RoI from data
-
-  compare(cmMap, cmmRoiTES, errorsCMM);
+  if (m_jetChainTask->upstreamRois()) ++m_upstreamUsed;
+  if (jemEtSumsUP)                    ++m_upstreamUsed;
 
   // Compare JEMEtSums simulated from JetElements with JEMEtSums from data
 
-  JemEtSumsCollection* jemEtSumsSIM = 0;
-  if (jetElementTES) {
-    jemEtSumsSIM = new JemEtSumsCollection;
-    simulate(jetElementTES, jemEtSumsSIM);
-  }
   JemEtSumsMap jemEtSumsSimMap;
-  setupMap(jemEtSumsSIM, jemEtSumsSimMap);
+  if (jemEtSumsUP) setupMap(jemEtSumsUP, jemEtSumsSimMap);
+  else             setupMap(m_jemEtSumsSim, jemEtSumsSimMap);
   compare(jemEtSumsSimMap, jsMap, errorsJEM);
   jemEtSumsSimMap.clear();
-  delete jemEtSumsSIM;
+  m_jemEtSumsSim->clear();
 
   // Compare JEMEtSums with CMMEtSums from data
 
@@ -789,16 +1059,11 @@ StatusCode JEPSimBSMon::fillHistograms()
 
   // Compare Local sums simulated from CMMEtSums with Local sums from data
 
-  CmmEtSumsCollection* cmmEtLocalSIM = 0;
-  if (cmmEtSumsTES) {
-    cmmEtLocalSIM = new CmmEtSumsCollection;
-    simulate(cmmEtSumsTES, cmmEtLocalSIM, LVL1::CMMEtSums::LOCAL);
-  }
   CmmEtSumsMap cmmEtLocalSimMap;
-  setupMap(cmmEtLocalSIM, cmmEtLocalSimMap);
+  setupMap(m_cmmEtLocalSim, cmmEtLocalSimMap);
   compare(cmmEtLocalSimMap, csMap, errorsCMM, LVL1::CMMEtSums::LOCAL);
   cmmEtLocalSimMap.clear();
-  delete cmmEtLocalSIM;
+  m_cmmEtLocalSim->clear();
 
   // Compare Local Energy sums with Remote sums from data
 
@@ -806,30 +1071,20 @@ StatusCode JEPSimBSMon::fillHistograms()
 
   // Compare Total sums simulated from Remote sums with Total sums from data
 
-  CmmEtSumsCollection* cmmEtTotalSIM = 0;
-  if (cmmEtSumsTES) {
-    cmmEtTotalSIM = new CmmEtSumsCollection;
-    simulate(cmmEtSumsTES, cmmEtTotalSIM, LVL1::CMMEtSums::TOTAL);
-  }
   CmmEtSumsMap cmmEtTotalSimMap;
-  setupMap(cmmEtTotalSIM, cmmEtTotalSimMap);
+  setupMap(m_cmmEtTotalSim, cmmEtTotalSimMap);
   compare(cmmEtTotalSimMap, csMap, errorsCMM, LVL1::CMMEtSums::TOTAL);
   cmmEtTotalSimMap.clear();
-  delete cmmEtTotalSIM;
+  m_cmmEtTotalSim->clear();
 
   // Compare Et Maps (sumEt/missingEt/missingEtSig) simulated from Total sums
   // with Et Maps from data
 
-  CmmEtSumsCollection* cmmSumEtSIM = 0;
-  if (cmmEtSumsTES) {
-    cmmSumEtSIM = new CmmEtSumsCollection;
-    simulate(cmmEtSumsTES, cmmSumEtSIM, LVL1::CMMEtSums::SUM_ET_MAP);
-  }
   CmmEtSumsMap cmmSumEtSimMap;
-  setupMap(cmmSumEtSIM, cmmSumEtSimMap);
+  setupMap(m_cmmSumEtSim, cmmSumEtSimMap);
   compare(cmmSumEtSimMap, csMap, errorsCMM, LVL1::CMMEtSums::SUM_ET_MAP);
   cmmSumEtSimMap.clear();
-  delete cmmSumEtSIM;
+  m_cmmSumEtSim->clear();
 
   // Compare Total Energy sums and Et Maps with Energy RoIs from data
 
@@ -869,13 +1124,7 @@ StatusCode JEPSimBSMon::fillHistograms()
 
   // Save error vector for global summary
 
-  ErrorVector* save = new ErrorVector(crateErr);
-  sc = evtStore()->record(save, "L1CaloJEMMismatchVector");
-  if (sc != StatusCode::SUCCESS) {
-    msg(MSG::ERROR) << "Error recording JEM mismatch vector in TES "
-                    << endreq;
-    return sc;
-  }
+  m_errorBoard->set(TrigT1CaloErrorBoardTool::JEMMismatch, crateErr);
 
   if (m_debug) msg(MSG::DEBUG) << "Leaving fillHistograms" << endreq;
 
@@ -891,6 +1140,18 @@ StatusCode JEPSimBSMon::procHistograms()
   if (endOfLumiBlock || endOfRun) {
   }
 
+  if (endOfRun && m_lazyHists.enabled()) {
+    int registered = 0;
+    int dropped    = 0;
+    StatusCode sc = m_lazyHists.registerFilled(registered, dropped);
+    if (sc.isFailure()) {
+      msg(MSG::ERROR) << "Failed to register mismatch histograms" << endreq;
+      return sc;
+    }
+    msg(MSG::DEBUG) << "Mismatch histograms written: " << registered
+                    << " omitted: " << dropped << endreq;
+  }
+
   return StatusCode::SUCCESS;
 }
 
@@ -906,6 +1167,44 @@ bool JEPSimBSMon::compare(const JetElementMap& jeSimMap,
 
   bool mismatch = false;
 
+  // All match - fill match plots only
+
+  if (TrigT1CaloMapCompare::agree(jeSimMap, jeMap, JetElementPolicy())) {
+    LVL1::CoordToHardware converter;
+    const int bitEm  = (1 << EMElementMismatch);
+    const int bitHad = (1 << HadElementMismatch);
+    TH2F_LW* hist1 = (overlap) ? m_h_jem_em_2d_etaPhi_jetEl_SimEqOverlap
+                               : m_h_jem_em_2d_etaPhi_jetEl_SimEqCore;
+    TH2F_LW* hist2 = (overlap) ? m_h_jem_had_2d_etaPhi_jetEl_SimEqOverlap
+                               : m_h_jem_had_2d_etaPhi_jetEl_SimEqCore;
+    JetElementMap::const_iterator iter  = jeMap.begin();
+    JetElementMap::const_iterator iterE = jeMap.end();
+    for (; iter != iterE; ++iter) {
+      const LVL1::JetElement* je = iter->second;
+      const int em  = je->emEnergy();
+      const int had = je->hadEnergy();
+      if (!em && !had) continue;
+      const double eta = je->eta();
+      const double phi = je->phi();
+      const LVL1::Coordinate coord(phi, eta);
+      const int crate = (overlap) ? converter.jepCrateOverlap(coord)
+                                  : converter.jepCrate(coord);
+      const int jem   = (overlap) ? converter.jepModuleOverlap(coord)
+                                  : converter.jepModule(coord);
+      if (crate > 1 || jem > 15) continue;
+      const int loc = crate * 16 + jem;
+      if (em) {
+        errors[loc] |= bitEm;
+        m_histTool->fillJEMEtaVsPhi(hist1, eta, phi);
+      }
+      if (had) {
+        errors[loc] |= bitHad;
+        m_histTool->fillJEMEtaVsPhi(hist2, eta, phi);
+      }
+    }
+    return mismatch;
+  }
+
   JetElementMap::const_iterator simMapIter    = jeSimMap.begin();
   JetElementMap::const_iterator simMapIterEnd = jeSimMap.end();
   JetElementMap::const_iterator datMapIter    = jeMap.begin();
@@ -1033,6 +1332,39 @@ void JEPSimBSMon::compare(const JemRoiMap& roiSimMap,
   const int nCrates = 2;
   const int nJEMs = 16;
   LVL1::JEPRoIDecoder decoder;
+
+  // All match - fill match plots only
+
+  if (TrigT1CaloMapCompare::agree(roiSimMap, roiMap, JemRoiPolicy())) {
+    JemRoiMap::const_iterator iter  = roiMap.begin();
+    JemRoiMap::const_iterator iterE = roiMap.end();
+    for (; iter != iterE; ++iter) {
+      const LVL1::JEMRoI* roi = iter->second;
+      const unsigned int hits = roi->hits();
+      if (!hits) continue;
+      const int crate   = roi->crate();
+      const int jem     = roi->jem();
+      const int frame   = roi->frame();
+      const int local   = roi->location();
+      const int forward = roi->forward();
+      const int locX    = crate * nJEMs + jem;
+      const int locY    = frame * 4 + local;
+      const LVL1::CoordinateRange coord(decoder.coordinate(roi->roiWord()));
+      double eta = coord.eta();
+      // Distinguish right forward columns 3 and 4 for checking purposes
+      if (forward && eta > 0.0 && frame > 3) eta = (local%2) ? 4.05 : 3.2;
+      const double phi = coord.phi();
+      errors[locX] |= (1 << RoIMismatch);
+      m_h_jem_2d_roi_SimEqData->Fill(locX, locY);
+      m_histTool->fillJEMRoIEtaVsPhi(m_h_jem_2d_etaPhi_roi_SimEqData, eta, phi);
+      const int nThresh = (forward) ? 4 : 8;
+      const int offset  = (forward) ? ((eta < 0.) ? 8 : 12) : 0;
+      m_histTool->fillXVsThresholds(m_h_jem_2d_roi_ThreshSimEqData, locX,
+                                    hits, nThresh, 1, offset);
+    }
+    return;
+  }
+
   JemRoiMap::const_iterator simMapIter    = roiSimMap.begin();
   JemRoiMap::const_iterator simMapIterEnd = roiSimMap.end();
   JemRoiMap::const_iterator datMapIter    = roiMap.begin();
@@ -1182,6 +1514,39 @@ void JEPSimBSMon::compare(const JemHitsMap& jemSimMap,
     msg(MSG::DEBUG) << "Compare simulated JEM Hits with data" << endreq;
   }
 
+  // All match - fill match plots only
+
+  if (TrigT1CaloMapCompare::agree(jemSimMap, jemMap, JemHitsPolicy())) {
+    JemHitsMap::const_iterator iter  = jemMap.begin();
+    JemHitsMap::const_iterator iterE = jemMap.end();
+    for (; iter != iterE; ++iter) {
+      const LVL1::JEMHits* jh = iter->second;
+      const unsigned int hits = jh->JetHits();
+      if (!hits) continue;
+      const int crate = jh->crate();
+      const int jem   = jh->module();
+      const int loc   = crate * 16 + jem;
+      errors[loc] |= (1 << JEMHitsMismatch);
+      m_h_jem_2d_thresh_SimEqData->Fill(jem, crate);
+      const bool forward = (jem == 0 || jem == 7 || jem == 8 || jem == 15);
+      const int thrLen = (forward) ? 2 : 3;
+      int nThresh = 8;
+      int same = m_histTool->thresholdsSame(hits, hits, nThresh, thrLen);
+      m_histTool->fillXVsThresholds(m_h_jem_2d_thresh_ThreshSimEqData, loc,
+                                                         same, nThresh, 1);
+      if (forward) {
+        const int shift = nThresh*thrLen;
+        nThresh = 4;
+        same = m_histTool->thresholdsSame(hits>>shift, hits>>shift,
+                                                         nThresh, thrLen);
+        const int offset = (jem == 7 || jem == 15) ? 12 : 8;
+        m_histTool->fillXVsThresholds(m_h_jem_2d_thresh_ThreshSimEqData, loc,
+                                                 same, nThresh, 1, offset);
+      }
+    }
+    return;
+  }
+
   JemHitsMap::const_iterator simMapIter    = jemSimMap.begin();
   JemHitsMap::const_iterator simMapIterEnd = jemSimMap.end();
   JemHitsMap::const_iterator datMapIter    = jemMap.begin();
@@ -1652,6 +2017,26 @@ void JEPSimBSMon::compare(const JemEtSumsMap& jemSimMap,
   if (m_debug) msg(MSG::DEBUG) << "Compare simulated JEM Et Sums with data"
                                << endreq;
 
+  // All match - fill match plots only
+
+  if (TrigT1CaloMapCompare::agree(jemSimMap, jemMap, JemEtSumsPolicy())) {
+    JemEtSumsMap::const_iterator iter  = jemMap.begin();
+    JemEtSumsMap::const_iterator iterE = jemMap.end();
+    for (; iter != iterE; ++iter) {
+      const LVL1::JEMEtSums* sums = iter->second;
+      const unsigned int et = sums->Et();
+      const unsigned int ex = sums->Ex();
+      const unsigned int ey = sums->Ey();
+      if (!et && !ex && !ey) continue;
+      const int loc = sums->crate() * 16 + sums->module();
+      errors[loc] |= (1 << JEMEtSumsMismatch);
+      if (ex) m_h_jem_2d_energy_SimEqData->Fill(loc, 0);
+      if (ey) m_h_jem_2d_energy_SimEqData->Fill(loc, 1);
+      if (et) m_h_jem_2d_energy_SimEqData->Fill(loc, 2);
+    }
+    return;
+  }
+
   JemEtSumsMap::const_iterator simMapIter    = jemSimMap.begin();
   JemEtSumsMap::const_iterator simMapIterEnd = jemSimMap.end();
   JemEtSumsMap::const_iterator datMapIter    = jemMap.begin();
@@ -2493,20 +2878,19 @@ void JEPSimBSMon::simulate(const TriggerTowerCollection* towers,
 
   // Make zero-suppressed collection to speed up simulation
 
-  TriggerTowerCollection* towersZ =
-                              new TriggerTowerCollection(SG::VIEW_ELEMENTS);
+  m_towersZ->clear();
   TriggerTowerCollection::const_iterator pos  = towers->begin();
   TriggerTowerCollection::const_iterator posE = towers->end();
   for (; pos != posE; ++pos) {
     if ((*pos)->emEnergy() > 0 || (*pos)->hadEnergy() > 0) {
-      towersZ->push_back(*pos);
+      m_towersZ->push_back(*pos);
     }
   }
-  m_jetElementTool->makeJetElements(towersZ, elements);
-  delete towersZ;
+  m_jetElementTool->makeJetElements(m_towersZ, elements);
+  m_towersZ->clear();
 }
 
-void JEPSimBSMon::simulate(const JetElementCollection* elements,
+bool JEPSimBSMon::simulate(const JetElementCollection* elements,
                            const JetElementCollection* elementsOv,
                                  JemRoiCollection* rois)
 {
@@ -2518,7 +2902,7 @@ void JEPSimBSMon::simulate(const JetElementCollection* elements,
   const int ncrates = 2;
   std::vector<JetElementCollection*> crateColl;
   for (int crate = 0; crate < ncrates; ++crate) {
-    crateColl.push_back(new JetElementCollection(SG::VIEW_ELEMENTS));
+    crateColl.push_back(m_crateTasks[crate]->elements());
   }
   LVL1::CoordToHardware converter;
   JetElementCollection::const_iterator iter;
@@ -2552,19 +2936,40 @@ void JEPSimBSMon::simulate(const JetElementCollection* elements,
       if (crate < ncrates) crateColl[crate]->push_back(je);
     }
   }
+  // Find RoIs for each crate, in parallel if threads available and
+  // no debug output, then merge in crate order
+  std::vector<TrigT1CaloTaskPool::Task*> tasks(m_crateTasks.begin(),
+                                               m_crateTasks.end());
+  bool ok = true;
+  if (m_roiPool.workers() > 0 && !m_debug) ok = m_roiPool.run(tasks);
+  else {
+    for (int crate = 0; crate < ncrates; ++crate) tasks[crate]->execute();
+  }
+  if (!ok) {
+    msg(MSG::ERROR) << "Exception in per-crate RoI simulation,"
+                    << " RoIs not compared" << endreq;
+    for (int crate = 0; crate < ncrates; ++crate) {
+      m_crateTasks[crate]->rois()->clear();
+      crateColl[crate]->clear();
+    }
+    return false;
+  }
   for (int crate = 0; crate < ncrates; ++crate) {
-    InternalRoiCollection* intRois = new InternalRoiCollection;
-    m_jetTool->findRoIs(crateColl[crate], intRois);
+    InternalRoiCollection* intRois = m_crateTasks[crate]->rois();
     InternalRoiCollection::iterator roiIter  = intRois->begin();
     InternalRoiCollection::iterator roiIterE = intRois->end();
     for (; roiIter != roiIterE; ++roiIter) {
-      LVL1::JEMRoI* roi = new LVL1::JEMRoI((*roiIter)->RoIWord());
-      if (roi->crate() == crate) rois->push_back(roi);
-      else delete roi;
+      const LVL1::JEMRoI roi((*roiIter)->RoIWord());
+      if (roi.crate() == crate) {
+        LVL1::JEMRoI* simRoi = m_roiObjects.get();
+        *simRoi = roi;
+        rois->push_back(simRoi);
+      }
     }
-    delete intRois;
-    delete crateColl[crate];
+    intRois->clear();
+    crateColl[crate]->clear();
   }
+  return true;
 }
 
 // Quicker version when core and overlap the same
@@ -2576,15 +2981,92 @@ void JEPSimBSMon::simulate(const JetElementCollection* elements,
     msg(MSG::DEBUG) << "Simulate JEM RoIs from Jet Elements" << endreq;
   }
 
-  InternalRoiCollection* intRois = new InternalRoiCollection;
-  m_jetTool->findRoIs(elements, intRois);
-  InternalRoiCollection::iterator roiIter  = intRois->begin();
-  InternalRoiCollection::iterator roiIterE = intRois->end();
+  // Use window engine candidates if possible, checking against RoIs
+  // found from all Jet Elements for the first events
+
+  const InternalRoiCollection* intRois = m_intRois;
+  bool useMarked = false;
+  if (m_windowEngineOn && findRoIsNeeded(elements)) {
+    useMarked = true;
+    if (m_debug || m_windowChecked < (unsigned long)m_jetWindowCheckEvents) {
+      m_jetTool->findRoIs(elements, m_intRoisAll);
+      ++m_windowChecked;
+      if (!sameRois(m_intRois, m_intRoisAll)) {
+        ++m_windowDiffer;
+        m_windowEngineOn = false;
+        m_windowFallback = true;
+      }
+      intRois = m_intRoisAll;
+      useMarked = false;
+    }
+  } else m_jetTool->findRoIs(elements, m_intRois);
+  InternalRoiCollection::const_iterator roiIter  = intRois->begin();
+  InternalRoiCollection::const_iterator roiIterE = intRois->end();
   for (; roiIter != roiIterE; ++roiIter) {
-    LVL1::JEMRoI* roi = new LVL1::JEMRoI((*roiIter)->RoIWord());
+    if (useMarked && !marked(*roiIter)) continue;
+    LVL1::JEMRoI* roi = m_roiObjects.get();
+    *roi = LVL1::JEMRoI((*roiIter)->RoIWord());
     rois->push_back(roi);
   }
-  delete intRois;
+  m_intRois->clear();
+  m_intRoisAll->clear();
+}
+
+// Fill window engine and find RoIs from the Jet Elements it needs
+
+bool JEPSimBSMon::findRoIsNeeded(const JetElementCollection* elements)
+{
+  m_windowEngine.clear();
+  JetElementCollection::const_iterator iter  = elements->begin();
+  JetElementCollection::const_iterator iterE = elements->end();
+  for (; iter != iterE; ++iter) {
+    LVL1::JetElement* je = *iter;
+    const int eta = TrigT1CaloJetWindowEngine::etaIndex(je->eta());
+    const int phi = TrigT1CaloJetWindowEngine::phiIndex(je->phi());
+    if (!m_windowEngine.add(eta, phi, je->energy())) return false;
+  }
+  m_windowEngine.process();
+  if (m_windowEngine.candidates() == 0) return true;
+  m_elementsNeeded->clear();
+  for (iter = elements->begin(); iter != iterE; ++iter) {
+    LVL1::JetElement* je = *iter;
+    const int eta = TrigT1CaloJetWindowEngine::etaIndex(je->eta());
+    const int phi = TrigT1CaloJetWindowEngine::phiIndex(je->phi());
+    if (m_windowEngine.needed(eta, phi)) m_elementsNeeded->push_back(*iter);
+  }
+  m_jetTool->findRoIs(m_elementsNeeded, m_intRois);
+  m_elementsNeeded->clear();
+  return true;
+}
+
+// RoIs not referenced at a marked Jet Element may be artefacts of the
+// reduced input.  Keep any which cannot be placed on the grid.
+
+bool JEPSimBSMon::marked(LVL1::JetAlgorithm* roi) const
+{
+  const int eta = TrigT1CaloJetWindowEngine::etaIndex(roi->eta());
+  const int phi = TrigT1CaloJetWindowEngine::phiIndex(roi->phi());
+  return (eta < 0) || m_windowEngine.marked(eta, phi);
+}
+
+// Compare RoI words of marked RoIs with those from all Jet Elements
+
+bool JEPSimBSMon::sameRois(const InternalRoiCollection* rois,
+                           const InternalRoiCollection* allRois) const
+{
+  std::vector<unsigned int> words;
+  std::vector<unsigned int> allWords;
+  InternalRoiCollection::const_iterator iter  = rois->begin();
+  InternalRoiCollection::const_iterator iterE = rois->end();
+  for (; iter != iterE; ++iter) {
+    if (marked(*iter)) words.push_back((*iter)->RoIWord());
+  }
+  iter  = allRois->begin();
+  iterE = allRois->end();
+  for (; iter != iterE; ++iter) allWords.push_back((*iter)->RoIWord());
+  std::sort(words.begin(), words.end());
+  std::sort(allWords.begin(), allWords.end());
+  return words == allWords;
 }
 
 void JEPSimBSMon::simulate(const JemRoiCollection* rois,
@@ -2638,42 +3120,209 @@ void JEPSimBSMon::simulate(const CmmEtSumsCollection* sumsIn,
   }
 }
 
+// Jet chain: Jet Elements, RoIs, JEM Hits and CMM-Jet Hits
+
+bool JEPSimBSMon::compareJetChain(const JetChainInput& in,
+                                  ErrorVector& errorsJEM,
+                                  ErrorVector& errorsCMM)
+{
+  // Compare Jet Elements simulated from Trigger Towers with Jet Elements
+  // from data
+
+  JetElementCollection* jetElementSIM = 0;
+  if (in.triggerTowers) {
+    jetElementSIM = m_jetElementSim;
+    simulate(in.triggerTowers, jetElementSIM);
+  }
+  JetElementMap jeSimMap;
+  setupMap(jetElementSIM, jeSimMap);
+  bool overlap = false;
+  bool mismatchCore = false;
+  bool mismatchOverlap = false;
+  mismatchCore = compare(jeSimMap, *in.jeMap, errorsJEM, overlap);
+  if (in.jetElementsOv) {
+    overlap = true;
+    mismatchOverlap = compare(jeSimMap, *in.ovMap, errorsJEM, overlap);
+  }
+  jeSimMap.clear();
+  m_jetElementSim->clear();
+
+  // Compare RoIs simulated from Jet Elements with JEM RoIs from data
+
+  JemRoiCollection* jemRoiSIM = 0;
+  const JemRoiCollection* jemRoiUP = 0;
+  bool roisOk = true;
+  if (in.jetElements || in.jetElementsOv) {
+    if (mismatchCore || mismatchOverlap) {
+      jemRoiSIM = m_jemRoiSim;
+      roisOk = simulate(in.jetElements, in.jetElementsOv, jemRoiSIM);
+    } else {
+      jemRoiUP = in.upJemRois;
+      if (!jemRoiUP || in.checkUpstream) {
+        jemRoiSIM = m_jemRoiSim;
+        simulate(in.jetElements, jemRoiSIM);
+        if (jemRoiUP) checkUpstream(jemRoiUP, jemRoiSIM);
+        jemRoiUP = 0;
+      }
+    }
+  }
+  if (roisOk) {
+    JemRoiMap jrSimMap;
+    if (jemRoiUP) setupMap(jemRoiUP, jrSimMap);
+    else          setupMap(jemRoiSIM, jrSimMap);
+    compare(jrSimMap, *in.jrMap, errorsJEM);
+  }
+  m_jemRoiSim->clear();
+  m_roiObjects.release();
+
+  // Compare JEM Hits simulated from JEM RoIs with JEM Hits from data
+
+  JemHitsCollection* jemHitsSIM = 0;
+  if (in.jemRois) {
+    jemHitsSIM = m_jemHitsSim;
+    simulate(in.jemRois, jemHitsSIM);
+  }
+  JemHitsMap jhSimMap;
+  setupMap(jemHitsSIM, jhSimMap);
+  compare(jhSimMap, *in.jhMap, errorsJEM);
+  jhSimMap.clear();
+  m_jemHitsSim->clear();
+
+  // Compare JEM hits with CMM Hits from data
+
+  compare(*in.jhMap, *in.cmMap, errorsJEM, errorsCMM);
+
+  // Compare Local sums simulated from CMM Hits with Local sums from data
+
+  CmmJetHitsCollection* cmmLocalSIM = 0;
+  if (in.cmmJetHits) {
+    cmmLocalSIM = m_cmmJetHitsSim;
+    simulate(in.cmmJetHits, cmmLocalSIM, LVL1::CMMJetHits::LOCAL_MAIN);
+  }
+  CmmJetHitsMap cmmLocalSimMap;
+  setupMap(cmmLocalSIM, cmmLocalSimMap);
+  compare(cmmLocalSimMap, *in.cmMap, errorsCMM, LVL1::CMMJetHits::LOCAL_MAIN);
+  cmmLocalSimMap.clear();
+  m_cmmJetHitsSim->clear();
+
+  // Compare Local sums with Remote sums from data
+
+  compare(*in.cmMap, *in.cmMap, errorsCMM, LVL1::CMMJetHits::REMOTE_MAIN);
+
+  // Compare Total sums simulated from Remote sums with Total sums from data
+
+  CmmJetHitsCollection* cmmTotalSIM = 0;
+  if (in.cmmJetHits) {
+    cmmTotalSIM = m_cmmJetHitsSim;
+    simulate(in.cmmJetHits, cmmTotalSIM, LVL1::CMMJetHits::TOTAL_MAIN);
+  }
+  CmmJetHitsMap cmmTotalSimMap;
+  setupMap(cmmTotalSIM, cmmTotalSimMap);
+  compare(cmmTotalSimMap, *in.cmMap, errorsCMM, LVL1::CMMJetHits::TOTAL_MAIN);
+  cmmTotalSimMap.clear();
+  m_cmmJetHitsSim->clear();
+
+  // Compare JetEt Map simulated from Total sums with JetEt Map from data
+
+  CmmJetHitsCollection* cmmJetEtSIM = 0;
+  if (in.cmmJetHits) {
+    cmmJetEtSIM = m_cmmJetHitsSim;
+    simulate(in.cmmJetHits, cmmJetEtSIM, LVL1::CMMJetHits::ET_MAP);
+  }
+  CmmJetHitsMap cmmJetEtSimMap;
+  setupMap(cmmJetEtSIM, cmmJetEtSimMap);
+  compare(cmmJetEtSimMap, *in.cmMap, errorsCMM, LVL1::CMMJetHits::ET_MAP);
+  cmmJetEtSimMap.clear();
+  m_cmmJetHitsSim->clear();
+
+  // Compare JetEt Map with JetEt RoI from data
+
+  compare(*in.cmMap, in.cmmRoi, errorsCMM);
+
+  return jemRoiUP != 0;
+}
+
+// Energy chain simulation, compared later in fillHistograms
+
+void JEPSimBSMon::simulateEnergyChain(const JetElementCollection* elements,
+                                      const CmmEtSumsCollection*  sums)
+{
+  if (elements) simulate(elements, m_jemEtSumsSim);
+  if (sums) {
+    simulate(sums, m_cmmEtLocalSim, LVL1::CMMEtSums::LOCAL);
+    simulate(sums, m_cmmEtTotalSim, LVL1::CMMEtSums::TOTAL);
+    simulate(sums, m_cmmSumEtSim,   LVL1::CMMEtSums::SUM_ET_MAP);
+  }
+}
+
 // Check if LimitedRoISet bit set
 
 bool JEPSimBSMon::limitedRoiSet(int crate)
 {
-  if (m_rodTES) loadRodHeaders();
-  return (((m_limitedRoi>>crate)&0x1) == 1);
+  // JEP crates are ROD crates 12-13
+  return (m_rodSummary && m_rodSummary->limitedRoI(crate + 12));
 }
 
 // Return true if version with Missing-Et-Sig
 
 bool JEPSimBSMon::hasMissingEtSig()
 {
-  if (m_rodTES) loadRodHeaders();
-  return m_versionSig;
+  bool versionSig = true;
+  if (m_rodSummary) {
+    for (int crate = 12; crate < 14; ++crate) {
+      const int version = m_rodSummary->roiMinorVersion(crate);
+      if (version >= 0) versionSig = (version >= 0x1003);
+    }
+  }
+  return versionSig;
 }
 
-// Load ROD Headers
+// Compare upstream RoIs with RoIs simulated here from the same Jet Elements
 
-void JEPSimBSMon::loadRodHeaders()
+void JEPSimBSMon::checkUpstream(const JemRoiCollection* rois,
+                                const JemRoiCollection* simRois)
 {
-  if (m_rodTES) {
-    m_limitedRoi = 0;
-    m_versionSig = true;
-    const int nCrates = 2;
-    RodHeaderCollection::const_iterator rodIter  = m_rodTES->begin();
-    RodHeaderCollection::const_iterator rodIterE = m_rodTES->end();
-    for (; rodIter != rodIterE; ++rodIter) {
-      const LVL1::RODHeader* rod = *rodIter;
-      const int rodCrate = rod->crate() - 12;
-      if (rodCrate >= 0 && rodCrate < nCrates && rod->dataType() == 1) {
-        if (rod->limitedRoISet()) {
-          m_limitedRoi |= (1<<rodCrate);
-        }
-	m_versionSig = (rod->minorVersion() >= 0x1003);
-      }
+  JemRoiMap upMap;
+  JemRoiMap simMap;
+  setupMap(rois, upMap);
+  setupMap(simRois, simMap);
+  ++m_upstreamChecked;
+  if (!TrigT1CaloMapCompare::agree(upMap, simMap, JemRoiPolicy())) {
+    ++m_upstreamDiffer;
+    if (m_debug) {
+      msg(MSG::DEBUG) << "Upstream JEM RoIs " << m_simJemRoiLocation
+                      << " differ from local simulation" << endreq;
+    }
+  }
+}
+
+// Compare upstream Et Sums with Et Sums simulated here
+
+void JEPSimBSMon::checkUpstream(const JemEtSumsCollection* sums)
+{
+  JemEtSumsMap upMap;
+  JemEtSumsMap simMap;
+  setupMap(sums, upMap);
+  setupMap(m_jemEtSumsSim, simMap);
+  ++m_upstreamChecked;
+  if (!TrigT1CaloMapCompare::agree(upMap, simMap, JemEtSumsPolicy())) {
+    ++m_upstreamDiffer;
+    if (m_debug) {
+      msg(MSG::DEBUG) << "Upstream JEM Et Sums " << m_simJemEtSumsLocation
+                      << " differ from local simulation" << endreq;
     }
-    m_rodTES = 0;
   }
 }
+
+template <typename T>
+const T* JEPSimBSMon::upstreamSim(const std::string& key)
+{
+  const T* coll = 0;
+  if (!key.empty() && evtStore()->contains<T>(key)) {
+    if (evtStore()->retrieve(coll, key).isFailure()) coll = 0;
+  }
+  if (coll && m_debug) {
+    msg(MSG::DEBUG) << "Upstream simulation available " << key << endreq;
+  }
+  return coll;
+}
@@ -8,17 +8,21 @@
 //
 // ********************************************************************
 
+#include <algorithm>
 #include <cmath>
 
 #include "LWHists/TH2F_LW.h"
 #include "LWHists/TH2I_LW.h"
+#include "LWHists/TProfile_LW.h"
 
 #include "GaudiKernel/MsgStream.h"
 #include "GaudiKernel/StatusCode.h"
-#include "SGTools/StlVectorClids.h"
 
 #include "AthenaMonitoring/AthenaMonManager.h"
 
+#include "EventInfo/EventInfo.h"
+#include "EventInfo/EventID.h"
+
 #include "TrigT1CaloEvent/TriggerTower.h"
 #include "TrigT1CaloUtils/TriggerTowerKey.h"
 #include "TrigT1CaloToolInterfaces/IL1TriggerTowerTool.h"
@@ -28,6 +32,43 @@
 #include "TrigT1CaloMonitoringTools/TrigT1CaloLWHistogramTool.h"
 
 #include "TrigT1CaloMonitoring/PPMSimBSMon.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloErrorBoardTool.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloTowerTableTool.h"
+
+/*---------------------------------------------------------*/
+class PPMSimBSMon::CrateSimTask : public TrigT1CaloTaskPool::Task
+/*---------------------------------------------------------*/
+{
+ public:
+  CrateSimTask(PPMSimBSMon* parent) : m_parent(parent) {}
+  /// Clear towers for next event
+  void clear() { m_towers.clear(); }
+  /// Add tower with its tower table index
+  void add(int index, const LVL1::TriggerTower* tt) {
+    m_towers.push_back(std::make_pair(index, tt));
+  }
+  /// Simulate towers into this task's own result list
+  virtual void execute() {
+    m_results.clear();
+    std::vector<std::pair<int, const LVL1::TriggerTower*> >::const_iterator
+                                                  it  = m_towers.begin();
+    std::vector<std::pair<int, const LVL1::TriggerTower*> >::const_iterator
+                                                  itE = m_towers.end();
+    for (; it != itE; ++it) {
+      if (m_parent->simulateTower(it->second, it->first, m_cache, m_out,
+                                  m_sim)) m_results.push_back(m_sim);
+    }
+  }
+  const std::vector<TowerSim>& results() const { return m_results; }
+  PPMSimLutCache& cache() { return m_cache; }
+ private:
+  PPMSimBSMon*                                              m_parent;
+  std::vector<std::pair<int, const LVL1::TriggerTower*> >   m_towers;
+  std::vector<TowerSim>                                     m_results;
+  PPMSimLutCache                                            m_cache;
+  LutOutput                                                 m_out;
+  TowerSim                                                  m_sim;
+};
 
 /*---------------------------------------------------------*/
 PPMSimBSMon::PPMSimBSMon(const std::string & type, 
@@ -37,8 +78,13 @@ PPMSimBSMon::PPMSimBSMon(const std::string & type,
     m_ttTool("LVL1::L1TriggerTowerTool/L1TriggerTowerTool"), 
     m_errorTool("TrigT1CaloMonErrorTool"),
     m_histTool("TrigT1CaloLWHistogramTool"),
+    m_errorBoard("TrigT1CaloErrorBoardTool"),
+    m_towerTable("TrigT1CaloTowerTableTool"),
     m_debug(false), m_events(0),
     m_histBooked(false),
+    m_conditionsValid(false),
+    m_conditionsLoads(0),
+    m_simThreads(0),
     m_h_ppm_em_2d_etaPhi_tt_lut_SimEqData(0),
     m_h_ppm_em_2d_etaPhi_tt_lut_SimNeData(0),
     m_h_ppm_em_2d_etaPhi_tt_lut_SimNoData(0),
@@ -50,7 +96,8 @@ PPMSimBSMon::PPMSimBSMon(const std::string & type,
     m_h_ppm_2d_LUT_MismatchEvents_cr0cr1(0),
     m_h_ppm_2d_LUT_MismatchEvents_cr2cr3(0),
     m_h_ppm_2d_LUT_MismatchEvents_cr4cr5(0),
-    m_h_ppm_2d_LUT_MismatchEvents_cr6cr7(0)
+    m_h_ppm_2d_LUT_MismatchEvents_cr6cr7(0),
+    m_h_ppm_1d_tt_lut_SamplingFraction(0)
 /*---------------------------------------------------------*/
 {
   declareProperty("TriggerTowerLocation",
@@ -61,12 +108,29 @@ PPMSimBSMon::PPMSimBSMon(const std::string & type,
 
   declareProperty("SimulationADCCut", m_simulationADCCut = 36,
                   "Minimum ADC cut to avoid unnecessary simulation");
+  declareProperty("SimulationCacheSize", m_simulationCacheSize = 8192,
+                  "Number of cached LUT simulation results, 0 to disable");
+  declareProperty("ZeroLutPreFilter", m_zeroLutPreFilter = true,
+                  "Skip simulation below per-channel zero LUT ADC ceiling");
+  declareProperty("LazyBooking", m_lazyBooking = false,
+                  "Only write mismatch histograms which are filled (offline)");
+  declareProperty("CpuBudget", m_cpuBudget = 0.,
+                  "Processing seconds per second budget, 0 for no sampling");
+  declareProperty("SamplingWindow", m_samplingWindow = 10,
+                  "Sampling prescale adjustment interval in seconds");
+  declareProperty("SamplingLumiMax", m_samplingLumiMax = 2000,
+                  "Maximum lumiblock in sampling fraction plot");
+  declareProperty("SimThreads", m_simThreads = 0,
+                  "Threads for per-crate LUT simulation, 0 or 1 for serial");
 }
 
 /*---------------------------------------------------------*/
 PPMSimBSMon::~PPMSimBSMon()
 /*---------------------------------------------------------*/
 {
+  std::vector<CrateSimTask*>::iterator it  = m_crateTasks.begin();
+  std::vector<CrateSimTask*>::iterator itE = m_crateTasks.end();
+  for (; it != itE; ++it) delete *it;
 }
 
 #ifndef PACKAGE_VERSION
@@ -106,6 +170,43 @@ StatusCode PPMSimBSMon:: initialize()
     return sc;
   }
 
+  sc = m_errorBoard.retrieve();
+  if( sc.isFailure() ) {
+    msg(MSG::ERROR) << "Unable to locate Tool TrigT1CaloErrorBoardTool"
+                    << endreq;
+    return sc;
+  }
+
+  sc = m_towerTable.retrieve();
+  if( sc.isFailure() ) {
+    msg(MSG::ERROR) << "Unable to locate Tool TrigT1CaloTowerTableTool"
+                    << endreq;
+    return sc;
+  }
+
+  // Each crate task caches its own channels
+  if (m_crateTasks.empty()) {
+    for (int crate = 0; crate < s_crates; ++crate) {
+      m_crateTasks.push_back(new CrateSimTask(this));
+    }
+  }
+  for (int crate = 0; crate < s_crates; ++crate) {
+    m_crateTasks[crate]->cache().setup(
+                      (m_simulationCacheSize + s_crates - 1)/s_crates);
+  }
+  m_sampler.setup(m_cpuBudget, m_samplingWindow);
+
+  if (m_simThreads > 1) {
+    const int nthreads = std::min(m_simThreads, int(s_crates));
+    if (m_simPool.start(nthreads)) {
+      msg(MSG::INFO) << "Per-crate LUT simulation using " << nthreads
+                     << " threads" << endreq;
+    } else {
+      msg(MSG::WARNING) << "Unable to start LUT simulation threads,"
+                        << " running serially" << endreq;
+    }
+  }
+
   return StatusCode::SUCCESS;
 
 }
@@ -114,6 +215,28 @@ StatusCode PPMSimBSMon:: initialize()
 StatusCode PPMSimBSMon:: finalize()
 /*---------------------------------------------------------*/
 {
+  msg(MSG::DEBUG) << "Conditions loaded " << m_conditionsLoads
+                  << " times in " << m_events << " events" << endreq;
+  m_simPool.stop();
+  unsigned long hits    = 0;
+  unsigned long lookups = 0;
+  std::vector<CrateSimTask*>::iterator it  = m_crateTasks.begin();
+  std::vector<CrateSimTask*>::iterator itE = m_crateTasks.end();
+  for (; it != itE; ++it) {
+    hits    += (*it)->cache().hits();
+    lookups += (*it)->cache().hits() + (*it)->cache().misses();
+  }
+  if (lookups > 0) {
+    msg(MSG::INFO) << "LUT simulation cache hits " << hits
+                   << " of " << lookups << " lookups ("
+		   << (100.*hits)/lookups << "%)" << endreq;
+  }
+  if (m_sampler.enabled()) {
+    msg(MSG::DEBUG) << "Sampling prescale changed " << m_sampler.changes()
+                    << " times, final prescale " << m_sampler.prescale()
+		    << endreq;
+  }
+
   return StatusCode::SUCCESS;
 }
 
@@ -131,15 +254,26 @@ StatusCode PPMSimBSMon::bookHistogramsRecurrent()
     // book histograms that are only relevant for cosmics data...
   }
 
-  if ( newLumiBlock ) { }
+  // Calibration conditions change at most at lumiblock boundaries
+
+  if ( newLumiBlock || newRun ) m_conditionsValid = false;
   
   if ( newRun ) {
 
+  StatusCode sc = m_towerTable->update();
+  if (sc.isFailure()) {
+    msg(MSG::ERROR) << "Failed to build tower table" << endreq;
+    return sc;
+  }
+
   MgmtAttr_t attr = ATTRIB_UNMANAGED;
   std::string dir(m_rootDir + "/PPM/Errors/Data_Simulation");
   MonGroup monPPM   ( this, dir + "/PPMLUTSim", run, attr );
   MonGroup monEvent ( this, dir + "/MismatchEventNumbers", run, attr, "", "eventSample" );
 
+  m_lazyHists.setup(m_lazyBooking &&
+                    m_environment != AthenaMonManager::online);
+
   // LUT
 
   m_histTool->setMonGroup(&monPPM);
@@ -168,6 +302,30 @@ StatusCode PPMSimBSMon::bookHistogramsRecurrent()
   m_h_ppm_had_2d_etaPhi_tt_lut_DataNoSim = m_histTool->bookPPMHadEtaVsPhi(
     "ppm_had_2d_etaPhi_tt_lut_DataNoSim",
     "PPM LUT HAD Data but no Simulation");
+
+  if (m_sampler.enabled()) {
+    m_h_ppm_1d_tt_lut_SamplingFraction = m_histTool->bookProfile(
+      "ppm_1d_tt_lut_SamplingFraction",
+      "Fraction of Events Sampled by Lumiblock;Lumiblock;Fraction",
+      m_samplingLumiMax, 0, m_samplingLumiMax);
+  }
+
+  sc = m_lazyHists.defer(m_h_ppm_em_2d_etaPhi_tt_lut_SimNeData, monPPM);
+  if (sc.isSuccess()) {
+    sc = m_lazyHists.defer(m_h_ppm_em_2d_etaPhi_tt_lut_SimNoData, monPPM);
+  }
+  if (sc.isSuccess()) {
+    sc = m_lazyHists.defer(m_h_ppm_em_2d_etaPhi_tt_lut_DataNoSim, monPPM);
+  }
+  if (sc.isSuccess()) {
+    sc = m_lazyHists.defer(m_h_ppm_had_2d_etaPhi_tt_lut_SimNeData, monPPM);
+  }
+  if (sc.isSuccess()) {
+    sc = m_lazyHists.defer(m_h_ppm_had_2d_etaPhi_tt_lut_SimNoData, monPPM);
+  }
+  if (sc.isSuccess()) {
+    sc = m_lazyHists.defer(m_h_ppm_had_2d_etaPhi_tt_lut_DataNoSim, monPPM);
+  }
 							
   // Mismatch Event Number Histograms
 
@@ -182,6 +340,23 @@ StatusCode PPMSimBSMon::bookHistogramsRecurrent()
   m_h_ppm_2d_LUT_MismatchEvents_cr6cr7 = m_histTool->bookPPMEventVsCrateModule(
     "ppm_2d_LUT_MismatchEvents_cr6cr7","PPM LUT Mismatch Event Numbers",6,7);
 
+  if (sc.isSuccess()) {
+    sc = m_lazyHists.defer(m_h_ppm_2d_LUT_MismatchEvents_cr0cr1, monEvent);
+  }
+  if (sc.isSuccess()) {
+    sc = m_lazyHists.defer(m_h_ppm_2d_LUT_MismatchEvents_cr2cr3, monEvent);
+  }
+  if (sc.isSuccess()) {
+    sc = m_lazyHists.defer(m_h_ppm_2d_LUT_MismatchEvents_cr4cr5, monEvent);
+  }
+  if (sc.isSuccess()) {
+    sc = m_lazyHists.defer(m_h_ppm_2d_LUT_MismatchEvents_cr6cr7, monEvent);
+  }
+  if (sc.isFailure()) {
+    msg(MSG::ERROR) << "Failed to deregister mismatch histograms" << endreq;
+    return sc;
+  }
+
   m_histTool->unsetMonGroup();
   m_histBooked = true;
 
@@ -220,11 +395,31 @@ StatusCode PPMSimBSMon::fillHistograms()
   }
   ++m_events;
 
+  // Prescale to stay within CPU budget
+
+  if (m_sampler.enabled()) {
+    const EventInfo* evInfo = 0;
+    const EventID* evID = 0;
+    sc = evtStore()->retrieve(evInfo);
+    if (sc.isSuccess() && evInfo) evID = evInfo->event_ID();
+    if (!evID) {
+      if (m_debug) msg(MSG::DEBUG) << "No EventID found, event sampled" << endreq;
+    }
+    // Event number 0 is always sampled
+    const bool sampled = m_sampler.accept((evID) ? evID->event_number() : 0);
+    if (evID) {
+      m_h_ppm_1d_tt_lut_SamplingFraction->Fill(evID->lumi_block(),
+                                               (sampled) ? 1. : 0.);
+    }
+    if (!sampled) return StatusCode::SUCCESS;
+  }
+
   // Compare LUT simulated from FADC with LUT from data
  
   if (triggerTowerTES) {
     simulateAndCompare(triggerTowerTES);
   }
+  m_sampler.done();
   
   if (m_debug) msg(MSG::DEBUG) << "Leaving fillHistograms" << endreq;
 
@@ -240,192 +435,296 @@ StatusCode PPMSimBSMon::procHistograms()
   if (endOfLumiBlock) {
   }
 
-  if (endOfRun) {
+  if (endOfRun && m_lazyHists.enabled()) {
+    int registered = 0;
+    int dropped    = 0;
+    StatusCode sc = m_lazyHists.registerFilled(registered, dropped);
+    if (sc.isFailure()) {
+      msg(MSG::ERROR) << "Failed to register mismatch histograms" << endreq;
+      return sc;
+    }
+    msg(MSG::DEBUG) << "Mismatch histograms written: " << registered
+                    << " omitted: " << dropped << endreq;
   }
 
   return StatusCode::SUCCESS;
 }
 
+/*---------------------------------------------------------*/
+StatusCode PPMSimBSMon::loadConditions()
+/*---------------------------------------------------------*/
+{
+  StatusCode sc = m_ttTool->retrieveConditions();
+  if (sc.isFailure()) return sc;
+
+  const int nTowers = TrigT1CaloTowerTableTool::numberOfTowers();
+  m_channelDisabled.resize(2*nTowers);
+  for (int index = 0; index < nTowers; ++index) {
+    const TrigT1CaloTowerTableTool::Tower& tower(m_towerTable->tower(index));
+    for (int layer = 0; layer < 2; ++layer) {
+      m_channelDisabled[2*index + layer] =
+                        m_ttTool->disabledChannel(tower.layer[layer].coolId);
+    }
+  }
+  std::vector<CrateSimTask*>::iterator it  = m_crateTasks.begin();
+  std::vector<CrateSimTask*>::iterator itE = m_crateTasks.end();
+  for (; it != itE; ++it) (*it)->cache().clear();
+  // Ceilings depend on the conditions, so recompute when needed
+  m_adcCeiling.assign(2*nTowers, s_ceilingUnknown);
+  m_conditionsValid = true;
+  ++m_conditionsLoads;
+  if (m_debug) {
+    msg(MSG::DEBUG) << "Conditions loaded, count " << m_conditionsLoads
+                    << endreq;
+  }
+
+  return StatusCode::SUCCESS;
+}
+
+/*---------------------------------------------------------*/
+int PPMSimBSMon::adcCeiling(int channel, const L1CaloCoolChannelId& coolId)
+/*---------------------------------------------------------*/
+{
+  int& ceiling(m_adcCeiling[channel]);
+  if (ceiling != s_ceilingUnknown) return ceiling;
+
+  // Binary search for the largest level which always gives zero LUT.
+  // Zero LUT output at a level implies it at all lower levels since the
+  // worst case FIR output grows with the level.
+
+  int lo = -1;
+  int hi = s_maxAdc;
+  while (lo < hi) {
+    const int mid = (lo + hi + 1)/2;
+    if (zeroLut(coolId, mid)) lo = mid;
+    else hi = mid - 1;
+  }
+  ceiling = lo;
+  if (m_debug) {
+    msg(MSG::DEBUG) << "Zero LUT ADC ceiling for channel " << channel
+                    << ": " << ceiling << endreq;
+  }
+  return ceiling;
+}
+
+/*---------------------------------------------------------*/
+bool PPMSimBSMon::zeroLut(const L1CaloCoolChannelId& coolId, int level)
+/*---------------------------------------------------------*/
+{
+  // The FIR is linear in the ADC slices and the LUT is non-decreasing in
+  // the FIR output, so over all waveforms with slices between 0 and level
+  // the largest LUT output comes from a waveform whose FIR window slices
+  // are each either 0 or level.  Try all such five slice windows.
+
+  const int firTaps = 5;
+  std::vector<int> adc(firTaps);
+  std::vector<int> lut;
+  std::vector<int> bcidR;
+  std::vector<int> bcidD;
+  for (int pattern = 0; pattern < (1 << firTaps); ++pattern) {
+    for (int sl = 0; sl < firTaps; ++sl) {
+      adc[sl] = ((pattern >> sl) & 0x1) ? level : 0;
+    }
+    lut.clear();
+    bcidR.clear();
+    bcidD.clear();
+    m_ttTool->process(adc, coolId, lut, bcidR, bcidD);
+    std::vector<int>::const_iterator it  = lut.begin();
+    std::vector<int>::const_iterator itE = lut.end();
+    for (; it != itE; ++it) {
+      if (*it != 0) return false;
+    }
+  }
+  return true;
+}
+
 void PPMSimBSMon::simulateAndCompare(const TriggerTowerCollection* ttIn)
 {
   if (m_debug) msg(MSG::DEBUG) << "Simulate LUT data from FADC data" << endreq;
 
-  StatusCode sc = m_ttTool->retrieveConditions();
-  if (sc.isFailure()) return;
+  StatusCode sc;
+  if (!m_conditionsValid) {
+    sc = loadConditions();
+    if (sc.isFailure()) return;
+  }
 
-  const int nCrates = 8;
-  ErrorVector crateError(nCrates);
-  ErrorVector moduleError(nCrates);
- 
-  std::vector<int> emLut;
-  std::vector<int> emBcidR;
-  std::vector<int> emBcidD;
-  std::vector<int> hadLut;
-  std::vector<int> hadBcidR;
-  std::vector<int> hadBcidD;
-  
-  m_ttTool->setDebug(false);
+  // Divide towers by crate of EM channel
+
+  for (int crate = 0; crate < s_crates; ++crate) m_crateTasks[crate]->clear();
   TriggerTowerCollection::const_iterator iter  = ttIn->begin();
   TriggerTowerCollection::const_iterator iterE = ttIn->end();
-
   for (; iter != iterE; ++iter) {
-    
     const LVL1::TriggerTower* tt = *iter;
-    const std::vector<int>& emADC(tt->emADC());
-    const std::vector<int>& hadADC(tt->hadADC());
-    const double eta = tt->eta();
-    const double phi = tt->phi();
-
-    int simEm = 0;
-    const int datEm = tt->emEnergy();
-    const int emSlices = emADC.size();
-    bool keep = true;
-    if (datEm == 0) {
-      keep = false;
-      std::vector<int>::const_iterator it1 = emADC.begin();
-      std::vector<int>::const_iterator itE = emADC.end();
-      for (;it1 != itE; ++it1) {
-        if (*it1 >= m_simulationADCCut) {
-          keep = true;
-	  break;
-        }
-      }
-    }
-    if (keep) {
-      emLut.clear();
-      emBcidR.clear();
-      emBcidD.clear();
-      const int emPeak = tt->emADCPeak();
-      const L1CaloCoolChannelId em_coolId(m_ttTool->channelID(eta, phi, 0));
-      m_ttTool->process(emADC, em_coolId, emLut, emBcidR, emBcidD);
-      if (emSlices < 7 || emBcidD[emPeak]) simEm = emLut[emPeak];
-      if (m_debug && simEm != datEm && (emSlices >= 7 || datEm != 0)) { // mismatch - repeat with debug on
-        std::vector<int> emLut2; 
-        std::vector<int> emBcidR2;
-        std::vector<int> emBcidD2;
-        m_ttTool->setDebug(true);
-        m_ttTool->process(emADC, em_coolId, emLut2, emBcidR2, emBcidD2);
-        m_ttTool->setDebug(false);
-      }
-    }
-    
-    int simHad = 0;
-    const int datHad = tt->hadEnergy();
-    const int hadSlices = hadADC.size();
-    keep = true;
-    if (datHad == 0) {
-      keep = false;
-      std::vector<int>::const_iterator it1 = hadADC.begin();
-      std::vector<int>::const_iterator itE = hadADC.end();
-      for (;it1 != itE; ++it1) {
-        if (*it1 >= m_simulationADCCut) {
-	  keep = true;
-	  break;
-        }
-      }
+    const int index = m_towerTable->index(tt->eta(), tt->phi());
+    const int crate = m_towerTable->tower(index).layer[0].crate;
+    m_crateTasks[crate]->add(index, tt);
+  }
+
+  // Simulate each crate, in parallel if threads available
+
+  m_ttTool->setDebug(false);
+  std::vector<TrigT1CaloTaskPool::Task*> tasks(m_crateTasks.begin(),
+                                               m_crateTasks.end());
+  if (m_simPool.workers() > 0 && !m_debug) {
+    if (!m_simPool.run(tasks)) {
+      msg(MSG::ERROR) << "Exception in per-crate LUT simulation" << endreq;
+      m_ttTool->setDebug(true);
+      return;
     }
-    if (keep) {
-      hadLut.clear();
-      hadBcidR.clear();
-      hadBcidD.clear();
-      const int hadPeak = tt->hadADCPeak();
-      const L1CaloCoolChannelId had_coolId(m_ttTool->channelID(eta, phi, 1));
-      m_ttTool->process(hadADC, had_coolId, hadLut, hadBcidR, hadBcidD);
-      if (hadSlices < 7 || hadBcidD[hadPeak]) simHad = hadLut[hadPeak];
-      if (m_debug && simHad != datHad && (hadSlices >= 7 || datHad !=0 )) {
-        std::vector<int> hadLut2;
-        std::vector<int> hadBcidR2;
-        std::vector<int> hadBcidD2;
-        m_ttTool->setDebug(true);
-        m_ttTool->process(hadADC, had_coolId, hadLut2, hadBcidR2, hadBcidD2);
-        m_ttTool->setDebug(false);
-      }
+  } else {
+    for (int crate = 0; crate < s_crates; ++crate) {
+      m_crateTasks[crate]->execute();
     }
+  }
+  m_ttTool->setDebug(true);
+
+  // Compare and fill in crate order
+
+  ErrorVector crateError(s_crates);
+  ErrorVector moduleError(s_crates);
+  for (int crate = 0; crate < s_crates; ++crate) {
+    const std::vector<TowerSim>& results(m_crateTasks[crate]->results());
+    std::vector<TowerSim>::const_iterator it  = results.begin();
+    std::vector<TowerSim>::const_iterator itE = results.end();
+    for (; it != itE; ++it) compareTower(*it, crateError, moduleError);
+  }
     
-    if (!simEm && !simHad && !datEm && !datHad) continue;
-    
-    //  Fill in error plots
+  m_errorBoard->set(TrigT1CaloErrorBoardTool::PPMMismatch, crateError);
+  
+}
+
+bool PPMSimBSMon::simulateTower(const LVL1::TriggerTower* tt, int index,
+                                PPMSimLutCache& cache, LutOutput& out,
+                                TowerSim& sim)
+{
+  const TrigT1CaloTowerTableTool::Tower& tower(m_towerTable->tower(index));
+
+  sim.datEm    = tt->emEnergy();
+  sim.emSlices = tt->emADC().size();
+  sim.simEm    = simulateLayer(tt->emADC(), tt->emADCPeak(), sim.datEm,
+                               2*index, tower.layer[0].coolId, cache, out);
+  sim.datHad    = tt->hadEnergy();
+  sim.hadSlices = tt->hadADC().size();
+  sim.simHad    = simulateLayer(tt->hadADC(), tt->hadADCPeak(), sim.datHad,
+                                2*index + 1, tower.layer[1].coolId, cache, out);
+  if (!sim.simEm && !sim.simHad && !sim.datEm && !sim.datHad) return false;
+  sim.index = index;
+  sim.eta   = tt->eta();
+  sim.phi   = tt->phi();
+  return true;
+}
+
+int PPMSimBSMon::simulateLayer(const std::vector<int>& adc, int peak, int dat,
+                               int channel, const L1CaloCoolChannelId& coolId,
+                               PPMSimLutCache& cache, LutOutput& out)
+{
+  if (m_channelDisabled[channel]) return 0;
+  if (dat == 0) {
+    const int maxAdc = (adc.empty()) ? 0
+                       : *std::max_element(adc.begin(), adc.end());
+    if (maxAdc < m_simulationADCCut) return 0;
+    if (m_zeroLutPreFilter && maxAdc <= adcCeiling(channel, coolId)) return 0;
+  }
+  if (!cache.find(channel, adc, out.lut, out.bcidR, out.bcidD)) {
+    out.lut.clear();
+    out.bcidR.clear();
+    out.bcidD.clear();
+    m_ttTool->process(adc, coolId, out.lut, out.bcidR, out.bcidD);
+    cache.insert(channel, adc, out.lut, out.bcidR, out.bcidD);
+  }
+  const int slices = adc.size();
+  int sim = 0;
+  if (slices < 7 || out.bcidD[peak]) sim = out.lut[peak];
+  if (m_debug && sim != dat && (slices >= 7 || dat != 0)) { // mismatch - repeat with debug on
+    std::vector<int> lut2;
+    std::vector<int> bcidR2;
+    std::vector<int> bcidD2;
+    m_ttTool->setDebug(true);
+    m_ttTool->process(adc, coolId, lut2, bcidR2, bcidD2);
+    m_ttTool->setDebug(false);
+  }
+  return sim;
+}
+
+void PPMSimBSMon::compareTower(const TowerSim& sim, ErrorVector& crateError,
+                                                    ErrorVector& moduleError)
+{
+  const TrigT1CaloTowerTableTool::Tower& tower(m_towerTable->tower(sim.index));
+  const double eta = sim.eta;
+  const double phi = sim.phi;
+  const int simEm  = sim.simEm;
+  const int datEm  = sim.datEm;
+  const int simHad = sim.simHad;
+  const int datHad = sim.datHad;
+
+  //  Fill in error plots
     
-    int em_mismatch = 0;
-    int had_mismatch = 0;
+  int em_mismatch = 0;
+  int had_mismatch = 0;
     
-    TH2F_LW* hist1 = 0;
-    if (simEm && simEm == datEm) { // non-zero match
-      hist1 = m_h_ppm_em_2d_etaPhi_tt_lut_SimEqData;
-    } else if (simEm != datEm) {  // mis-match
-      em_mismatch = 1;
-      if (simEm && datEm) {       // non-zero mis-match
-        hist1 = m_h_ppm_em_2d_etaPhi_tt_lut_SimNeData;
-      } else if (!datEm) {        // no data
-	if (emSlices >= 7) {
-	  hist1 = m_h_ppm_em_2d_etaPhi_tt_lut_SimNoData;
-	} else em_mismatch = 0;
-      } else {                    // no sim
-	hist1 = m_h_ppm_em_2d_etaPhi_tt_lut_DataNoSim;
-      }
-      if (m_debug) {
-        msg(MSG::DEBUG) << " EMTowerMismatch eta/phi/sim/dat: "
-              << eta << "/" << phi << "/" << simEm << "/" << datEm << endreq;
-      }
+  TH2F_LW* hist1 = 0;
+  if (simEm && simEm == datEm) { // non-zero match
+    hist1 = m_h_ppm_em_2d_etaPhi_tt_lut_SimEqData;
+  } else if (simEm != datEm) {  // mis-match
+    em_mismatch = 1;
+    if (simEm && datEm) {       // non-zero mis-match
+      hist1 = m_h_ppm_em_2d_etaPhi_tt_lut_SimNeData;
+    } else if (!datEm) {        // no data
+      if (sim.emSlices >= 7) {
+        hist1 = m_h_ppm_em_2d_etaPhi_tt_lut_SimNoData;
+      } else em_mismatch = 0;
+    } else {                    // no sim
+      hist1 = m_h_ppm_em_2d_etaPhi_tt_lut_DataNoSim;
+    }
+    if (m_debug) {
+      msg(MSG::DEBUG) << " EMTowerMismatch eta/phi/sim/dat: "
+            << eta << "/" << phi << "/" << simEm << "/" << datEm << endreq;
     }
+  }
     
-    if (hist1) m_histTool->fillPPMEmEtaVsPhi(hist1, eta, phi);
+  if (hist1) m_histTool->fillPPMEmEtaVsPhi(hist1, eta, phi);
     
-    if (em_mismatch == 1) {
-      const L1CaloCoolChannelId em_coolId(m_ttTool->channelID(eta, phi, 0));
-      const int em_crate  = em_coolId.crate();
-      const int em_module = em_coolId.module();
-      crateError[em_crate] = 1;
-      if (!((moduleError[em_crate]>>em_module)&0x1)) {
-	fillEventSample(em_crate, em_module);
-	moduleError[em_crate] |= (1 << em_module);
-      }
+  if (em_mismatch == 1) {
+    const int em_crate  = tower.layer[0].crate;
+    const int em_module = tower.layer[0].module;
+    crateError[em_crate] = 1;
+    if (!((moduleError[em_crate]>>em_module)&0x1)) {
+      fillEventSample(em_crate, em_module);
+      moduleError[em_crate] |= (1 << em_module);
     }
+  }
     
-    hist1 = 0;
-    if (simHad && simHad == datHad) { // non-zero match
-      hist1 = m_h_ppm_had_2d_etaPhi_tt_lut_SimEqData;
-    } else if (simHad != datHad) {   // mis-match
-      had_mismatch = 1;
-      if (simHad && datHad) {        // non-zero mis-match
-        hist1 = m_h_ppm_had_2d_etaPhi_tt_lut_SimNeData;
-      } else if (!datHad) {          // no data
-	if (hadSlices >= 7) {
-	  hist1 = m_h_ppm_had_2d_etaPhi_tt_lut_SimNoData;
-	} else had_mismatch = 0;
-      } else {                       // no sim
-	hist1 = m_h_ppm_had_2d_etaPhi_tt_lut_DataNoSim;
-      }
-      if (m_debug) {
-        msg(MSG::DEBUG) << " HadTowerMismatch eta/phi/sim/dat: "
-              << eta << "/" << phi << "/" << simHad << "/" << datHad << endreq;
-      }
+  hist1 = 0;
+  if (simHad && simHad == datHad) { // non-zero match
+    hist1 = m_h_ppm_had_2d_etaPhi_tt_lut_SimEqData;
+  } else if (simHad != datHad) {   // mis-match
+    had_mismatch = 1;
+    if (simHad && datHad) {        // non-zero mis-match
+      hist1 = m_h_ppm_had_2d_etaPhi_tt_lut_SimNeData;
+    } else if (!datHad) {          // no data
+      if (sim.hadSlices >= 7) {
+        hist1 = m_h_ppm_had_2d_etaPhi_tt_lut_SimNoData;
+      } else had_mismatch = 0;
+    } else {                       // no sim
+      hist1 = m_h_ppm_had_2d_etaPhi_tt_lut_DataNoSim;
     }
+    if (m_debug) {
+      msg(MSG::DEBUG) << " HadTowerMismatch eta/phi/sim/dat: "
+            << eta << "/" << phi << "/" << simHad << "/" << datHad << endreq;
+    }
+  }
 
-    if (hist1) m_histTool->fillPPMHadEtaVsPhi(hist1, eta, phi);
+  if (hist1) m_histTool->fillPPMHadEtaVsPhi(hist1, eta, phi);
       
-    if (had_mismatch == 1) {
-      const L1CaloCoolChannelId had_coolId(m_ttTool->channelID(eta, phi, 1));
-      const int had_crate  = had_coolId.crate();
-      const int had_module = had_coolId.module();
-      crateError[had_crate] = 1;
-      if (!((moduleError[had_crate]>>had_module)&0x1)) {
-	fillEventSample(had_crate, had_module);
-	moduleError[had_crate] |= (1 << had_module);
-      }
+  if (had_mismatch == 1) {
+    const int had_crate  = tower.layer[1].crate;
+    const int had_module = tower.layer[1].module;
+    crateError[had_crate] = 1;
+    if (!((moduleError[had_crate]>>had_module)&0x1)) {
+      fillEventSample(had_crate, had_module);
+      moduleError[had_crate] |= (1 << had_module);
     }
-  
-  }    
-    
-  ErrorVector* save = new ErrorVector(crateError);
-  sc = evtStore()->record(save, "L1CaloPPMMismatchVector");
-  if (sc.isFailure()) {
-    msg(MSG::ERROR) << "Error recording PPM mismatch vector in TES "
-	            << endreq;
   }
-  
-  m_ttTool->setDebug(true);
-  
 }
 
 void PPMSimBSMon::fillEventSample(int crate, int module)
@@ -0,0 +1,88 @@
+// ********************************************************************
+//
+// NAME:     PPMSimLutCache.cxx
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+
+#include "TrigT1CaloMonitoring/PPMSimLutCache.h"
+
+/*---------------------------------------------------------*/
+PPMSimLutCache::PPMSimLutCache()
+  : m_hits(0),
+    m_misses(0)
+/*---------------------------------------------------------*/
+{
+}
+
+/*---------------------------------------------------------*/
+void PPMSimLutCache::setup(int capacity)
+/*---------------------------------------------------------*/
+{
+  m_entries.clear();
+  if (capacity > 0) m_entries.resize(capacity);
+  clear();
+}
+
+/*---------------------------------------------------------*/
+void PPMSimLutCache::clear()
+/*---------------------------------------------------------*/
+{
+  std::vector<Entry>::iterator it  = m_entries.begin();
+  std::vector<Entry>::iterator itE = m_entries.end();
+  for (; it != itE; ++it) it->channel = -1;
+}
+
+/*---------------------------------------------------------*/
+bool PPMSimLutCache::find(int channel, const std::vector<int>& adc,
+                          std::vector<int>& lut, std::vector<int>& bcidR,
+			  std::vector<int>& bcidD)
+/*---------------------------------------------------------*/
+{
+  if (m_entries.empty()) return false;
+  const unsigned int key = hash(channel, adc);
+  const Entry& entry(m_entries[key % m_entries.size()]);
+  if (entry.channel != channel || entry.hash != key || entry.adc != adc) {
+    ++m_misses;
+    return false;
+  }
+  ++m_hits;
+  lut   = entry.lut;
+  bcidR = entry.bcidR;
+  bcidD = entry.bcidD;
+  return true;
+}
+
+/*---------------------------------------------------------*/
+void PPMSimLutCache::insert(int channel, const std::vector<int>& adc,
+                            const std::vector<int>& lut,
+			    const std::vector<int>& bcidR,
+			    const std::vector<int>& bcidD)
+/*---------------------------------------------------------*/
+{
+  if (m_entries.empty()) return;
+  const unsigned int key = hash(channel, adc);
+  Entry& entry(m_entries[key % m_entries.size()]);
+  entry.channel = channel;
+  entry.hash    = key;
+  entry.adc     = adc;
+  entry.lut     = lut;
+  entry.bcidR   = bcidR;
+  entry.bcidD   = bcidD;
+}
+
+/*---------------------------------------------------------*/
+unsigned int PPMSimLutCache::hash(int channel, const std::vector<int>& adc)
+/*---------------------------------------------------------*/
+{
+  // FNV-1a over channel and slices
+
+  unsigned int h = 2166136261u;
+  h = (h ^ static_cast<unsigned int>(channel)) * 16777619u;
+  std::vector<int>::const_iterator it  = adc.begin();
+  std::vector<int>::const_iterator itE = adc.end();
+  for (; it != itE; ++it) {
+    h = (h ^ static_cast<unsigned int>(*it)) * 16777619u;
+  }
+  return h;
+}
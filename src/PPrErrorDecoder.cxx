@@ -0,0 +1,41 @@
+// ********************************************************************
+//
+// NAME:     PPrErrorDecoder.cxx
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+
+#include "TrigT1CaloMonitoring/PPrErrorDecoder.h"
+
+/*---------------------------------------------------------*/
+PPrErrorDecoder::PPrErrorDecoder()
+/*---------------------------------------------------------*/
+{
+  using LVL1::DataError;
+
+  for (unsigned int bits = 0; bits < 256; ++bits) {
+
+    const DataError asic(static_cast<int>(bits << DataError::ChannelDisabled));
+    int ov = 0;
+    if (asic.get(DataError::ChannelDisabled) ||
+        asic.get(DataError::MCMAbsent)) ov |= 1;
+    if (asic.get(DataError::Timeout)       ||
+        asic.get(DataError::ASICFull)      ||
+        asic.get(DataError::EventMismatch) ||
+        asic.get(DataError::BunchMismatch) ||
+        asic.get(DataError::FIFOCorrupt)   ||
+        asic.get(DataError::PinParity)) ov |= (1 << 1);
+    m_asicOverview[bits] = ov;
+
+    const DataError status(static_cast<int>(bits << DataError::GLinkParity));
+    ov = 0;
+    if (status.get(DataError::GLinkParity)   ||
+        status.get(DataError::GLinkProtocol) ||
+        status.get(DataError::FIFOOverflow)  ||
+        status.get(DataError::ModuleError)   ||
+        status.get(DataError::GLinkDown)     ||
+        status.get(DataError::GLinkTimeout)  ||
+        status.get(DataError::BCNMismatch)) ov |= (1 << 2);
+    m_statusOverview[bits] = ov;
+  }
+}
@@ -8,10 +8,10 @@
 //
 // ********************************************************************
 
+#include <algorithm>
 #include <cmath>
 #include "GaudiKernel/MsgStream.h"
 #include "GaudiKernel/StatusCode.h"
-#include "SGTools/StlVectorClids.h"
 
 #include "LWHists/LWHist.h"
 #include "LWHists/TH1F_LW.h"
@@ -26,10 +26,10 @@
 #include "EventInfo/EventID.h"
 
 #include "TrigT1CaloMonitoring/PPrMon.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloErrorBoardTool.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloTowerTableTool.h"
 #include "TrigT1CaloMonitoringTools/TrigT1CaloMonErrorTool.h"
 #include "TrigT1CaloMonitoringTools/TrigT1CaloLWHistogramTool.h"
-#include "TrigT1CaloToolInterfaces/IL1TriggerTowerTool.h"
-#include "TrigT1CaloCalibConditions/L1CaloCoolChannelId.h"
 //#include "TrigConfigSvc/ILVL1ConfigSvc.h"
 
 #include "TrigT1CaloEvent/TriggerTowerCollection.h"
@@ -43,9 +43,14 @@ PPrMon::PPrMon(const std::string & type, const std::string & name,
   : ManagedMonitorToolBase ( type, name, parent ),
     m_SliceNo(15),
     m_histBooked(false),
+    m_etCountsFilled(false),
+    m_eventsSinceFlush(0),
+    m_hitMapSlot(0),
+    m_hitMapTitlePending(false),
     m_errorTool("TrigT1CaloMonErrorTool"),
     m_histTool("TrigT1CaloLWHistogramTool"),
-    m_ttTool("LVL1::L1TriggerTowerTool/L1TriggerTowerTool"),
+    m_errorBoard("TrigT1CaloErrorBoardTool"),
+    m_towerTable("TrigT1CaloTowerTableTool"),
     m_h_ppm_em_2d_etaPhi_tt_adc_HitMap(0),
     m_h_ppm_had_2d_etaPhi_tt_adc_HitMap(0),
     m_h_ppm_had_1d_tt_adc_MaxTimeslice(0),
@@ -111,6 +116,11 @@ PPrMon::PPrMon(const std::string & type, const std::string & name,
                   m_ErrorPathInRootFile="L1Calo/PPM/Errors") ;
   declareProperty("OnlineTest", m_onlineTest = false,
                   "Test online code when running offline");
+  declareProperty("LUTHitMap_UpdateEvents", m_TT_HitMap_UpdateEvents = 500,
+        "The number of events between LUT hitmap updates online, also updated "
+        "at end of lumiblock.  Published hitmaps can lag by up to this many events");
+  declareProperty("LazyBooking", m_lazyBooking = false,
+        "Only write error detail histograms which are filled (offline)");
 
   // note: threshold vector index (not value) is preferred 
   // to name PPM LUT histograms (see below, buffer_name) to 
@@ -159,12 +169,43 @@ StatusCode PPrMon::initialize()
     return sc;
   }
 
-  sc = m_ttTool.retrieve();
+  sc = m_errorBoard.retrieve();
   if( sc.isFailure() ) {
-    msg(MSG::ERROR) << "Unable to locate Tool L1TriggerTowerTool" << endreq;
+    msg(MSG::ERROR) << "Unable to locate Tool TrigT1CaloErrorBoardTool"
+                    << endreq;
     return sc;
   }
 
+  sc = m_towerTable.retrieve();
+  if( sc.isFailure() ) {
+    msg(MSG::ERROR) << "Unable to locate Tool TrigT1CaloTowerTableTool"
+                    << endreq;
+    return sc;
+  }
+
+  // Et occupancy store for threshold hitmaps.
+  // Et bin is the number of thresholds below Et, so a threshold is
+  // passed by all Et bins above the number of thresholds below it.
+
+  const unsigned int nThresh = m_TT_HitMap_ThreshVec.size();
+  unsigned int maxThresh = 0;
+  for (unsigned int thresh = 0; thresh < nThresh; ++thresh) {
+    if (m_TT_HitMap_ThreshVec[thresh] > maxThresh) {
+      maxThresh = m_TT_HitMap_ThreshVec[thresh];
+    }
+  }
+  m_etBin.assign(maxThresh + 2, 0);
+  m_threshBin.assign(nThresh, 0);
+  for (unsigned int thresh = 0; thresh < nThresh; ++thresh) {
+    const unsigned int value = m_TT_HitMap_ThreshVec[thresh];
+    for (unsigned int et = value + 1; et < m_etBin.size(); ++et) ++m_etBin[et];
+    for (unsigned int other = 0; other < nThresh; ++other) {
+      if (m_TT_HitMap_ThreshVec[other] < value) ++m_threshBin[thresh];
+    }
+  }
+  m_etCounts.assign(TrigT1CaloTowerTableTool::numberOfTowers()
+                                   * MaxHitMapTypes * (nThresh + 1), 0);
+
   return StatusCode::SUCCESS;
 }
 
@@ -186,6 +227,18 @@ StatusCode PPrMon::bookHistogramsRecurrent()
 
   if ( newRun ) {
 
+    StatusCode sc = m_towerTable->update();
+    if (sc.isFailure()) {
+      msg(MSG::ERROR) << "Failed to build tower table" << endreq;
+      return sc;
+    }
+    std::fill(m_etCounts.begin(), m_etCounts.end(), 0);
+    m_etCountsFilled   = false;
+    m_eventsSinceFlush = 0;
+    m_signalProfiles.setup(TrigT1CaloTowerTableTool::MaxPartitions*m_SliceNo);
+    m_lazyHists.setup(m_lazyBooking &&
+                      m_environment != AthenaMonManager::online && !m_onlineTest);
+
     MonGroup TT_LutCpHitMaps(this, m_PathInRootFile+"/LUT-CP/EtaPhiMaps", run, attr);
     MonGroup TT_LutJepHitMaps(this, m_PathInRootFile+"/LUT-JEP/EtaPhiMaps", run, attr);
     MonGroup TT_ADC(this, m_PathInRootFile+"/ADC/EtaPhiMaps", run, attr);
@@ -257,13 +310,13 @@ StatusCode PPrMon::bookHistogramsRecurrent()
     //---------------------------- Signal shape ------------------------------
 
     m_v_ppm_1d_tt_adc_SignalProfile.clear();
-    const int emPart = MaxPartitions/2;
-    for (int p = 0; p < MaxPartitions; ++p) {
-      if (p < emPart) name = "ppm_em_1d_tt_adc_SignalProfile"
-                             + partitionName(p);
-      else            name = "ppm_had_1d_tt_adc_SignalProfile"
-                             + partitionName(p);
-      title = "Signal Shape Profile for " + partitionName(p) + ";Timeslice";
+    const int maxPart = TrigT1CaloTowerTableTool::MaxPartitions;
+    const int emPart  = maxPart/2;
+    for (int p = 0; p < maxPart; ++p) {
+      const std::string partName(TrigT1CaloTowerTableTool::partitionName(p));
+      if (p < emPart) name = "ppm_em_1d_tt_adc_SignalProfile"  + partName;
+      else            name = "ppm_had_1d_tt_adc_SignalProfile" + partName;
+      title = "Signal Shape Profile for " + partName + ";Timeslice";
       m_v_ppm_1d_tt_adc_SignalProfile.push_back(m_histTool->bookProfile(name, title,
 	                                            m_SliceNo, 0, m_SliceNo));
     }
@@ -301,52 +354,32 @@ StatusCode PPrMon::bookHistogramsRecurrent()
 	       "#eta - #phi Map of HAD LUT-JEP > "+buffer.str());
 	m_v_ppm_had_2d_etaPhi_tt_lutjep_Threshold.push_back(hist);
       }
+      // Ring of slots for the last N lumiblocks, booked once per run.
+      // The current lumiblock starts in slot 0.
+      m_hitMapSlot = 0;
+      m_hitMapTitlePending = true;
       for (int block = 0; block <= m_TT_HitMap_LumiBlocks; ++block) {
         buffer.str("");
 	buffer << block;
-        MonGroup lumiGroup(this,
+        MonGroup lumiCpGroup(this,
 	  m_PathInRootFile+"/LUT-CP/EtaPhiMaps/lumi_"+buffer.str(), run, attr);
-        m_histTool->setMonGroup(&lumiGroup);
-	for (unsigned int thresh = 0; thresh < m_TT_HitMap_ThreshVec.size(); ++thresh) {
-          buffer_name.str("");
-	  buffer_name << std::setw(2) << std::setfill('0') << thresh << "Lumi" << block;
-	  std::string name = "ppm_em_2d_etaPhi_tt_lutcp_Thresh"+buffer_name.str();
-	  buffer.str("");
-	  if (block == 0) buffer << m_TT_HitMap_ThreshVec[thresh] << ", Current Lumi-block";
-	  else            buffer << m_TT_HitMap_ThreshVec[thresh] << ", Lumi-block -" << block;
-	  std::string title = "#eta - #phi Map of EM LUT-CP > "+buffer.str();
-	  TH2F_LW* hist = m_histTool->bookPPMEmEtaVsPhi(name, title);
-	  m_v_ppm_em_2d_etaPhi_tt_lutcp_Threshold.push_back(hist);
-	  title = "#eta - #phi Map of HAD LUT-CP > "+buffer.str();
-	  buffer_name.str("");
-	  buffer_name << std::setw(2) << std::setfill('0') << thresh << "Lumi" << block;
-	  name = "ppm_had_2d_etaPhi_tt_lutcp_Thresh"+buffer_name.str();
-	  hist = m_histTool->bookPPMHadEtaVsPhi(name, title);
-	  m_v_ppm_had_2d_etaPhi_tt_lutcp_Threshold.push_back(hist);
-	}
-      }
-       for (int block = 0; block <= m_TT_HitMap_LumiBlocks; ++block) {
-        buffer.str("");
-	buffer << block;
-        MonGroup lumiGroup(this,
+        MonGroup lumiJepGroup(this,
 	  m_PathInRootFile+"/LUT-JEP/EtaPhiMaps/lumi_"+buffer.str(), run, attr);
-        m_histTool->setMonGroup(&lumiGroup);
 	for (unsigned int thresh = 0; thresh < m_TT_HitMap_ThreshVec.size(); ++thresh) {
-          buffer_name.str("");
-	  buffer_name << std::setw(2) << std::setfill('0') << thresh << "Lumi" << block;
-	  std::string name = "ppm_em_2d_etaPhi_tt_lutjep_Thresh"+buffer_name.str();
-	  buffer.str("");
-	  if (block == 0) buffer << m_TT_HitMap_ThreshVec[thresh] << ", Current Lumi-block";
-	  else            buffer << m_TT_HitMap_ThreshVec[thresh] << ", Lumi-block -" << block;
-	  std::string title = "#eta - #phi Map of EM LUT-JEP > "+buffer.str();
-	  TH2F_LW* hist = m_histTool->bookPPMEmEtaVsPhi(name, title);
-	  m_v_ppm_em_2d_etaPhi_tt_lutjep_Threshold.push_back(hist);
-	  title = "#eta - #phi Map of HAD LUT-JEP > "+buffer.str();
-	  buffer_name.str("");
-	  buffer_name << std::setw(2) << std::setfill('0') << thresh << "Lumi" << block;
-	  name = "ppm_had_2d_etaPhi_tt_lutjep_Thresh"+buffer_name.str();
-	  hist = m_histTool->bookPPMHadEtaVsPhi(name, title);
-	  m_v_ppm_had_2d_etaPhi_tt_lutjep_Threshold.push_back(hist);
+          m_histTool->setMonGroup(&lumiCpGroup);
+	  lumiHitMapNames(EmLutCp, thresh, block, -1, name, title);
+	  m_v_ppm_em_2d_etaPhi_tt_lutcp_Threshold.push_back(
+	                         m_histTool->bookPPMEmEtaVsPhi(name, title));
+	  lumiHitMapNames(HadLutCp, thresh, block, -1, name, title);
+	  m_v_ppm_had_2d_etaPhi_tt_lutcp_Threshold.push_back(
+	                         m_histTool->bookPPMHadEtaVsPhi(name, title));
+          m_histTool->setMonGroup(&lumiJepGroup);
+	  lumiHitMapNames(EmLutJep, thresh, block, -1, name, title);
+	  m_v_ppm_em_2d_etaPhi_tt_lutjep_Threshold.push_back(
+	                         m_histTool->bookPPMEmEtaVsPhi(name, title));
+	  lumiHitMapNames(HadLutJep, thresh, block, -1, name, title);
+	  m_v_ppm_had_2d_etaPhi_tt_lutjep_Threshold.push_back(
+	                         m_histTool->bookPPMHadEtaVsPhi(name, title));
 	}
       }
     }
@@ -509,6 +542,18 @@ StatusCode PPrMon::bookHistogramsRecurrent()
 	m_v_ppm_2d_ASICErrorsDetail.push_back(hist);
       }
     }
+    sc = m_lazyHists.defer(m_v_ppm_2d_ASICErrorsDetail, TT_ErrorDetail);
+    if (sc.isSuccess()) {
+      sc = m_lazyHists.defer(m_h_ppm_2d_ErrorEventNumbers, TT_ErrorEvents);
+    }
+    if (sc.isSuccess()) {
+      sc = m_lazyHists.defer(m_h_ppm_2d_ASICErrorEventNumbers, TT_ErrorEvents);
+    }
+    if (sc.isFailure()) {
+      msg(MSG::ERROR) << "Failed to deregister error detail histograms"
+                      << endreq;
+      return sc;
+    }
 
     //---------------------------- number of triggered slice -----------------
     m_histTool->setMonGroup(&TT_ADCSlices);
@@ -529,36 +574,10 @@ StatusCode PPrMon::bookHistogramsRecurrent()
     //---------------------------- LUT-CP Hitmaps per threshold -----------------
     if (m_environment == AthenaMonManager::online || m_onlineTest) {
 
-      // Current lumi copied to lumi-1 and so on
-      for (int block = m_TT_HitMap_LumiBlocks-1; block >= 0; --block) {
-	for (unsigned int thresh = 0; thresh < m_TT_HitMap_ThreshVec.size(); ++thresh) {
-	  TH2F_LW* hist1 = m_v_ppm_em_2d_etaPhi_tt_lutcp_Threshold[
-	                           (block+1)*m_TT_HitMap_ThreshVec.size() + thresh];
-	  TH2F_LW* hist2 = m_v_ppm_em_2d_etaPhi_tt_lutcp_Threshold[
-	                           (block+2)*m_TT_HitMap_ThreshVec.size() + thresh];
-	  TH2F_LW* hist3 = m_v_ppm_had_2d_etaPhi_tt_lutcp_Threshold[
-	                           (block+1)*m_TT_HitMap_ThreshVec.size() + thresh];
-	  TH2F_LW* hist4 = m_v_ppm_had_2d_etaPhi_tt_lutcp_Threshold[
-	                           (block+2)*m_TT_HitMap_ThreshVec.size() + thresh];
-	  hist2->Reset();
-	  hist4->Reset();
-	  unsigned int ix = 0;
-	  unsigned int iy = 0;
-	  double content = 0.;
-	  double error   = 0.;
-	  hist1->resetActiveBinLoop();
-	  while (hist1->getNextActiveBin(ix, iy, content, error)) {
-	    if (content > 0.) hist2->SetBinContent(ix, iy, content);
-	  }
-	  hist3->resetActiveBinLoop();
-	  while (hist3->getNextActiveBin(ix, iy, content, error)) {
-	    if (content > 0.) hist4->SetBinContent(ix, iy, content);
-	  }
-	  if (block == 0) {
-            hist1->Reset();
-	    hist3->Reset();
-	  }
-        }
+      // Clear the oldest slot for the new lumiblock
+      if (!newRun) {
+        flushHitMaps();
+        rotateLumiHitMaps();
       }
     } else {
 
@@ -590,40 +609,7 @@ StatusCode PPrMon::bookHistogramsRecurrent()
     if (newRun) m_histBooked = true;
     
     //---------------------------- LUT-JEP Hitmaps per threshold -----------------
-    if (m_environment == AthenaMonManager::online || m_onlineTest) {
-
-      // Current lumi copied to lumi-1 and so on
-      for (int block = m_TT_HitMap_LumiBlocks-1; block >= 0; --block) {
-	for (unsigned int thresh = 0; thresh < m_TT_HitMap_ThreshVec.size(); ++thresh) {
-	  TH2F_LW* hist1 = m_v_ppm_em_2d_etaPhi_tt_lutjep_Threshold[
-	                           (block+1)*m_TT_HitMap_ThreshVec.size() + thresh];
-	  TH2F_LW* hist2 = m_v_ppm_em_2d_etaPhi_tt_lutjep_Threshold[
-	                           (block+2)*m_TT_HitMap_ThreshVec.size() + thresh];
-	  TH2F_LW* hist3 = m_v_ppm_had_2d_etaPhi_tt_lutjep_Threshold[
-	                           (block+1)*m_TT_HitMap_ThreshVec.size() + thresh];
-	  TH2F_LW* hist4 = m_v_ppm_had_2d_etaPhi_tt_lutjep_Threshold[
-	                           (block+2)*m_TT_HitMap_ThreshVec.size() + thresh];
-	  hist2->Reset();
-	  hist4->Reset();
-	  unsigned int ix = 0;
-	  unsigned int iy = 0;
-	  double content = 0.;
-	  double error   = 0.;
-	  hist1->resetActiveBinLoop();
-	  while (hist1->getNextActiveBin(ix, iy, content, error)) {
-	    if (content > 0.) hist2->SetBinContent(ix, iy, content);
-	  }
-	  hist3->resetActiveBinLoop();
-	  while (hist3->getNextActiveBin(ix, iy, content, error)) {
-	    if (content > 0.) hist4->SetBinContent(ix, iy, content);
-	  }
-	  if (block == 0) {
-            hist1->Reset();
-	    hist3->Reset();
-	  }
-        }
-      }
-    } else {
+    if (m_environment != AthenaMonManager::online && !m_onlineTest) {
 
       // Offline - per lumiblock - merge will give per run
       m_v_ppm_em_2d_etaPhi_tt_lutjep_Threshold.clear();
@@ -697,7 +683,10 @@ StatusCode PPrMon::fillHistograms()
     if (debug) msg(MSG::DEBUG) << "No EventInfo found" << endreq;
   } else {
     const EventID* evID = evInfo->event_ID();
-    if (evID) bunchCrossing = evID->bunch_crossing_id();
+    if (evID) {
+      bunchCrossing = evID->bunch_crossing_id();
+      if (m_hitMapTitlePending) setLumiHitMapTitles(evID->lumi_block());
+    }
   }
 
     
@@ -709,9 +698,25 @@ StatusCode PPrMon::fillHistograms()
                                                       TriggerTowerTES->begin(); 
   TriggerTowerCollection::const_iterator TriggerTowerIteratorEnd =
                                                       TriggerTowerTES->end(); 
- 
+
+  // Find FADC signal peaks for all towers in one pass
+
+  const int slices = (TriggerTowerIterator != TriggerTowerIteratorEnd)
+                   ? ((*TriggerTowerIterator)->emADC()).size() : 0;
+  m_emPeakFinder.clear(slices, TriggerTowerTES->size());
+  m_hadPeakFinder.clear(slices, TriggerTowerTES->size());
   for (; TriggerTowerIterator != TriggerTowerIteratorEnd;
                                                 ++TriggerTowerIterator) {
+    m_emPeakFinder.add((*TriggerTowerIterator)->emADC());
+    m_hadPeakFinder.add((*TriggerTowerIterator)->hadADC());
+  }
+  m_emPeakFinder.process(m_TT_ADC_Pedestal, m_EMFADCCut);
+  m_hadPeakFinder.process(m_TT_ADC_Pedestal, m_HADFADCCut);
+ 
+  int towerPos = 0;
+  for (TriggerTowerIterator = TriggerTowerTES->begin();
+       TriggerTowerIterator != TriggerTowerIteratorEnd;
+                                    ++TriggerTowerIterator, ++towerPos) {
     
     //---------------------------- EM Energy -----------------------------
     // em LUT Peak per channel
@@ -719,6 +724,8 @@ StatusCode PPrMon::fillHistograms()
     const int EmEnergy2 = EmEnergy/2;
     const double eta   = (*TriggerTowerIterator)->eta();
     const double phi   = (*TriggerTowerIterator)->phi();
+    const int towerIndex = m_towerTable->index(eta, phi);
+    const TrigT1CaloTowerTableTool::Tower& tower(m_towerTable->tower(towerIndex));
 
     // em energy distributions per detector region
     if (EmEnergy > 0) {
@@ -747,32 +754,8 @@ StatusCode PPrMon::fillHistograms()
     }
 	 
     //---------------------------- EM LUT HitMaps -----------------------------
-    for (unsigned int thresh = 0; thresh < m_TT_HitMap_ThreshVec.size(); ++thresh) {
-      if (EmEnergy > 0) {
-        unsigned int u_EmEnergy = static_cast<unsigned int>(EmEnergy); 
-        if (u_EmEnergy > m_TT_HitMap_ThreshVec[thresh]) {
-   	  m_histTool->fillPPMEmEtaVsPhi(m_v_ppm_em_2d_etaPhi_tt_lutcp_Threshold[thresh],
-	                                                            eta, phi, 1);
-	  if (m_environment == AthenaMonManager::online || m_onlineTest) {
-	    m_histTool->fillPPMEmEtaVsPhi(
-	      m_v_ppm_em_2d_etaPhi_tt_lutcp_Threshold[thresh+m_TT_HitMap_ThreshVec.size()],
-	      eta, phi, 1);
-          }
-        }
-      }
-      if (EmEnergy2 > 0) {
-        unsigned int u_EmEnergy2 = static_cast<unsigned int>(EmEnergy2); 
-        if (u_EmEnergy2 > m_TT_HitMap_ThreshVec[thresh]) {
-   	  m_histTool->fillPPMEmEtaVsPhi(m_v_ppm_em_2d_etaPhi_tt_lutjep_Threshold[thresh],
-	                                                            eta, phi, 1);
-	  if (m_environment == AthenaMonManager::online || m_onlineTest) {
-	    m_histTool->fillPPMEmEtaVsPhi(
-	      m_v_ppm_em_2d_etaPhi_tt_lutjep_Threshold[thresh+m_TT_HitMap_ThreshVec.size()],
-	      eta, phi, 1);
-          }
-        }
-      }
-    }
+    countEt(towerIndex, EmLutCp,  EmEnergy);
+    countEt(towerIndex, EmLutJep, EmEnergy2);
     
     //---------------------------- HAD Energy -----------------------------
     // had LUT peak per channel
@@ -806,32 +789,8 @@ StatusCode PPrMon::fillHistograms()
     }
     
     //---------------------------- had LUT HitMaps -----------------------------
-    for (unsigned int thresh = 0; thresh < m_TT_HitMap_ThreshVec.size(); ++thresh) {
-      if (HadEnergy > 0) {
-        unsigned int u_HadEnergy = static_cast<unsigned int>(HadEnergy);
-        if (u_HadEnergy > m_TT_HitMap_ThreshVec[thresh]) {
-	  m_histTool->fillPPMHadEtaVsPhi(m_v_ppm_had_2d_etaPhi_tt_lutcp_Threshold[thresh],
-	                                                            eta, phi, 1);
-          if (m_environment == AthenaMonManager::online || m_onlineTest) {
-	    m_histTool->fillPPMHadEtaVsPhi(
-	      m_v_ppm_had_2d_etaPhi_tt_lutcp_Threshold[thresh+m_TT_HitMap_ThreshVec.size()],
-	      eta, phi, 1);
-          }
-        }
-      }
-      if (HadEnergy2 > 0) {
-        unsigned int u_HadEnergy2 = static_cast<unsigned int>(HadEnergy2);
-        if (u_HadEnergy2 > m_TT_HitMap_ThreshVec[thresh]) {
-	  m_histTool->fillPPMHadEtaVsPhi(m_v_ppm_had_2d_etaPhi_tt_lutjep_Threshold[thresh],
-	                                                            eta, phi, 1);
-          if (m_environment == AthenaMonManager::online || m_onlineTest) {
-	    m_histTool->fillPPMHadEtaVsPhi(
-	      m_v_ppm_had_2d_etaPhi_tt_lutjep_Threshold[thresh+m_TT_HitMap_ThreshVec.size()],
-	      eta, phi, 1);
-          }
-        }
-      }
-    }
+    countEt(towerIndex, HadLutCp,  HadEnergy);
+    countEt(towerIndex, HadLutJep, HadEnergy2);
 
     //---------------------------- ADC HitMaps per timeslice -----------------
 
@@ -862,16 +821,14 @@ StatusCode PPrMon::fillHistograms()
     const std::vector<int>& emADC((*TriggerTowerIterator)->emADC());
     const std::vector<int>& hadADC((*TriggerTowerIterator)->hadADC());
 
-    double max = recTime(emADC, m_EMFADCCut);
-    //log << MSG::INFO << "TimeSlice of Maximum "<< max<< endreq ;
+    double max = m_emPeakFinder.peak(towerPos);
     if (max >= 0.) {
       m_histTool->fillPPMEmEtaVsPhi(m_h_ppm_em_2d_etaPhi_tt_adc_MaxTimeslice, eta, phi,
                                                                        max+1.);
       m_h_ppm_em_1d_tt_adc_MaxTimeslice->Fill(max);
     }
 
-    max = recTime(hadADC, m_HADFADCCut);
-    //log << MSG::INFO << "TimeSlice of Maximum "<< max<< endreq ;
+    max = m_hadPeakFinder.peak(towerPos);
     if (max >= 0.) {
       m_histTool->fillPPMHadEtaVsPhi(m_h_ppm_had_2d_etaPhi_tt_adc_MaxTimeslice, eta, phi,
                                                                        max+1.);
@@ -881,286 +838,282 @@ StatusCode PPrMon::fillHistograms()
     //------------------------ Signal shape profile --------------------------
 
     if (EmEnergy > 0) {
-      const int emPart  = partition(0, eta);
+      const int emPart  = tower.layer[0].partition;
       std::vector<int>::const_iterator it  = emADC.begin();
       std::vector<int>::const_iterator itE = emADC.end();
       for (int slice = 0; it != itE && slice < m_SliceNo; ++it, ++slice) {
-        m_v_ppm_1d_tt_adc_SignalProfile[emPart]->Fill(slice, *it);
+        m_signalProfiles.fill(emPart*m_SliceNo + slice, *it);
       }
     }
     if (HadEnergy > 0) {
-      const int hadPart = partition(1, eta);
+      const int hadPart = tower.layer[1].partition;
       std::vector<int>::const_iterator it  = hadADC.begin();
       std::vector<int>::const_iterator itE = hadADC.end();
       for (int slice = 0; it != itE && slice < m_SliceNo; ++it, ++slice) {
-        m_v_ppm_1d_tt_adc_SignalProfile[hadPart]->Fill(slice, *it);
+        m_signalProfiles.fill(hadPart*m_SliceNo + slice, *it);
       }
     }
 
     //---------------------------- SubStatus Word errors ---------------------
     //----------------------------- em ---------------------------------------
 
-    using LVL1::DataError;
-
-    if ((*TriggerTowerIterator)-> emError()) {
-
-      const DataError emerr((*TriggerTowerIterator)-> emError());
+    const int emError  = (*TriggerTowerIterator)->emError();
+    const int hadError = (*TriggerTowerIterator)->hadError();
+    if (emError)  fillErrors(emError,  tower.layer[0], overview);
+    if (hadError) fillErrors(hadError, tower.layer[1], overview);
+      
+    // number of triggered slice
+    m_h_ppm_em_1d_tt_adc_TriggeredSlice->Fill((*TriggerTowerIterator)->emADCPeak(), 1);
+    m_h_ppm_had_1d_tt_adc_TriggeredSlice->Fill((*TriggerTowerIterator)->hadADCPeak(), 1);
 
-      const L1CaloCoolChannelId emCoolId(m_ttTool->channelID(eta, phi, 0));
-      int crate     = emCoolId.crate();
-      int module    = emCoolId.module();
-      int submodule = emCoolId.subModule();
-      int channel   = emCoolId.channel();
+  }	     
+	     
+  // Update threshold hitmaps periodically online
 
-      // em signals Crate 0-3
-      //em+had FCAL signals get processed in one crate (Crates 4-7)
+  if ((m_environment == AthenaMonManager::online || m_onlineTest) &&
+       m_TT_HitMap_UpdateEvents > 0 &&
+       ++m_eventsSinceFlush >= m_TT_HitMap_UpdateEvents) {
+    flushHitMaps();
+    flushProfiles();
+  }
 
-      int ypos = (crate < 4) ? module+crate*16 : module+(crate-4)*16;
+  // Write overview vector to error board
+  m_errorBoard->set(TrigT1CaloErrorBoardTool::PPMError, overview);
+  
+  return StatusCode::SUCCESS;
+}
 
-      for (int bit = 0; bit < 8; ++bit) {
-        if (emerr.get(bit + DataError::ChannelDisabled)) {
-          if (crate < 4) m_h_ppm_2d_ErrorField03->Fill(bit, ypos);
-  	  else           m_h_ppm_2d_ErrorField47->Fill(bit, ypos);
-	  m_histTool->fillEventNumber(m_h_ppm_2d_ASICErrorEventNumbers, bit);
-        }
-        if (emerr.get(bit + DataError::GLinkParity)) {
-	  if (crate < 4) m_h_ppm_2d_Status03->Fill(bit, ypos);
-	  else           m_h_ppm_2d_Status47->Fill(bit, ypos);
-	  m_h_ppm_1d_ErrorSummary->Fill(bit);
-	  m_histTool->fillEventNumber(m_h_ppm_2d_ErrorEventNumbers, bit);
-        }
-      }
+/*---------------------------------------------------------*/
+StatusCode PPrMon::procHistograms()
+/*---------------------------------------------------------*/
+{
+  if (msgLvl(MSG::DEBUG)) msg(MSG::DEBUG) << "in procHistograms" << endreq;
 
-      if (emerr.get(DataError::ChannelDisabled) ||
-          emerr.get(DataError::MCMAbsent)) overview[crate] |= 1;
-
-      if (emerr.get(DataError::Timeout)       ||
-          emerr.get(DataError::ASICFull)      ||
-          emerr.get(DataError::EventMismatch) ||
-	  emerr.get(DataError::BunchMismatch) ||
-          emerr.get(DataError::FIFOCorrupt)   ||
-	  emerr.get(DataError::PinParity)) overview[crate] |= (1 << 1);
-
-      if (emerr.get(DataError::GLinkParity)   ||
-          emerr.get(DataError::GLinkProtocol) ||
-          emerr.get(DataError::FIFOOverflow)  ||
-	  emerr.get(DataError::ModuleError)   ||
-          emerr.get(DataError::GLinkDown)     ||
-	  emerr.get(DataError::GLinkTimeout)  ||
-	  emerr.get(DataError::BCNMismatch)) overview[crate] |= (1 << 2);
-
-      // Detailed plots by MCM
-      ypos = (crate%2)*16+module;
-      if (emerr.get(DataError::ChannelDisabled)) {
-        m_v_ppm_2d_ASICErrorsDetail[(channel/2)*4+crate/2]->Fill((channel%2)*16+submodule,
-                                                                          ypos);
-      }
-      if (emerr.get(DataError::MCMAbsent)) {
-        m_v_ppm_2d_ASICErrorsDetail[8+crate/2]->Fill(submodule, ypos);
-      }
-      if (emerr.get(DataError::Timeout)) {
-        m_v_ppm_2d_ASICErrorsDetail[12+crate/2]->Fill(submodule, ypos);
-      }
-      if (emerr.get(DataError::ASICFull)) {
-        m_v_ppm_2d_ASICErrorsDetail[12+crate/2]->Fill(16+submodule, ypos);
-      }
-      if (emerr.get(DataError::EventMismatch)) {
-        m_v_ppm_2d_ASICErrorsDetail[16+crate/2]->Fill(submodule, ypos);
-      }
-      if (emerr.get(DataError::BunchMismatch)) {
-        m_v_ppm_2d_ASICErrorsDetail[16+crate/2]->Fill(16+submodule, ypos);
-      }
-      if (emerr.get(DataError::FIFOCorrupt)) {
-        m_v_ppm_2d_ASICErrorsDetail[20+crate/2]->Fill(submodule, ypos);
-      }
-      if (emerr.get(DataError::PinParity)) {
-        m_v_ppm_2d_ASICErrorsDetail[20+crate/2]->Fill(16+submodule, ypos);
-      }
+  if (endOfLumiBlock || endOfRun) {
+    flushHitMaps();
+    flushProfiles();
+  }
 
+  if (endOfRun && m_lazyHists.enabled()) {
+    int registered = 0;
+    int dropped    = 0;
+    StatusCode sc = m_lazyHists.registerFilled(registered, dropped);
+    if (sc.isFailure()) {
+      msg(MSG::ERROR) << "Failed to register error detail histograms"
+                      << endreq;
+      return sc;
     }
-    
-    //had
-
-    if ((*TriggerTowerIterator)-> hadError()) {
-
-      const DataError haderr((*TriggerTowerIterator)-> hadError());
+    if (msgLvl(MSG::DEBUG)) {
+      msg(MSG::DEBUG) << "Error detail histograms written: " << registered
+                      << " omitted: " << dropped << endreq;
+    }
+  }
 
-      const L1CaloCoolChannelId hadCoolId(m_ttTool->channelID(eta, phi, 1));
-      int crate     = hadCoolId.crate();
-      int module    = hadCoolId.module();
-      int submodule = hadCoolId.subModule();
-      int channel   = hadCoolId.channel();
-      
-      int ypos = (crate < 4) ? module+crate*16 : module+(crate-4)*16;
+  return StatusCode::SUCCESS;
+}
 
-      for (int bit = 0; bit < 8; ++bit) {
-        if (haderr.get(bit + DataError::ChannelDisabled)) {
-	  if (crate < 4) m_h_ppm_2d_ErrorField03->Fill(bit, ypos);
-	  else           m_h_ppm_2d_ErrorField47->Fill(bit, ypos);
-	  m_histTool->fillEventNumber(m_h_ppm_2d_ASICErrorEventNumbers, bit);
-        }
-        if (haderr.get(bit + DataError::GLinkParity)) {
-	  if (crate < 4) m_h_ppm_2d_Status03->Fill(bit, ypos);
-	  else           m_h_ppm_2d_Status47->Fill(bit, ypos);
-	  m_h_ppm_1d_ErrorSummary->Fill(bit);
-	  m_histTool->fillEventNumber(m_h_ppm_2d_ErrorEventNumbers, bit);
-        }
-      }
+/*---------------------------------------------------------*/
+void PPrMon::countEt(int tower, int type, int et)
+/*---------------------------------------------------------*/
+{
+  if (et <= 0) return;
+  const int nBins = m_threshBin.size() + 1;
+  const int bin = (et < int(m_etBin.size())) ? m_etBin[et] : nBins - 1;
+  if (bin > 0) {
+    ++m_etCounts[(tower*MaxHitMapTypes + type)*nBins + bin];
+    m_etCountsFilled = true;
+  }
+}
 
-      if (haderr.get(DataError::ChannelDisabled) ||
-          haderr.get(DataError::MCMAbsent)) overview[crate] |= 1;
-
-      if (haderr.get(DataError::Timeout)       ||
-          haderr.get(DataError::ASICFull)      ||
-          haderr.get(DataError::EventMismatch) ||
-	  haderr.get(DataError::BunchMismatch) ||
-          haderr.get(DataError::FIFOCorrupt)   ||
-	  haderr.get(DataError::PinParity)) overview[crate] |= (1 << 1);
-
-      if (haderr.get(DataError::GLinkParity)   ||
-          haderr.get(DataError::GLinkProtocol) ||
-          haderr.get(DataError::FIFOOverflow)  ||
-	  haderr.get(DataError::ModuleError)   ||
-          haderr.get(DataError::GLinkDown)     ||
-	  haderr.get(DataError::GLinkTimeout)  ||
-	  haderr.get(DataError::BCNMismatch)) overview[crate] |= (1 << 2);
-    
-      // Detailed plots by MCM
-      ypos = (crate%2)*16+module;
-      if (haderr.get(DataError::ChannelDisabled)) {
-        m_v_ppm_2d_ASICErrorsDetail[(channel/2)*4+crate/2]->Fill((channel%2)*16+submodule,
-                                                                          ypos);
-      }
-      if (haderr.get(DataError::MCMAbsent)) {
-        m_v_ppm_2d_ASICErrorsDetail[8+crate/2]->Fill(submodule, ypos);
-      }
-      if (haderr.get(DataError::Timeout)) {
-        m_v_ppm_2d_ASICErrorsDetail[12+crate/2]->Fill(submodule, ypos);
-      }
-      if (haderr.get(DataError::ASICFull)) {
-        m_v_ppm_2d_ASICErrorsDetail[12+crate/2]->Fill(16+submodule, ypos);
-      }
-      if (haderr.get(DataError::EventMismatch)) {
-        m_v_ppm_2d_ASICErrorsDetail[16+crate/2]->Fill(submodule, ypos);
-      }
-      if (haderr.get(DataError::BunchMismatch)) {
-        m_v_ppm_2d_ASICErrorsDetail[16+crate/2]->Fill(16+submodule, ypos);
-      }
-      if (haderr.get(DataError::FIFOCorrupt)) {
-        m_v_ppm_2d_ASICErrorsDetail[20+crate/2]->Fill(submodule, ypos);
+/*---------------------------------------------------------*/
+void PPrMon::flushHitMaps()
+/*---------------------------------------------------------*/
+{
+  m_eventsSinceFlush = 0;
+  if (!m_histBooked || !m_etCountsFilled) return;
+
+  const bool online = (m_environment == AthenaMonManager::online ||
+                                                           m_onlineTest);
+  const int nThresh = m_threshBin.size();
+  const int nBins   = nThresh + 1;
+  const int current = (m_hitMapSlot + 1)*nThresh;
+  std::vector<TH2F_LW*>* hitMaps[MaxHitMapTypes];
+  hitMaps[EmLutCp]   = &m_v_ppm_em_2d_etaPhi_tt_lutcp_Threshold;
+  hitMaps[HadLutCp]  = &m_v_ppm_had_2d_etaPhi_tt_lutcp_Threshold;
+  hitMaps[EmLutJep]  = &m_v_ppm_em_2d_etaPhi_tt_lutjep_Threshold;
+  hitMaps[HadLutJep] = &m_v_ppm_had_2d_etaPhi_tt_lutjep_Threshold;
+  std::vector<uint32_t> sums(nBins + 1);
+
+  const int nTowers = TrigT1CaloTowerTableTool::numberOfTowers();
+  for (int tower = 0; tower < nTowers; ++tower) {
+    const TrigT1CaloTowerTableTool::Tower& tt(m_towerTable->tower(tower));
+    for (int type = 0; type < MaxHitMapTypes; ++type) {
+      uint32_t* counts = &m_etCounts[(tower*MaxHitMapTypes + type)*nBins];
+      sums[nBins] = 0;
+      for (int bin = nBins - 1; bin > 0; --bin) {
+        sums[bin] = sums[bin + 1] + counts[bin];
       }
-      if (haderr.get(DataError::PinParity)) {
-        m_v_ppm_2d_ASICErrorsDetail[20+crate/2]->Fill(16+submodule, ypos);
+      if (sums[1] == 0) continue;
+      const std::vector<TH2F_LW*>& hists(*hitMaps[type]);
+      const bool em = (type == EmLutCp || type == EmLutJep);
+      for (int thresh = 0; thresh < nThresh; ++thresh) {
+        const uint32_t hits = sums[m_threshBin[thresh] + 1];
+	if (hits == 0) continue;
+	if (em) {
+	  m_histTool->fillPPMEmEtaVsPhi(hists[thresh], tt.eta, tt.phi, hits);
+	  if (online) m_histTool->fillPPMEmEtaVsPhi(hists[thresh + current],
+	                                               tt.eta, tt.phi, hits);
+        } else {
+	  m_histTool->fillPPMHadEtaVsPhi(hists[thresh], tt.eta, tt.phi, hits);
+	  if (online) m_histTool->fillPPMHadEtaVsPhi(hists[thresh + current],
+	                                                tt.eta, tt.phi, hits);
+        }
       }
-
+      std::fill(counts, counts + nBins, 0);
     }
-      
-    // number of triggered slice
-    m_h_ppm_em_1d_tt_adc_TriggeredSlice->Fill((*TriggerTowerIterator)->emADCPeak(), 1);
-    m_h_ppm_had_1d_tt_adc_TriggeredSlice->Fill((*TriggerTowerIterator)->hadADCPeak(), 1);
-
-  }	     
-	     
-  // Write overview vector to StoreGate
-  std::vector<int>* save = new std::vector<int>(overview);
-  sc = evtStore()->record(save, "L1CaloPPMErrorVector");
-  if (sc != StatusCode::SUCCESS) {
-    msg(MSG::ERROR) << "Error recording PPM error vector in TES "
-                    << endreq;
-    return sc;
   }
-  
-  return StatusCode::SUCCESS;
+  m_etCountsFilled = false;
 }
 
 /*---------------------------------------------------------*/
-double PPrMon::recTime(const std::vector<int>& vFAdc, int cut) {
+void PPrMon::flushProfiles()
 /*---------------------------------------------------------*/
+{
+  if (!m_histBooked) return;
 
-  int max = -1;
-  const int slices = vFAdc.size();
-  if (slices > 0) {
-    max = 0.;
-    int maxAdc = vFAdc[0];
-    for (int sl = 1; sl < slices; ++sl) {
-      if (vFAdc[sl] > maxAdc) {
-        maxAdc = vFAdc[sl];
-        max = sl;
-      } else if (vFAdc[sl] == maxAdc) max = -1;
-    }
-    if (maxAdc == 0) max = -1;
+  for (int p = 0; p < TrigT1CaloTowerTableTool::MaxPartitions; ++p) {
+    m_signalProfiles.flush(m_v_ppm_1d_tt_adc_SignalProfile[p], p*m_SliceNo,
+                                                                m_SliceNo);
   }
-  if (max >= 0) {
-    int slbeg = max - 2;
-    if (slbeg < 0) slbeg = 0;
-    int slend = max + 3;
-    if (slend > slices) slend = slices;
-    int sum = 0;
-    int min = 999999;
-    for (int sl = slbeg; sl < slend; ++sl) {
-      int val = vFAdc[sl];
-      if (val < m_TT_ADC_Pedestal) val = m_TT_ADC_Pedestal;
-      sum += val;
-      if (val < min) min = val;
-    }
-    sum -= (slend-slbeg)*min;
-    if (sum <= cut) max = -1;
+}
+
+/*---------------------------------------------------------*/
+void PPrMon::lumiHitMapNames(int type, int thresh, int block, int lumiNumber,
+                             std::string& name, std::string& title)
+/*---------------------------------------------------------*/
+{
+  std::stringstream buffer;
+  std::stringstream buffer_name;
+  buffer_name << std::setw(2) << std::setfill('0') << thresh << "Lumi" << block;
+  if (lumiNumber < 0) buffer << m_TT_HitMap_ThreshVec[thresh] << ", Current Lumi-block";
+  else                buffer << m_TT_HitMap_ThreshVec[thresh] << ", Lumi-block " << lumiNumber;
+  switch (type) {
+    case EmLutCp:
+      name  = "ppm_em_2d_etaPhi_tt_lutcp_Thresh";
+      title = "#eta - #phi Map of EM LUT-CP > ";
+      break;
+    case HadLutCp:
+      name  = "ppm_had_2d_etaPhi_tt_lutcp_Thresh";
+      title = "#eta - #phi Map of HAD LUT-CP > ";
+      break;
+    case EmLutJep:
+      name  = "ppm_em_2d_etaPhi_tt_lutjep_Thresh";
+      title = "#eta - #phi Map of EM LUT-JEP > ";
+      break;
+    default:
+      name  = "ppm_had_2d_etaPhi_tt_lutjep_Thresh";
+      title = "#eta - #phi Map of HAD LUT-JEP > ";
+      break;
   }
-  
-  return double(max);
+  name  += buffer_name.str();
+  title += buffer.str();
 }
 
 /*---------------------------------------------------------*/
-int PPrMon::partition(int layer, double eta) {
+void PPrMon::rotateLumiHitMaps()
 /*---------------------------------------------------------*/
+{
+  // The slot after the current one holds the oldest lumiblock, so it
+  // becomes current and is cleared.  Nothing is copied or re-registered;
+  // its title gets the lumiblock number at the first event.
+
+  const int nThresh = m_TT_HitMap_ThreshVec.size();
+  const int nSlots  = m_TT_HitMap_LumiBlocks + 1;
+  m_hitMapSlot = (m_hitMapSlot + 1) % nSlots;
+  std::vector<TH2F_LW*>* hitMaps[MaxHitMapTypes];
+  hitMaps[EmLutCp]   = &m_v_ppm_em_2d_etaPhi_tt_lutcp_Threshold;
+  hitMaps[HadLutCp]  = &m_v_ppm_had_2d_etaPhi_tt_lutcp_Threshold;
+  hitMaps[EmLutJep]  = &m_v_ppm_em_2d_etaPhi_tt_lutjep_Threshold;
+  hitMaps[HadLutJep] = &m_v_ppm_had_2d_etaPhi_tt_lutjep_Threshold;
+  std::string name, title;
+  for (int type = 0; type < MaxHitMapTypes; ++type) {
+    std::vector<TH2F_LW*>& hists(*hitMaps[type]);
+    for (int thresh = 0; thresh < nThresh; ++thresh) {
+      TH2F_LW* hist = hists[(m_hitMapSlot + 1)*nThresh + thresh];
+      if (hist->GetEntries() > 0) hist->Reset();
+      lumiHitMapNames(type, thresh, m_hitMapSlot, -1, name, title);
+      hist->SetTitle(title.c_str());
+    }
+  }
+  m_hitMapTitlePending = true;
+}
 
-  int part = 0;
-  if (layer == 0) {
-    if      (eta < -3.2) part = LArFCAL1C;
-    else if (eta < -1.5) part = LArEMECC;
-    else if (eta < -1.4) part = LArOverlapC;
-    else if (eta <  0.0) part = LArEMBC;
-    else if (eta <  1.4) part = LArEMBA;
-    else if (eta <  1.5) part = LArOverlapA;
-    else if (eta <  3.2) part = LArEMECA;
-    else                 part = LArFCAL1A;
-  } else {
-    if      (eta < -3.2) part = LArFCAL23C;
-    else if (eta < -1.5) part = LArHECC;
-    else if (eta < -0.9) part = TileEBC;
-    else if (eta <  0.0) part = TileLBC;
-    else if (eta <  0.9) part = TileLBA;
-    else if (eta <  1.5) part = TileEBA;
-    else if (eta <  3.2) part = LArHECA;
-    else                 part = LArFCAL23A;
+/*---------------------------------------------------------*/
+void PPrMon::setLumiHitMapTitles(int lumiNumber)
+/*---------------------------------------------------------*/
+{
+  m_hitMapTitlePending = false;
+  if (!m_histBooked || (m_environment != AthenaMonManager::online &&
+                        !m_onlineTest)) return;
+  const int nThresh = m_TT_HitMap_ThreshVec.size();
+  std::vector<TH2F_LW*>* hitMaps[MaxHitMapTypes];
+  hitMaps[EmLutCp]   = &m_v_ppm_em_2d_etaPhi_tt_lutcp_Threshold;
+  hitMaps[HadLutCp]  = &m_v_ppm_had_2d_etaPhi_tt_lutcp_Threshold;
+  hitMaps[EmLutJep]  = &m_v_ppm_em_2d_etaPhi_tt_lutjep_Threshold;
+  hitMaps[HadLutJep] = &m_v_ppm_had_2d_etaPhi_tt_lutjep_Threshold;
+  std::string name, title;
+  for (int type = 0; type < MaxHitMapTypes; ++type) {
+    std::vector<TH2F_LW*>& hists(*hitMaps[type]);
+    for (int thresh = 0; thresh < nThresh; ++thresh) {
+      lumiHitMapNames(type, thresh, m_hitMapSlot, lumiNumber, name, title);
+      hists[(m_hitMapSlot + 1)*nThresh + thresh]->SetTitle(title.c_str());
+    }
   }
-  return part;
 }
 
 /*---------------------------------------------------------*/
-std::string PPrMon::partitionName(int part) {
+void PPrMon::fillErrors(int error,
+                        const TrigT1CaloTowerTableTool::Channel& chan,
+                        std::vector<int>& overview)
 /*---------------------------------------------------------*/
+{
+  const int crate     = chan.crate;
+  const int module    = chan.module;
+  const int submodule = chan.subModule;
+  const int channel   = chan.channel;
+  const int asic      = PPrErrorDecoder::asicBits(error);
+  const int status    = PPrErrorDecoder::statusBits(error);
+
+  // em signals Crate 0-3
+  //em+had FCAL signals get processed in one crate (Crates 4-7)
+
+  int ypos = (crate < 4) ? module+crate*16 : module+(crate-4)*16;
+
+  int bits = asic;
+  while (bits) {
+    const int bit = PPrErrorDecoder::nextBit(bits);
+    if (crate < 4) m_h_ppm_2d_ErrorField03->Fill(bit, ypos);
+    else           m_h_ppm_2d_ErrorField47->Fill(bit, ypos);
+    m_histTool->fillEventNumber(m_h_ppm_2d_ASICErrorEventNumbers, bit);
+  }
+  bits = status;
+  while (bits) {
+    const int bit = PPrErrorDecoder::nextBit(bits);
+    if (crate < 4) m_h_ppm_2d_Status03->Fill(bit, ypos);
+    else           m_h_ppm_2d_Status47->Fill(bit, ypos);
+    m_h_ppm_1d_ErrorSummary->Fill(bit);
+    m_histTool->fillEventNumber(m_h_ppm_2d_ErrorEventNumbers, bit);
+  }
 
-  std::string name = "";
-  switch (part) {
-    case LArFCAL1C:   name = "LArFCAL1C";   break;
-    case LArEMECC:    name = "LArEMECC";    break;
-    case LArOverlapC: name = "LArOverlapC"; break;
-    case LArEMBC:     name = "LArEMBC";     break;
-    case LArEMBA:     name = "LArEMBA";     break;
-    case LArOverlapA: name = "LArOverlapA"; break;
-    case LArEMECA:    name = "LArEMECA";    break;
-    case LArFCAL1A:   name = "LArFCAL1A";   break;
-    case LArFCAL23C:  name = "LArFCAL23C";  break;
-    case LArHECC:     name = "LArHECC";     break;
-    case TileEBC:     name = "TileEBC";     break;
-    case TileLBC:     name = "TileLBC";     break;
-    case TileLBA:     name = "TileLBA";     break;
-    case TileEBA:     name = "TileEBA";     break;
-    case LArHECA:     name = "LArHECA";     break;
-    case LArFCAL23A:  name = "LArFCAL23A";  break;
-    default:          name = "Unknown";     break;
+  overview[crate] |= m_errorDecoder.overview(asic, status);
+
+  // Detailed plots by MCM
+  ypos = (crate%2)*16+module;
+  bits = asic;
+  while (bits) {
+    const int bit = PPrErrorDecoder::nextBit(bits);
+    m_v_ppm_2d_ASICErrorsDetail[PPrErrorDecoder::detailBlock(bit, channel)*4
+                                                                 + crate/2]
+             ->Fill(PPrErrorDecoder::detailX(bit, channel, submodule), ypos);
   }
-  return name;
 }
-
@@ -0,0 +1,227 @@
+// ********************************************************************
+//
+// NAME:     PPrPeakFinder.cxx
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+
+#include <algorithm>
+#include <climits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "TrigT1CaloMonitoring/PPrPeakFinder.h"
+
+/*---------------------------------------------------------*/
+PPrPeakFinder::PPrPeakFinder()
+  : m_vectorised(true),
+    m_slices(0),
+    m_towers(0),
+    m_stride(0)
+/*---------------------------------------------------------*/
+{
+}
+
+/*---------------------------------------------------------*/
+void PPrPeakFinder::clear(int slices, int towers)
+/*---------------------------------------------------------*/
+{
+  m_slices = (slices > 0) ? slices : 0;
+  m_towers = 0;
+  m_stride = ((towers + s_lanes - 1)/s_lanes)*s_lanes;
+  const unsigned int size = m_slices*m_stride;
+  if (m_adc.size() != size) m_adc.resize(size);
+  m_others.clear();
+}
+
+/*---------------------------------------------------------*/
+int PPrPeakFinder::add(const std::vector<int>& adc)
+/*---------------------------------------------------------*/
+{
+  const int pos = m_towers++;
+  if (int(adc.size()) != m_slices || pos >= m_stride) {
+    m_others.push_back(std::make_pair(pos, &adc));
+  } else {
+    for (int sl = 0; sl < m_slices; ++sl) m_adc[sl*m_stride + pos] = adc[sl];
+  }
+  return pos;
+}
+
+/*---------------------------------------------------------*/
+void PPrPeakFinder::process(int pedestal, int cut)
+/*---------------------------------------------------------*/
+{
+  const int buffered = std::min(m_towers, m_stride);
+  const int size     = std::max(m_towers, m_stride);
+  m_peak.assign(size, -1);
+
+  if (m_slices > 0 && buffered > 0) {
+
+    // Zero padding so unused lanes find no peak
+
+    for (int sl = 0; sl < m_slices; ++sl) {
+      std::fill(m_adc.begin() + sl*m_stride + buffered,
+                m_adc.begin() + (sl + 1)*m_stride, 0);
+    }
+    const int done = (m_vectorised) ? processVector(pedestal, cut) : 0;
+    processScalar(done, buffered, pedestal, cut);
+  }
+
+  std::vector<std::pair<int, const std::vector<int>*> >::const_iterator it =
+                                                          m_others.begin();
+  std::vector<std::pair<int, const std::vector<int>*> >::const_iterator itE =
+                                                          m_others.end();
+  for (; it != itE; ++it) {
+    m_peak[it->first] = peak(*(it->second), pedestal, cut);
+  }
+}
+
+/*---------------------------------------------------------*/
+int PPrPeakFinder::peak(const std::vector<int>& adc, int pedestal, int cut)
+/*---------------------------------------------------------*/
+{
+  int max = -1;
+  const int slices = adc.size();
+  if (slices > 0) {
+    max = 0;
+    int maxAdc = adc[0];
+    for (int sl = 1; sl < slices; ++sl) {
+      if (adc[sl] > maxAdc) {
+        maxAdc = adc[sl];
+        max = sl;
+      } else if (adc[sl] == maxAdc) max = -1;
+    }
+    if (maxAdc == 0) max = -1;
+  }
+  if (max >= 0) {
+    int slbeg = max - 2;
+    if (slbeg < 0) slbeg = 0;
+    int slend = max + 3;
+    if (slend > slices) slend = slices;
+    int sum = 0;
+    int min = INT_MAX;
+    for (int sl = slbeg; sl < slend; ++sl) {
+      int val = adc[sl];
+      if (val < pedestal) val = pedestal;
+      sum += val;
+      if (val < min) min = val;
+    }
+    sum -= (slend-slbeg)*min;
+    if (sum <= cut) max = -1;
+  }
+  return max;
+}
+
+/*---------------------------------------------------------*/
+void PPrPeakFinder::processScalar(int first, int last, int pedestal, int cut)
+/*---------------------------------------------------------*/
+{
+  for (int pos = first; pos < last; ++pos) {
+    const int* adc = &m_adc[pos];
+    int maxAdc = adc[0];
+    int maxSl  = 0;
+    bool tie   = false;
+    for (int sl = 1; sl < m_slices; ++sl) {
+      const int val = adc[sl*m_stride];
+      if (val > maxAdc) {
+        maxAdc = val;
+	maxSl  = sl;
+	tie    = false;
+      } else if (val == maxAdc) tie = true;
+    }
+    if (tie || maxAdc == 0) continue;
+    const int slbeg = std::max(maxSl - 2, 0);
+    const int slend = std::min(maxSl + 3, m_slices);
+    int sum = 0;
+    int min = INT_MAX;
+    for (int sl = slbeg; sl < slend; ++sl) {
+      const int val = std::max(adc[sl*m_stride], pedestal);
+      sum += val;
+      if (val < min) min = val;
+    }
+    sum -= (slend-slbeg)*min;
+    if (sum > cut) m_peak[pos] = maxSl;
+  }
+}
+
+/*---------------------------------------------------------*/
+int PPrPeakFinder::processVector(int pedestal, int cut)
+/*---------------------------------------------------------*/
+{
+#if defined(__SSE2__)
+
+  // Branch-free version of processScalar for s_lanes towers at a time.
+  // The window signal is summed as (value - window minimum) per slice
+  // which equals the scalar sum less width times minimum.
+
+  const int buffered = std::min(m_towers, m_stride);
+  const __m128i ped   = _mm_set1_epi32(pedestal);
+  const __m128i cutv  = _mm_set1_epi32(cut);
+  const __m128i zero  = _mm_setzero_si128();
+  const __m128i ones  = _mm_cmpeq_epi32(zero, zero);
+  const __m128i two   = _mm_set1_epi32(2);
+  const __m128i large = _mm_set1_epi32(INT_MAX);
+  int pos = 0;
+  for (; pos < buffered; pos += s_lanes) {
+    const int* adc = &m_adc[pos];
+
+    // Maximum slice and tie flag
+    __m128i maxAdc = _mm_loadu_si128((const __m128i*)adc);
+    __m128i maxSl  = zero;
+    __m128i tie    = zero;
+    for (int sl = 1; sl < m_slices; ++sl) {
+      const __m128i val = _mm_loadu_si128((const __m128i*)(adc + sl*m_stride));
+      const __m128i gt  = _mm_cmpgt_epi32(val, maxAdc);
+      const __m128i eq  = _mm_cmpeq_epi32(val, maxAdc);
+      maxAdc = _mm_or_si128(_mm_and_si128(gt, val), _mm_andnot_si128(gt, maxAdc));
+      maxSl  = _mm_or_si128(_mm_and_si128(gt, _mm_set1_epi32(sl)),
+                            _mm_andnot_si128(gt, maxSl));
+      tie    = _mm_andnot_si128(gt, _mm_or_si128(tie, eq));
+    }
+
+    // Window minimum of pedestal clamped values
+    const __m128i lo = _mm_sub_epi32(maxSl, two);
+    const __m128i hi = _mm_add_epi32(maxSl, two);
+    __m128i min = large;
+    for (int sl = 0; sl < m_slices; ++sl) {
+      const __m128i slv = _mm_set1_epi32(sl);
+      const __m128i in  = _mm_andnot_si128(_mm_or_si128(_mm_cmpgt_epi32(lo, slv),
+                                           _mm_cmpgt_epi32(slv, hi)), ones);
+      __m128i val = _mm_loadu_si128((const __m128i*)(adc + sl*m_stride));
+      const __m128i low = _mm_cmpgt_epi32(ped, val);
+      val = _mm_or_si128(_mm_and_si128(low, ped), _mm_andnot_si128(low, val));
+      const __m128i lt  = _mm_and_si128(in, _mm_cmpgt_epi32(min, val));
+      min = _mm_or_si128(_mm_and_si128(lt, val), _mm_andnot_si128(lt, min));
+    }
+
+    // Window signal
+    __m128i sum = zero;
+    for (int sl = 0; sl < m_slices; ++sl) {
+      const __m128i slv = _mm_set1_epi32(sl);
+      const __m128i in  = _mm_andnot_si128(_mm_or_si128(_mm_cmpgt_epi32(lo, slv),
+                                           _mm_cmpgt_epi32(slv, hi)), ones);
+      __m128i val = _mm_loadu_si128((const __m128i*)(adc + sl*m_stride));
+      const __m128i low = _mm_cmpgt_epi32(ped, val);
+      val = _mm_or_si128(_mm_and_si128(low, ped), _mm_andnot_si128(low, val));
+      sum = _mm_add_epi32(sum, _mm_and_si128(in, _mm_sub_epi32(val, min)));
+    }
+
+    // No peak if tied, zero, or signal not above cut
+    const __m128i noPeak = _mm_or_si128(_mm_cmpeq_epi32(maxAdc, zero), tie);
+    const __m128i reject = _mm_or_si128(noPeak,
+                           _mm_andnot_si128(_mm_cmpgt_epi32(sum, cutv), ones));
+    const __m128i peak   = _mm_or_si128(reject, maxSl);
+    _mm_storeu_si128((__m128i*)&m_peak[pos], peak);
+  }
+  return pos;
+
+#else
+
+  (void)pedestal;
+  (void)cut;
+  return 0;
+
+#endif
+}
@@ -16,7 +16,6 @@
 
 #include "GaudiKernel/MsgStream.h"
 #include "GaudiKernel/StatusCode.h"
-#include "SGTools/StlVectorClids.h"
 
 #include "AthenaMonitoring/AthenaMonManager.h"
 
@@ -56,6 +55,8 @@ PPrSpareMon::PPrSpareMon(const std::string & type, const std::string & name,
                   m_PathInRootFile="L1Calo/PPM/SpareChannels") ;
   declareProperty("ErrorPathInRootFile",
                   m_ErrorPathInRootFile="L1Calo/PPM/SpareChannels/Errors") ;
+  declareProperty("LazyBooking", m_lazyBooking = false,
+        "Only write error detail histograms which are filled (offline)");
 
 }
 
@@ -123,6 +124,9 @@ StatusCode PPrSpareMon::bookHistogramsRecurrent()
                                                                 "eventSample" );
     MonGroup TT_ErrorDetail(this, m_ErrorPathInRootFile+"/Detail", run, attr);
 
+    m_lazyHists.setup(m_lazyBooking &&
+                      m_environment != AthenaMonManager::online);
+
     std::string name,title;
     std::stringstream buffer;
 
@@ -214,6 +218,20 @@ StatusCode PPrSpareMon::bookHistogramsRecurrent()
 	m_v_ppmspare_2d_ASICErrorsDetail.push_back(hist);
       }
     }
+    StatusCode sc = m_lazyHists.defer(m_v_ppmspare_2d_ASICErrorsDetail,
+                                                         TT_ErrorDetail);
+    if (sc.isSuccess()) {
+      sc = m_lazyHists.defer(m_h_ppmspare_2d_ErrorEventNumbers, TT_ErrorEvents);
+    }
+    if (sc.isSuccess()) {
+      sc = m_lazyHists.defer(m_h_ppmspare_2d_ASICErrorEventNumbers,
+                                                         TT_ErrorEvents);
+    }
+    if (sc.isFailure()) {
+      msg(MSG::ERROR) << "Failed to deregister error detail histograms"
+                      << endreq;
+      return sc;
+    }
 	  
     //--------------------- number of triggered slice ------------------------
     m_histTool->setMonGroup(&TT_ADC);
@@ -299,73 +317,42 @@ StatusCode PPrSpareMon::fillHistograms()
 
     //------------------------ SubStatus Word errors -------------------------
 
-    if ((*TriggerTowerIterator)-> emError()) {
+    const int error = (*TriggerTowerIterator)->emError();
+    if (error) {
 
-      using LVL1::DataError;
-      const DataError error((*TriggerTowerIterator)-> emError());
+      const int asic   = PPrErrorDecoder::asicBits(error);
+      const int status = PPrErrorDecoder::statusBits(error);
    
       //Summary
 
       int ypos = module+(crate-2)*16;
 
-      for (int bit = 0; bit < 8; ++bit) {
-        if (error.get(bit + DataError::ChannelDisabled)) {
-          m_h_ppmspare_2d_ErrorField25->Fill(bit, ypos);
- 	  m_histTool->fillEventNumber(m_h_ppmspare_2d_ASICErrorEventNumbers, bit);
-        }
-        if (error.get(bit + DataError::GLinkParity)) {
-          m_h_ppmspare_2d_Status25->Fill(bit, ypos);
-	  m_h_ppmspare_1d_ErrorSummary->Fill(bit);
-	  m_histTool->fillEventNumber(m_h_ppmspare_2d_ErrorEventNumbers, bit);
-        }
+      int bits = asic;
+      while (bits) {
+        const int bit = PPrErrorDecoder::nextBit(bits);
+        m_h_ppmspare_2d_ErrorField25->Fill(bit, ypos);
+ 	m_histTool->fillEventNumber(m_h_ppmspare_2d_ASICErrorEventNumbers, bit);
+      }
+      bits = status;
+      while (bits) {
+        const int bit = PPrErrorDecoder::nextBit(bits);
+        m_h_ppmspare_2d_Status25->Fill(bit, ypos);
+	m_h_ppmspare_1d_ErrorSummary->Fill(bit);
+	m_histTool->fillEventNumber(m_h_ppmspare_2d_ErrorEventNumbers, bit);
       }
 
       // Detailed plots by MCM
       ypos = (crate%2)*16+module;
       const int index = (crate-2)/2;
-      if (error.get(DataError::ChannelDisabled)) {
-        m_v_ppmspare_2d_ASICErrorsDetail[(channel/2)*4+index]->Fill(
-                                               (channel%2)*16+submodule, ypos);
-      }
-      if (error.get(DataError::MCMAbsent)) {
-        m_v_ppmspare_2d_ASICErrorsDetail[4+index]->Fill(submodule, ypos);
-      }
-      if (error.get(DataError::Timeout)) {
-        m_v_ppmspare_2d_ASICErrorsDetail[6+index]->Fill(submodule, ypos);
-      }
-      if (error.get(DataError::ASICFull)) {
-        m_v_ppmspare_2d_ASICErrorsDetail[6+index]->Fill(16+submodule, ypos);
-      }
-      if (error.get(DataError::EventMismatch)) {
-        m_v_ppmspare_2d_ASICErrorsDetail[8+index]->Fill(submodule, ypos);
-      }
-      if (error.get(DataError::BunchMismatch)) {
-        m_v_ppmspare_2d_ASICErrorsDetail[8+index]->Fill(16+submodule, ypos);
-      }
-      if (error.get(DataError::FIFOCorrupt)) {
-        m_v_ppmspare_2d_ASICErrorsDetail[10+index]->Fill(submodule, ypos);
-      }
-      if (error.get(DataError::PinParity)) {
-        m_v_ppmspare_2d_ASICErrorsDetail[10+index]->Fill(16+submodule, ypos);
+      bits = asic;
+      while (bits) {
+        const int bit = PPrErrorDecoder::nextBit(bits);
+        m_v_ppmspare_2d_ASICErrorsDetail[
+	                   PPrErrorDecoder::detailBlock(bit, channel)*2 + index]
+	       ->Fill(PPrErrorDecoder::detailX(bit, channel, submodule), ypos);
       }
 
-      if (error.get(DataError::ChannelDisabled) ||
-          error.get(DataError::MCMAbsent)) overview[crate] |= 1;
-
-      if (error.get(DataError::Timeout)       ||
-          error.get(DataError::ASICFull)      ||
-          error.get(DataError::EventMismatch) ||
-	  error.get(DataError::BunchMismatch) ||
-          error.get(DataError::FIFOCorrupt)   ||
-	  error.get(DataError::PinParity)) overview[crate] |= (1 << 1);
-
-      if (error.get(DataError::GLinkParity)   ||
-          error.get(DataError::GLinkProtocol) ||
-          error.get(DataError::FIFOOverflow)  ||
-	  error.get(DataError::ModuleError)   ||
-          error.get(DataError::GLinkDown)     ||
-	  error.get(DataError::GLinkTimeout)  ||
-          error.get(DataError::BCNMismatch)) overview[crate] |= (1 << 2);
+      overview[crate] |= m_errorDecoder.overview(asic, status);
      
      }
 
@@ -374,15 +361,9 @@ StatusCode PPrSpareMon::fillHistograms()
 
   }	     
      
-  // Write overview vector to StoreGate
-  //std::vector<int>* save = new std::vector<int>(overview);
-  //sc = evtStore()->record(save, "L1CaloPPMSpareErrorVector");
-  //if (sc != StatusCode::SUCCESS)
-  //  {
-  //    msg(MSG::ERROR) << "Error recording PPMSpare error vector in TES "
-  //                    << endreq;
-  //    return sc;
-  //  }
+  // Write overview vector to error board
+  // (disabled; needs a TrigT1CaloErrorBoardTool handle when re-enabled)
+  //m_errorBoard->set(TrigT1CaloErrorBoardTool::PPMSpareError, overview);
   
   return StatusCode::SUCCESS;
 }
@@ -396,6 +377,19 @@ StatusCode PPrSpareMon::procHistograms()
   msg(MSG::DEBUG) << "in procHistograms" << endreq ;
 
   if( endOfLumiBlock || endOfRun ) { }
+
+  if (endOfRun && m_lazyHists.enabled()) {
+    int registered = 0;
+    int dropped    = 0;
+    StatusCode sc = m_lazyHists.registerFilled(registered, dropped);
+    if (sc.isFailure()) {
+      msg(MSG::ERROR) << "Failed to register error detail histograms"
+                      << endreq;
+      return sc;
+    }
+    msg(MSG::DEBUG) << "Error detail histograms written: " << registered
+                    << " omitted: " << dropped << endreq;
+  }
 	
   return StatusCode::SUCCESS;
 }
@@ -1,3 +1,10 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+#include "LWHists/TProfile_LW.h"
+#include "LWHists/TProfile2D_LW.h"
 
 #include "GaudiKernel/MsgStream.h"
 #include "GaudiKernel/StatusCode.h"
@@ -8,9 +15,12 @@
 #include "EventInfo/EventID.h"
 
 #include "TrigT1CaloMonitoring/PPrStabilityMon.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloTimeSeriesFile.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloTowerTableTool.h"
 #include "TrigT1CaloMonitoringTools/TrigT1CaloMonErrorTool.h"
 #include "TrigT1CaloMonitoringTools/TrigT1CaloLWHistogramTool.h"
 #include "TrigT1CaloToolInterfaces/IL1TriggerTowerTool.h"
+#include "TrigT1CaloCalibToolInterfaces/IL1CaloMonitoringCaloTool.h"
 #include "TrigT1CaloCalibConditions/L1CaloCoolChannelId.h"
 #include "TrigT1CaloCalibTools/L1CaloPprFineTimePlotManager.h"
 #include "TrigT1CaloCalibTools/L1CaloPprPedestalPlotManager.h"
@@ -18,12 +28,23 @@
 
 #include "TrigT1CaloEvent/TriggerTowerCollection.h"
 
+namespace {
+
+// Compact store names, titles and directories by quantity
+const char* const storeNames[]  = { "pedestal", "fineTime", "etCorrelation" };
+const char* const storeTitles[] = { "Pedestal", "Fine Time", "Et Correlation" };
+const char* const storeDirs[]   = { "/Pedestal", "/FineTime", "/EtCorrelation" };
+
+}
+
 PPrStabilityMon::PPrStabilityMon(const std::string & type, const std::string & name, const IInterface* parent): ManagedMonitorToolBase ( type, name, parent ),
     m_ppmADCMinValue(0),
     m_lumiBlockMax(0),
     m_errorTool("TrigT1CaloMonErrorTool"),
     m_histTool("TrigT1CaloLWHistogramTool"),
     m_ttTool("LVL1::L1TriggerTowerTool/L1TriggerTowerTool"),
+    m_towerTable("TrigT1CaloTowerTableTool"),
+    m_caloTool("LVL1::L1CaloMonitoringCaloTool/L1CaloMonitoringCaloTool"),
     m_fineTimePlotManager(0),
     m_pedestalPlotManager(0),
     m_etCorrelationPlotManager(0),
@@ -33,7 +54,16 @@ PPrStabilityMon::PPrStabilityMon(const std::string & type, const std::string & n
     m_evtInfo(0),
     m_fineTimeCut(0),
     m_pedestalMaxWidth(0),
-    m_EtMinForEtCorrelation(0)
+    m_EtMinForEtCorrelation(0),
+    m_useStores(false),
+    m_storeCaloCells(false),
+    m_h_ppm_1d_stability_SamplingFraction(0),
+    m_conditionsValid(false),
+    m_conditionsLoads(0),
+    m_events(0),
+    m_runNumber(0),
+    m_lumiBlock(-1),
+    m_storeLumiBlockDone(-1)
 {
   declareProperty("BS_TriggerTowerContainer", m_TriggerTowerContainerName = "LVL1TriggerTowers");
   declareProperty("ppmADCMinValue", m_ppmADCMinValue=60,
@@ -54,6 +84,18 @@ PPrStabilityMon::PPrStabilityMon(const std::string & type, const std::string & n
                   "Minimum Et cut for Et correlation");
   declareProperty("doCaloQualCut", m_doCaloQualCut=true,
                   "Switch for calo quality cut via job options in fine time");
+  declareProperty("CompactStore", m_compactStore = false,
+                  "Use compact stores instead of plot managers");
+  declareProperty("ChannelPlots", m_channelPlots,
+                  "COOL channel IDs for per-channel plots from compact stores");
+  declareProperty("CaloQualityMax", m_caloQualityMax = 4000.,
+                  "Maximum calo quality for fine time with calo quality cut, compact store only");
+  declareProperty("TimeSeriesFile", m_timeSeriesFile = "",
+                  "Time-series file name prefix, empty for none");
+  declareProperty("CpuBudget", m_cpuBudget = 0.,
+                  "Processing seconds per second budget, 0 for no sampling");
+  declareProperty("SamplingWindow", m_samplingWindow = 10,
+                  "Sampling prescale adjustment interval in seconds");
 }
 
 PPrStabilityMon::~PPrStabilityMon()
@@ -84,8 +126,25 @@ StatusCode PPrStabilityMon::initialize()
     
     sc = m_ttTool.retrieve();
     if( sc.isFailure() ) {msg(MSG::ERROR) << "Unable to locate Tool L1TriggerTowerTool" << endreq;return sc;}
+
+    sc = m_towerTable.retrieve();
+    if( sc.isFailure() ) {msg(MSG::ERROR) << "Unable to locate Tool TrigT1CaloTowerTableTool" << endreq;return sc;}
         
-    if (m_doFineTimeMonitoring)
+    m_useStores = m_compactStore || !m_timeSeriesFile.empty();
+    if (m_useStores) {
+        const int nChannels = 2*TrigT1CaloTowerTableTool::numberOfTowers();
+        if (m_doPedestalMonitoring) m_stats[Pedestal].setup(nChannels, m_lumiBlockMax);
+        if (m_doFineTimeMonitoring) m_stats[FineTime].setup(nChannels, m_lumiBlockMax);
+        if (m_doEtCorrelationMonitoring) m_stats[EtCorrelation].setup(nChannels, m_lumiBlockMax);
+        m_storeCaloCells = m_doEtCorrelationMonitoring ||
+                           (m_doFineTimeMonitoring && m_doCaloQualCut);
+        if (m_storeCaloCells) {
+            sc = m_caloTool.retrieve();
+            if( sc.isFailure() ) {msg(MSG::ERROR) << "Unable to locate Tool L1CaloMonitoringCaloTool" << endreq;return sc;}
+        }
+    }
+
+    if (m_doFineTimeMonitoring && !m_compactStore)
     {
         m_fineTimePlotManager = new L1CaloPprFineTimePlotManager(this,
 								m_ttTool,
@@ -96,7 +155,7 @@ StatusCode PPrStabilityMon::initialize()
 	m_fineTimePlotManager->SetPpmAdcMaxValue(m_ppmADCMaxValue); 
 	m_fineTimePlotManager->EnableCaloQualCut(m_doCaloQualCut);
     }
-    if (m_doPedestalMonitoring)
+    if (m_doPedestalMonitoring && !m_compactStore)
     {
         m_pedestalPlotManager = new L1CaloPprPedestalPlotManager(this,
 								m_ttTool,
@@ -104,13 +163,14 @@ StatusCode PPrStabilityMon::initialize()
 								m_PathInRootFile+"/Pedestal");
 	m_pedestalPlotManager->SetPedestalMaxWidth(m_pedestalMaxWidth);
     }
-    if (m_doEtCorrelationMonitoring){
+    if (m_doEtCorrelationMonitoring && !m_compactStore){
         m_etCorrelationPlotManager = new L1CaloPprEtCorrelationPlotManager(this,
 								m_ttTool,
 								m_lumiBlockMax,
 								m_PathInRootFile+"/EtCorrelation");
 	m_etCorrelationPlotManager->SetEtMin(m_EtMinForEtCorrelation);
     }
+    m_sampler.setup(m_cpuBudget, m_samplingWindow);
     
     return StatusCode::SUCCESS;
     
@@ -118,12 +178,46 @@ StatusCode PPrStabilityMon::initialize()
 
 StatusCode PPrStabilityMon::finalize()
 {
+    msg(MSG::DEBUG) << "Conditions loaded " << m_conditionsLoads
+                    << " times in " << m_events << " events" << endreq;
+    if (m_sampler.enabled()) {
+        msg(MSG::DEBUG) << "Sampling prescale changed " << m_sampler.changes()
+                        << " times, final prescale " << m_sampler.prescale()
+                        << endreq;
+    }
     if (m_doFineTimeMonitoring) {delete m_fineTimePlotManager;}
     if (m_doPedestalMonitoring) {delete m_pedestalPlotManager;}
     if (m_doEtCorrelationMonitoring) {delete m_etCorrelationPlotManager;}
     return StatusCode::SUCCESS;
 }
 
+StatusCode PPrStabilityMon::bookHistogramsRecurrent()
+{
+    // Conditions change at most at lumiblock boundaries
+    if (newLumiBlock || newRun) m_conditionsValid = false;
+
+    if (newRun) {
+        StatusCode sc = m_towerTable->update();
+        if (sc.isFailure()) {msg(MSG::ERROR) << "Failed to build tower table" << endreq; return sc;}
+        if (m_useStores) {
+            for (int q = 0; q < MaxStores; ++q) m_stats[q].clear();
+            m_storeLumiBlockDone = -1;
+        }
+        if (m_compactStore) bookStoreHists();
+        if (m_sampler.enabled()) {
+            MgmtAttr_t attr = ATTRIB_UNMANAGED;
+            MonGroup monSample(this, m_PathInRootFile, run, attr);
+            m_histTool->setMonGroup(&monSample);
+            m_h_ppm_1d_stability_SamplingFraction = m_histTool->bookProfile(
+              "ppm_1d_stability_SamplingFraction",
+              "Fraction of Events Sampled by Lumiblock;Lumiblock;Fraction",
+              m_lumiBlockMax, 0, m_lumiBlockMax);
+            m_histTool->unsetMonGroup();
+        }
+    }
+    return StatusCode::SUCCESS;
+}
+
 StatusCode PPrStabilityMon::fillHistograms()
 {
     const bool debug = msgLvl(MSG::DEBUG);
@@ -137,6 +231,22 @@ StatusCode PPrStabilityMon::fillHistograms()
     m_evtInfo = 0;
     sc = evtStore()->retrieve(m_evtInfo);
     if( sc.isFailure() ) { msg(MSG::ERROR) <<"Could not retrieve Event Info" <<endreq; return sc;}
+    // Without EventID keep the last run and lumiblock
+    const EventID* evID = (m_evtInfo) ? m_evtInfo->event_ID() : 0;
+    if (evID) {
+        m_runNumber = evID->run_number();
+        m_lumiBlock = evID->lumi_block();
+    } else if (debug) msg(MSG::DEBUG) << "No EventID found" << endreq;
+    const int lumiBlock = m_lumiBlock;
+
+    // Prescale to stay within time budget, sampling events without EventID
+    if (m_sampler.enabled()) {
+        const bool sampled = m_sampler.accept((evID) ? evID->event_number() : 0);
+        if (evID) {
+            m_h_ppm_1d_stability_SamplingFraction->Fill(lumiBlock, (sampled) ? 1. : 0.);
+        }
+        if (!sampled) return StatusCode::SUCCESS;
+    }
    
     //Retrieve TriggerTowers from SG
     const TriggerTowerCollection* trigTwrColl = 0; 
@@ -149,16 +259,24 @@ StatusCode PPrStabilityMon::fillHistograms()
     }
     if (debug) msg(MSG::DEBUG)<<"In Fill histograms"<<endreq;
     
-    if (m_doEtCorrelationMonitoring) {
+    if (m_etCorrelationPlotManager) {
         sc = m_etCorrelationPlotManager->getCaloCells();
 	if (sc.isFailure()) return sc;
     }
+    if (m_storeCaloCells) {
+        sc = m_caloTool->loadCaloCells();
+	if (sc.isFailure()) return sc;
+    }
     
-    //load the CaloCells and the Reference Value folder from COOL (or an sqlite file) in case you want to monitor the fine time
-    if (m_doFineTimeMonitoring){
-       //load the standalone sqlite db containing the fine time references and calibration values
-      sc = m_ttTool->loadFTRefs();
+    //load the Reference Value folder from COOL (or an sqlite file) and disabled channels once per lumiblock
+    if (!m_conditionsValid) {
+      sc = loadConditions();
       if (sc.isFailure()) {msg(MSG::WARNING) << "Failed to load FineTimeReference Folder"<< endreq; return sc;}
+    }
+    ++m_events;
+
+    //load the CaloCells in case you want to monitor the fine time
+    if (m_fineTimePlotManager){
       //if you want to use the calo quality cut also load the calo cell container
       if(m_doCaloQualCut){
 	StatusCode sc2 = m_fineTimePlotManager->getCaloCells();
@@ -176,13 +294,13 @@ StatusCode PPrStabilityMon::fillHistograms()
         const double eta = (*TriggerTowerIterator)->eta();
         const double phi = (*TriggerTowerIterator)->phi();
 
-        const L1CaloCoolChannelId emCoolChannelID = m_ttTool->channelID(eta,phi,0);
-        const L1CaloCoolChannelId hadCoolChannelID = m_ttTool->channelID(eta,phi,1);
-
-        bool emDead = m_ttTool->disabledChannel(emCoolChannelID);
-        bool hadDead= m_ttTool->disabledChannel(hadCoolChannelID);
+        const int index = m_towerTable->index(eta,phi);
+        const bool emDead  = m_channelDisabled[2*index];
+        const bool hadDead = m_channelDisabled[2*index+1];
 		
-        if (m_doFineTimeMonitoring) {
+        if (m_useStores) fillStores(*TriggerTowerIterator, index, lumiBlock);
+		
+        if (m_fineTimePlotManager) {
 	      
             // Need signal
 	    int emPeak  = (*TriggerTowerIterator)->emADCPeak();
@@ -193,7 +311,7 @@ StatusCode PPrStabilityMon::fillHistograms()
 
 	        //Set the reference and calibration values for the fine time, they are stored per cool ID in a data base
 	        if (emPeakVal > m_ppmADCMinValue) {
-	            std::pair<double, double> emRef = m_ttTool->refValues(emCoolChannelID);
+	            const std::pair<double, double>& emRef = m_fineTimeRefs[2*index];
 	            double emReference = emRef.first;
 	            double emCalFactor = emRef.second;
 
@@ -201,7 +319,7 @@ StatusCode PPrStabilityMon::fillHistograms()
 	            m_fineTimePlotManager->SetEmCalibrationFactor(emCalFactor);
 	        }
 	        if (hadPeakVal > m_ppmADCMinValue) {
-	            std::pair<double, double> hadRef = m_ttTool->refValues(hadCoolChannelID);
+	            const std::pair<double, double>& hadRef = m_fineTimeRefs[2*index+1];
 	            double hadReference = hadRef.first;
 	            double hadCalFactor = hadRef.second;   
     
@@ -216,14 +334,14 @@ StatusCode PPrStabilityMon::fillHistograms()
 	const int emEt  = (*TriggerTowerIterator)->emEnergy();
 	const int hadEt = (*TriggerTowerIterator)->hadEnergy();
 
-	if (m_doPedestalMonitoring) {
+	if (m_pedestalPlotManager) {
 
 	    // Need no signal
 	    if (emEt == 0 || hadEt == 0) {
 	        m_pedestalPlotManager->Analyze(m_evtInfo, *TriggerTowerIterator,emDead,hadDead);
 	    }
 	}
-	if (m_doEtCorrelationMonitoring) {
+	if (m_etCorrelationPlotManager) {
 
 	    // Need signal
 	    if (emEt > m_EtMinForEtCorrelation || hadEt > m_EtMinForEtCorrelation) {
@@ -231,13 +349,279 @@ StatusCode PPrStabilityMon::fillHistograms()
 	    }
 	}
     }
+    m_sampler.done();
     
     return sc;
 }
 
 StatusCode PPrStabilityMon::procHistograms()
 {
-    if(endOfRun){}
+    if (m_compactStore && (endOfLumiBlock || endOfRun) &&
+        m_lumiBlock != m_storeLumiBlockDone) {
+        std::size_t memory = 0;
+        for (int q = 0; q < MaxStores; ++q) {
+            fillStoreHists(q, m_lumiBlock);
+            memory += m_stats[q].memory();
+        }
+        m_storeLumiBlockDone = m_lumiBlock;
+        if (msgLvl(MSG::DEBUG)) {
+            msg(MSG::DEBUG) << "Compact store size " << memory
+                            << " bytes" << endreq;
+        }
+    }
+    if (m_useStores && endOfRun && !m_timeSeriesFile.empty()) {
+        writeTimeSeries();
+    }
+    return StatusCode::SUCCESS;
+}
+
+StatusCode PPrStabilityMon::loadConditions()
+{
+    if (m_doFineTimeMonitoring) {
+        //load the standalone sqlite db containing the fine time references and calibration values
+        StatusCode sc = m_ttTool->loadFTRefs();
+        if (sc.isFailure()) return sc;
+    }
+
+    const int nTowers = TrigT1CaloTowerTableTool::numberOfTowers();
+    m_channelDisabled.resize(2*nTowers);
+    if (m_doFineTimeMonitoring) m_fineTimeRefs.resize(2*nTowers);
+    for (int index = 0; index < nTowers; ++index) {
+        const TrigT1CaloTowerTableTool::Tower& tower(m_towerTable->tower(index));
+        for (int layer = 0; layer < 2; ++layer) {
+            const L1CaloCoolChannelId& coolId(tower.layer[layer].coolId);
+            m_channelDisabled[2*index + layer] = m_ttTool->disabledChannel(coolId);
+            if (m_doFineTimeMonitoring) {
+                m_fineTimeRefs[2*index + layer] = m_ttTool->refValues(coolId);
+            }
+        }
+    }
+    m_conditionsValid = true;
+    ++m_conditionsLoads;
+    if (msgLvl(MSG::DEBUG)) {
+        msg(MSG::DEBUG) << "Conditions loaded, count " << m_conditionsLoads
+                        << endreq;
+    }
+
     return StatusCode::SUCCESS;
 }
 
+void PPrStabilityMon::fillStores(const LVL1::TriggerTower* tt, int index,
+                                 int lumiBlock)
+{
+    const TrigT1CaloTowerTableTool::Tower& tower(m_towerTable->tower(index));
+    for (int layer = 0; layer < 2; ++layer) {
+        const int channel = 2*index + layer;
+        if (m_channelDisabled[channel]) continue;
+        const std::vector<int>& adc((layer) ? tt->hadADC() : tt->emADC());
+        const int et = (layer) ? tt->hadEnergy() : tt->emEnergy();
+        const Identifier& id(tower.layer[layer].identifier);
+
+        // Pedestal needs no signal, the others signal
+        if (m_doPedestalMonitoring && et == 0) {
+            fillPedestalStats(adc, channel, lumiBlock);
+        }
+        if (m_doFineTimeMonitoring) {
+            const int peak = (layer) ? tt->hadADCPeak() : tt->emADCPeak();
+            fillFineTimeStats(adc, peak, channel, id, lumiBlock);
+        }
+        if (m_doEtCorrelationMonitoring && et > m_EtMinForEtCorrelation) {
+            m_stats[EtCorrelation].fill(channel, lumiBlock, m_caloTool->et(id)/et);
+        }
+    }
+}
+
+void PPrStabilityMon::fillPedestalStats(const std::vector<int>& adc, int channel,
+                                        int lumiBlock)
+{
+    if (adc.empty()) return;
+    int sum = 0;
+    std::vector<int>::const_iterator it  = adc.begin();
+    std::vector<int>::const_iterator itE = adc.end();
+    for (; it != itE; ++it) sum += *it;
+    m_stats[Pedestal].fill(channel, lumiBlock, double(sum)/adc.size());
+}
+
+void PPrStabilityMon::fillFineTimeStats(const std::vector<int>& adc, int peak,
+                                        int channel, const Identifier& id,
+                                        int lumiBlock)
+{
+    // Need a peak clear of the first and last slices and not saturated
+    if (peak < 1 || peak + 1 >= int(adc.size())) return;
+    const int before = adc[peak-1];
+    const int max    = adc[peak];
+    const int after  = adc[peak+1];
+    if (max <= int(m_ppmADCMinValue) || max >= int(m_ppmADCMaxValue)) return;
+    const int curvature = 2*max - before - after;
+    if (curvature <= 0) return;
+
+    // Vertex of the parabola through slices 25 ns apart
+    const double peakTime = 12.5*(after - before)/curvature;
+    const std::pair<double, double>& ref(m_fineTimeRefs[channel]);
+    const double fineTime = (peakTime - ref.first)*ref.second;
+    if (std::fabs(fineTime) > m_fineTimeCut) return;
+    if (m_doCaloQualCut && m_caloTool->caloQuality(id) > m_caloQualityMax) return;
+    m_stats[FineTime].fill(channel, lumiBlock, fineTime);
+}
+
+void PPrStabilityMon::bookStoreHists()
+{
+    MgmtAttr_t attr = ATTRIB_UNMANAGED;
+    const int nTowers = TrigT1CaloTowerTableTool::numberOfTowers();
+
+    for (int q = 0; q < MaxStores; ++q) {
+        StoreHists& hists(m_storeHists[q]);
+        hists.emMean  = 0;
+        hists.hadMean = 0;
+        hists.emRMS   = 0;
+        hists.hadRMS  = 0;
+        hists.byLumi.clear();
+        hists.channelByLumi.clear();
+        if (m_stats[q].channels() == 0) continue;
+
+        const std::string name(storeNames[q]);
+        const std::string title(storeTitles[q]);
+        MonGroup monStore(this, m_PathInRootFile+storeDirs[q], run, attr);
+        MonGroup monChan(this, m_PathInRootFile+storeDirs[q]+"/Channels", run, attr);
+
+        m_histTool->setMonGroup(&monStore);
+
+        hists.emMean = m_histTool->bookProfilePPMEmEtaVsPhi(
+          "ppm_em_2d_etaPhi_" + name + "_Mean", "EM " + title + " Mean");
+        hists.hadMean = m_histTool->bookProfilePPMHadEtaVsPhi(
+          "ppm_had_2d_etaPhi_" + name + "_Mean", "HAD " + title + " Mean");
+        hists.emRMS = m_histTool->bookProfilePPMEmEtaVsPhi(
+          "ppm_em_2d_etaPhi_" + name + "_RMS", "EM " + title + " RMS");
+        hists.hadRMS = m_histTool->bookProfilePPMHadEtaVsPhi(
+          "ppm_had_2d_etaPhi_" + name + "_RMS", "HAD " + title + " RMS");
+
+        for (int part = 0; part < TrigT1CaloTowerTableTool::MaxPartitions; ++part) {
+            const std::string partName(TrigT1CaloTowerTableTool::partitionName(part));
+            if (q == Pedestal) {
+                hists.byLumi.push_back(m_histTool->bookProfile(
+                  "ppm_1d_pedestal_" + partName + "_DifferenceByLumi",
+                  "Pedestal Difference from Channel Mean by Lumiblock " + partName
+                                                 + ";Lumiblock;Difference",
+                  m_lumiBlockMax, 0, m_lumiBlockMax));
+            } else {
+                hists.byLumi.push_back(m_histTool->bookProfile(
+                  "ppm_1d_" + name + "_" + partName + "_ByLumi",
+                  title + " by Lumiblock " + partName + ";Lumiblock;" + title,
+                  m_lumiBlockMax, 0, m_lumiBlockMax));
+            }
+        }
+
+        // Per-channel plots only on request
+
+        hists.channelByLumi.assign(m_stats[q].channels(), 0);
+        if (m_channelPlots.empty()) {
+            m_histTool->unsetMonGroup();
+            continue;
+        }
+        m_histTool->setMonGroup(&monChan);
+        for (int index = 0; index < nTowers; ++index) {
+            const TrigT1CaloTowerTableTool::Tower& tower(m_towerTable->tower(index));
+            for (int layer = 0; layer < 2; ++layer) {
+                const unsigned int coolId = tower.layer[layer].coolId.id();
+                std::vector<unsigned int>::const_iterator it =
+                  std::find(m_channelPlots.begin(), m_channelPlots.end(), coolId);
+                if (it == m_channelPlots.end()) continue;
+                std::ostringstream cnum;
+                cnum << "0x" << std::hex << std::setfill('0') << std::setw(8) << coolId;
+                hists.channelByLumi[2*index+layer] = m_histTool->bookProfile(
+                  "ppm_1d_" + name + "_" + cnum.str() + "_ByLumi",
+                  title + " by Lumiblock Channel " + cnum.str() + ";Lumiblock;" + title,
+                  m_lumiBlockMax, 0, m_lumiBlockMax);
+            }
+        }
+        m_histTool->unsetMonGroup();
+    }
+}
+
+void PPrStabilityMon::fillStoreHists(int quantity, int lumiBlock)
+{
+    const TrigT1CaloChannelStats& stats(m_stats[quantity]);
+    StoreHists& hists(m_storeHists[quantity]);
+    if (!hists.emMean) return;
+
+    // Channel maps show the run so far, so remake them from the totals
+    hists.emMean->Reset();
+    hists.hadMean->Reset();
+    hists.emRMS->Reset();
+    hists.hadRMS->Reset();
+
+    // Pedestal differences are from the channel mean of the run so far,
+    // the same reference for every lumiblock, so remake them all.  The
+    // others only need the lumiblock just finished.
+    const bool difference = (quantity == Pedestal);
+    std::vector<int> lumiBlocks;
+    if (difference) {
+        for (unsigned int part = 0; part < hists.byLumi.size(); ++part) {
+            hists.byLumi[part]->Reset();
+        }
+        for (int lb = 0; lb < stats.lumiBlocks(); ++lb) {
+            if (stats.filled(lb)) lumiBlocks.push_back(lb);
+        }
+    } else if (stats.filled(lumiBlock)) lumiBlocks.push_back(lumiBlock);
+
+    const int nChannels = stats.channels();
+    for (int channel = 0; channel < nChannels; ++channel) {
+        const TrigT1CaloChannelStats::Totals& total(stats.total(channel));
+        if (total.entries == 0) continue;
+        const int layer = channel%2;
+        const TrigT1CaloTowerTableTool::Tower& tower(m_towerTable->tower(channel/2));
+        if (layer == 0) {
+            m_histTool->fillPPMEmEtaVsPhi(hists.emMean, tower.eta, tower.phi, total.mean);
+            m_histTool->fillPPMEmEtaVsPhi(hists.emRMS, tower.eta, tower.phi, total.rms());
+        } else {
+            m_histTool->fillPPMHadEtaVsPhi(hists.hadMean, tower.eta, tower.phi, total.mean);
+            m_histTool->fillPPMHadEtaVsPhi(hists.hadRMS, tower.eta, tower.phi, total.rms());
+        }
+
+        TProfile_LW* partHist = hists.byLumi[tower.layer[layer].partition];
+        const double reference = (difference) ? total.mean : 0.;
+        std::vector<int>::const_iterator it  = lumiBlocks.begin();
+        std::vector<int>::const_iterator itE = lumiBlocks.end();
+        for (; it != itE; ++it) {
+            const TrigT1CaloChannelStats::Moments* moments = stats.moments(channel, *it);
+            if (moments->entries == 0) continue;
+            partHist->Fill(*it, moments->mean - reference, moments->entries);
+        }
+        TProfile_LW* chanHist = hists.channelByLumi[channel];
+        const TrigT1CaloChannelStats::Moments* moments = stats.moments(channel, lumiBlock);
+        if (chanHist && moments && moments->entries > 0) {
+            chanHist->Fill(lumiBlock, moments->mean, moments->entries);
+        }
+    }
+}
+
+void PPrStabilityMon::writeTimeSeries()
+{
+    std::ostringstream fileName;
+    fileName << m_timeSeriesFile << "_" << m_runNumber << ".l1ts";
+
+    const int nTowers = TrigT1CaloTowerTableTool::numberOfTowers();
+    std::vector<unsigned int> channelIds(2*nTowers);
+    for (int index = 0; index < nTowers; ++index) {
+        const TrigT1CaloTowerTableTool::Tower& tower(m_towerTable->tower(index));
+        for (int layer = 0; layer < 2; ++layer) {
+            channelIds[2*index + layer] = tower.layer[layer].coolId.id();
+        }
+    }
+    std::vector<std::string> names;
+    std::vector<const TrigT1CaloChannelStats*> stats;
+    for (int q = 0; q < MaxStores; ++q) {
+        if (m_stats[q].channels() == 0) continue;
+        names.push_back(storeNames[q]);
+        stats.push_back(&m_stats[q]);
+    }
+    if (stats.empty()) return;
+    if (TrigT1CaloTimeSeriesFile::write(fileName.str(), m_runNumber, names,
+                                        stats, channelIds)) {
+        msg(MSG::INFO) << "Time series of " << stats.size()
+                       << " quantities written to " << fileName.str() << endreq;
+    } else {
+        msg(MSG::WARNING) << "Failed to write time series file "
+                          << fileName.str() << endreq;
+    }
+}
@@ -0,0 +1,69 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloChannelStats.cxx
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+
+#include <algorithm>
+
+#include "TrigT1CaloMonitoring/TrigT1CaloChannelStats.h"
+
+/*---------------------------------------------------------*/
+TrigT1CaloChannelStats::TrigT1CaloChannelStats()
+  : m_channels(0), m_lumiBlocks(0), m_slabsUsed(0)
+/*---------------------------------------------------------*/
+{
+}
+
+/*---------------------------------------------------------*/
+void TrigT1CaloChannelStats::setup(int channels, int lumiBlocks)
+/*---------------------------------------------------------*/
+{
+  m_channels   = channels;
+  m_lumiBlocks = lumiBlocks;
+  m_chunks.clear();
+  m_chunks.reserve((lumiBlocks + s_chunkSlabs - 1)/s_chunkSlabs);
+  m_slabsUsed = 0;
+  clear();
+}
+
+/*---------------------------------------------------------*/
+void TrigT1CaloChannelStats::clear()
+/*---------------------------------------------------------*/
+{
+  std::vector<std::vector<Moments> >::iterator it  = m_chunks.begin();
+  std::vector<std::vector<Moments> >::iterator itE = m_chunks.end();
+  for (; it != itE && m_slabsUsed > 0; ++it, m_slabsUsed -= s_chunkSlabs) {
+    std::fill(it->begin(), it->end(), Moments());
+  }
+  m_slabsUsed = 0;
+  m_slab.assign(m_lumiBlocks, 0);
+  m_totals.assign(m_channels, Totals());
+}
+
+/*---------------------------------------------------------*/
+void TrigT1CaloChannelStats::fill(int channel, int lumiBlock, double x)
+/*---------------------------------------------------------*/
+{
+  if (lumiBlock < 0 || lumiBlock >= m_lumiBlocks ||
+      channel < 0 || channel >= m_channels) return;
+  Moments*& slab(m_slab[lumiBlock]);
+  if (!slab) slab = newSlab();
+  slab[channel].add(x);
+  m_totals[channel].add(x);
+}
+
+/*---------------------------------------------------------*/
+TrigT1CaloChannelStats::Moments* TrigT1CaloChannelStats::newSlab()
+/*---------------------------------------------------------*/
+{
+  const int chunk = m_slabsUsed / s_chunkSlabs;
+  if (chunk == int(m_chunks.size())) {
+    m_chunks.push_back(std::vector<Moments>());
+    m_chunks.back().resize(s_chunkSlabs * m_channels);
+  }
+  const int pos = m_slabsUsed % s_chunkSlabs;
+  ++m_slabsUsed;
+  return &m_chunks[chunk][pos * m_channels];
+}
@@ -18,7 +18,6 @@
 
 #include "GaudiKernel/MsgStream.h"
 #include "GaudiKernel/StatusCode.h"
-#include "SGTools/StlVectorClids.h"
 
 #include "AthenaMonitoring/AthenaMonManager.h"
 
@@ -35,6 +34,7 @@
 #include "TrigT1Interfaces/TrigT1CaloDefs.h"
 
 #include "TrigT1CaloMonitoring/TrigT1CaloCpmMonTool.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloErrorBoardTool.h"
 #include "TrigT1CaloMonitoringTools/TrigT1CaloMonErrorTool.h"
 #include "TrigT1CaloMonitoringTools/TrigT1CaloLWHistogramTool.h"
 
@@ -52,6 +52,7 @@ TrigT1CaloCpmMonTool::TrigT1CaloCpmMonTool(const std::string & type,
   : ManagedMonitorToolBase(type, name, parent),
     m_errorTool("TrigT1CaloMonErrorTool"),
     m_histTool("TrigT1CaloLWHistogramTool"),
+    m_errorBoard("TrigT1CaloErrorBoardTool"),
     m_events(0),
     m_emBitMask(0),
     m_tauBitMask(0),
@@ -154,6 +155,13 @@ StatusCode TrigT1CaloCpmMonTool:: initialize()
     return sc;
   }
 
+  sc = m_errorBoard.retrieve();
+  if( sc.isFailure() ) {
+    msg(MSG::ERROR) << "Unable to locate Tool TrigT1CaloErrorBoardTool"
+                    << endreq;
+    return sc;
+  }
+
   return StatusCode::SUCCESS;
 }
 
@@ -849,12 +857,7 @@ StatusCode TrigT1CaloCpmMonTool::fillHistograms()
 
   // Save error vector for global summary
 
-  std::vector<int>* save = new std::vector<int>(crateErr);
-  sc = evtStore()->record(save, "L1CaloCPMErrorVector");
-  if (sc != StatusCode::SUCCESS) {
-    msg(MSG::ERROR) << "Error recording CPM error vector in TES " << endreq;
-    return sc;
-  }
+  m_errorBoard->set(TrigT1CaloErrorBoardTool::CPMError, crateErr);
 
   msg(MSG::DEBUG) << "Leaving fillHistograms" << endreq;
 
@@ -0,0 +1,109 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloErrorBoardTool.cxx
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+
+#include "GaudiKernel/Incident.h"
+#include "GaudiKernel/IIncidentSvc.h"
+#include "GaudiKernel/MsgStream.h"
+#include "GaudiKernel/ServiceHandle.h"
+#include "GaudiKernel/StatusCode.h"
+
+#include "TrigT1CaloMonitoring/TrigT1CaloErrorBoardTool.h"
+
+/*---------------------------------------------------------*/
+TrigT1CaloErrorBoardTool::TrigT1CaloErrorBoardTool(const std::string& type,
+                                                   const std::string& name,
+                                                   const IInterface* parent)
+  : AthAlgTool(type, name, parent)
+/*---------------------------------------------------------*/
+{
+  declareInterface<TrigT1CaloErrorBoardTool>(this);
+
+  for (int source = 0; source < NumberOfSources; ++source) {
+    m_set[source] = false;
+    for (int crate = 0; crate < s_maxCrates; ++crate) {
+      m_errors[source][crate] = 0;
+    }
+  }
+}
+
+/*---------------------------------------------------------*/
+TrigT1CaloErrorBoardTool::~TrigT1CaloErrorBoardTool()
+/*---------------------------------------------------------*/
+{
+}
+
+#ifndef PACKAGE_VERSION
+#define PACKAGE_VERSION "unknown"
+#endif
+
+/*---------------------------------------------------------*/
+StatusCode TrigT1CaloErrorBoardTool::initialize()
+/*---------------------------------------------------------*/
+{
+  msg(MSG::INFO) << "Initializing " << name() << " - package version "
+                 << PACKAGE_VERSION << endreq;
+
+  ServiceHandle<IIncidentSvc> incidentSvc("IncidentSvc", name());
+  StatusCode sc = incidentSvc.retrieve();
+  if( sc.isFailure() ) {
+    msg(MSG::ERROR) << "Unable to locate Service IncidentSvc" << endreq;
+    return sc;
+  }
+  incidentSvc->addListener(this, "BeginEvent");
+
+  return StatusCode::SUCCESS;
+}
+
+/*---------------------------------------------------------*/
+StatusCode TrigT1CaloErrorBoardTool::finalize()
+/*---------------------------------------------------------*/
+{
+  return StatusCode::SUCCESS;
+}
+
+/*---------------------------------------------------------*/
+void TrigT1CaloErrorBoardTool::handle(const Incident& incident)
+/*---------------------------------------------------------*/
+{
+  if (incident.type() == "BeginEvent") {
+    for (int source = 0; source < NumberOfSources; ++source) {
+      m_set[source] = false;
+    }
+  }
+}
+
+/*---------------------------------------------------------*/
+bool TrigT1CaloErrorBoardTool::set(Source source,
+                                   const std::vector<int>& crateErr)
+/*---------------------------------------------------------*/
+{
+  const int nCrates = crates(source);
+  if (int(crateErr.size()) != nCrates) return false;
+  for (int crate = 0; crate < nCrates; ++crate) {
+    m_errors[source][crate] = crateErr[crate];
+  }
+  m_set[source] = true;
+  return true;
+}
+
+/*---------------------------------------------------------*/
+int TrigT1CaloErrorBoardTool::crates(Source source)
+/*---------------------------------------------------------*/
+{
+  switch (source) {
+    case PPMError:
+    case PPMSpareError:
+    case PPMMismatch:   return 8;
+    case CPMError:
+    case CPMMismatch:   return 4;
+    case JEMError:
+    case JEMCMMError:
+    case JEMMismatch:   return 2;
+    case RODError:      return s_maxCrates;
+    default:            return 0;
+  }
+}
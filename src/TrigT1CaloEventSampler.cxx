@@ -0,0 +1,93 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloEventSampler.cxx
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+
+#include <cmath>
+#include <sys/time.h>
+
+#include "TrigT1CaloMonitoring/TrigT1CaloEventSampler.h"
+
+/*---------------------------------------------------------*/
+TrigT1CaloEventSampler::TrigT1CaloEventSampler()
+  : m_budget(0.), m_window(10), m_prescale(1), m_changes(0),
+    m_windowStart(0), m_offered(0), m_processed(0), m_used(0.),
+    m_start(0.), m_timing(false)
+/*---------------------------------------------------------*/
+{
+}
+
+/*---------------------------------------------------------*/
+void TrigT1CaloEventSampler::setup(double budget, int window)
+/*---------------------------------------------------------*/
+{
+  m_budget      = budget;
+  m_window      = (window > 0) ? window : 1;
+  m_prescale    = 1;
+  m_changes     = 0;
+  m_windowStart = 0;
+  m_offered     = 0;
+  m_processed   = 0;
+  m_used        = 0.;
+  m_timing      = false;
+}
+
+/*---------------------------------------------------------*/
+bool TrigT1CaloEventSampler::accept(unsigned int eventNumber)
+/*---------------------------------------------------------*/
+{
+  if (!enabled()) return true;
+  const std::time_t now = std::time(0);
+  if (m_windowStart == 0) m_windowStart = now;
+  else if (now - m_windowStart >= m_window) update(now);
+  ++m_offered;
+  m_timing = (eventNumber % m_prescale == 0);
+  if (m_timing) m_start = wallTime();
+  return m_timing;
+}
+
+/*---------------------------------------------------------*/
+void TrigT1CaloEventSampler::done()
+/*---------------------------------------------------------*/
+{
+  if (!m_timing) return;
+  const double used = wallTime() - m_start;
+  if (used > 0.) m_used += used;    // clock may be stepped back
+  ++m_processed;
+  m_timing = false;
+}
+
+/*---------------------------------------------------------*/
+void TrigT1CaloEventSampler::update(std::time_t now)
+/*---------------------------------------------------------*/
+{
+  const double elapsed = now - m_windowStart;
+  if (m_processed > 0 && elapsed > 0.) {
+    // Processing time per second needed to process every event offered
+    const double demand = (m_used/m_processed) * (m_offered/elapsed);
+    int prescale = 1;
+    if (demand > m_budget) {
+      const double scale = std::ceil(demand/m_budget);
+      prescale = (scale < s_maxPrescale) ? int(scale) : s_maxPrescale;
+    }
+    if (prescale != m_prescale) {
+      m_prescale = prescale;
+      ++m_changes;
+    }
+  }
+  m_windowStart = now;
+  m_offered     = 0;
+  m_processed   = 0;
+  m_used        = 0.;
+}
+
+/*---------------------------------------------------------*/
+double TrigT1CaloEventSampler::wallTime()
+/*---------------------------------------------------------*/
+{
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec + 1.e-6*tv.tv_usec;
+}
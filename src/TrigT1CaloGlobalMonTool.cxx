@@ -21,13 +21,13 @@
 
 #include "GaudiKernel/MsgStream.h"
 #include "GaudiKernel/StatusCode.h"
-#include "SGTools/StlVectorClids.h"
 
 #include "AthenaMonitoring/AthenaMonManager.h"
 #include "EventInfo/EventInfo.h"
 #include "EventInfo/EventID.h"
 
 #include "TrigT1CaloMonitoring/TrigT1CaloGlobalMonTool.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloErrorBoardTool.h"
 #include "TrigT1CaloMonitoringTools/TrigT1CaloMonErrorTool.h"
 #include "TrigT1CaloMonitoringTools/TrigT1CaloLWHistogramTool.h"
 
@@ -38,10 +38,10 @@ TrigT1CaloGlobalMonTool::TrigT1CaloGlobalMonTool(const std::string & type,
   : ManagedMonitorToolBase(type, name, parent),
     m_errorTool("TrigT1CaloMonErrorTool"),
     m_histTool("TrigT1CaloLWHistogramTool"),
+    m_errorBoard("TrigT1CaloErrorBoardTool"),
     m_lumiNo(0),
     m_lumipos(0),
     m_h_l1calo_2d_GlobalOverview(0),
-    m_h_l1calo_2d_CurrentEventOverview(0),
     m_h_l1calo_2d_GlobalOverviewRecent(0),
     m_h_l1calo_1d_ErrorsByLumiblock(0),
     m_h_l1calo_1d_ErrorsByTime(0),
@@ -93,6 +93,12 @@ StatusCode TrigT1CaloGlobalMonTool::initialize()
                     << endreq;
     return sc;
   }
+  sc = m_errorBoard.retrieve();
+  if( sc.isFailure() ) {
+    msg(MSG::ERROR) << "Unable to locate Tool TrigT1CaloErrorBoardTool"
+                    << endreq;
+    return sc;
+  }
 
   return StatusCode::SUCCESS;
 }
@@ -101,7 +107,6 @@ StatusCode TrigT1CaloGlobalMonTool::initialize()
 StatusCode TrigT1CaloGlobalMonTool::finalize()
 /*---------------------------------------------------------*/
 {
-  delete m_h_l1calo_2d_CurrentEventOverview;
   if (!m_v_l1calo_2d_GlobalOverviewBlock.empty()) {
     for (int i = 0; i < m_recentLumi; ++i) {
       delete m_v_l1calo_2d_GlobalOverviewBlock[i];
@@ -155,11 +160,6 @@ StatusCode TrigT1CaloGlobalMonTool::bookHistogramsRecurrent()
 
     m_histTool->unsetMonGroup();
 
-    if (!m_h_l1calo_2d_CurrentEventOverview) { // temporary plot for current event
-      m_h_l1calo_2d_CurrentEventOverview = bookOverview(
-        "l1calo_2d_CurrentEventOverview", "L1Calo Current Event Error Overview");
-    }
-
     if (online) {
 
       // Overview for last few lumiblocks
@@ -351,221 +351,195 @@ StatusCode TrigT1CaloGlobalMonTool::fillHistograms()
     return StatusCode::SUCCESS;
   } else m_h_l1calo_1d_NumberOfEvents->Fill(0.);
 
-  StatusCode sc;
-
   // Update Global overview plot
 
   const int ppmCrates = 8;
   const int cpmCrates = 4;
   const int jemCrates = 2;
-  m_h_l1calo_2d_CurrentEventOverview->Reset();
+  const int nCrates   = ppmCrates + cpmCrates + jemCrates;
+
+  // Bitmask of GlobalErrors bins set this event by crate
+  unsigned int overview[nCrates];
+  for (int crate = 0; crate < nCrates; ++crate) overview[crate] = 0;
 
   // PPM Error data
-  const ErrorVector* errTES = 0; 
-  if (evtStore()->contains<ErrorVector>("L1CaloPPMErrorVector")) {
-    sc = evtStore()->retrieve(errTES, "L1CaloPPMErrorVector"); 
-  } else sc = StatusCode::FAILURE;
-  if (sc.isFailure() || !errTES || errTES->size() != size_t(ppmCrates)) {
-    if (debug) msg(MSG::DEBUG) << "No PPM error vector of expected size"
+  const int* errors = m_errorBoard->errors(TrigT1CaloErrorBoardTool::PPMError);
+  if (!errors) {
+    if (debug) msg(MSG::DEBUG) << "No PPM error bits for this event"
                                << endreq;
   } else {
     for (int crate = 0; crate < ppmCrates; ++crate) {
-      const int err = (*errTES)[crate];
+      const int err = errors[crate];
       if (err == 0) continue;
       if ((err >> DataStatus) & 0x1) {
-        m_h_l1calo_2d_CurrentEventOverview->Fill(PPMDataStatus, crate);
+        overview[crate] |= (1 << PPMDataStatus);
       }
       if ((err >> DataError) & 0x1) {
-        m_h_l1calo_2d_CurrentEventOverview->Fill(PPMDataError, crate);
+        overview[crate] |= (1 << PPMDataError);
       }
       if ((err >> PPMSubStatus) & 0x1) {
-        m_h_l1calo_2d_CurrentEventOverview->Fill(SubStatus, crate);
+        overview[crate] |= (1 << SubStatus);
       }
     }
   }
 
   // Spare PPM Channels Error data
-  errTES = 0;
-  if (evtStore()->contains<ErrorVector>("L1CaloPPMSpareErrorVector")) {
-    sc = evtStore()->retrieve(errTES, "L1CaloPPMSpareErrorVector"); 
-  } else sc = StatusCode::FAILURE;
-  if (sc.isFailure() || !errTES || errTES->size() != size_t(ppmCrates)) {
-    if (debug) msg(MSG::DEBUG) << "No PPMSpare error vector of expected size"
+  errors = m_errorBoard->errors(TrigT1CaloErrorBoardTool::PPMSpareError);
+  if (!errors) {
+    if (debug) msg(MSG::DEBUG) << "No PPMSpare error bits for this event"
                                << endreq;
   } else {
     for (int crate = 0; crate < ppmCrates; ++crate) {
-      const int err = (*errTES)[crate];
+      const int err = errors[crate];
       if (err == 0) continue;
       if ((err >> DataStatus) & 0x1) {
-        m_h_l1calo_2d_CurrentEventOverview->Fill(PPMDataStatus, crate);
+        overview[crate] |= (1 << PPMDataStatus);
       }
       if ((err >> DataError) & 0x1) {
-        m_h_l1calo_2d_CurrentEventOverview->Fill(PPMDataError, crate);
+        overview[crate] |= (1 << PPMDataError);
       }
       if ((err >> PPMSubStatus) & 0x1) {
-        m_h_l1calo_2d_CurrentEventOverview->Fill(SubStatus, crate);
+        overview[crate] |= (1 << SubStatus);
       }
     }
   }
 
   // CPM and CPM CMM Error data
-  errTES = 0; 
-  if (evtStore()->contains<ErrorVector>("L1CaloCPMErrorVector")) {
-    sc = evtStore()->retrieve(errTES, "L1CaloCPMErrorVector"); 
-  } else sc = StatusCode::FAILURE;
-  if (sc.isFailure() || !errTES || errTES->size() != size_t(cpmCrates)) {
-    if (debug) msg(MSG::DEBUG) << "No CPM error vector of expected size"
+  errors = m_errorBoard->errors(TrigT1CaloErrorBoardTool::CPMError);
+  if (!errors) {
+    if (debug) msg(MSG::DEBUG) << "No CPM error bits for this event"
                                << endreq;
   } else {
     for (int crate = 0; crate < cpmCrates; ++crate) {
-      const int err = (*errTES)[crate];
+      const int err = errors[crate];
       if (err == 0) continue;
       const int cr = crate + ppmCrates;
-      if ((err >> CPMStatus) & 0x1) m_h_l1calo_2d_CurrentEventOverview->Fill(SubStatus, cr);
+      if ((err >> CPMStatus) & 0x1) overview[cr] |= (1 << SubStatus);
       if (((err >> CPMEMParity) & 0x1) || ((err >> CPMHadParity) & 0x1))
-                                             m_h_l1calo_2d_CurrentEventOverview->Fill(Parity, cr);
+                                             overview[cr] |= (1 << Parity);
       if (((err >> CPMEMLink) & 0x1) || ((err >> CPMHadLink) & 0x1))
-                                             m_h_l1calo_2d_CurrentEventOverview->Fill(LinkDown, cr);
-      if ((err >> CPMRoIParity) & 0x1) m_h_l1calo_2d_CurrentEventOverview->Fill(RoIParity, cr);
-      if ((err >> CMMCPStatus) & 0x1)  m_h_l1calo_2d_CurrentEventOverview->Fill(CMMSubStatus, cr);
-      if ((err >> CMMCPParity) & 0x1)  m_h_l1calo_2d_CurrentEventOverview->Fill(GbCMMParity, cr);
+                                             overview[cr] |= (1 << LinkDown);
+      if ((err >> CPMRoIParity) & 0x1) overview[cr] |= (1 << RoIParity);
+      if ((err >> CMMCPStatus) & 0x1)  overview[cr] |= (1 << CMMSubStatus);
+      if ((err >> CMMCPParity) & 0x1)  overview[cr] |= (1 << GbCMMParity);
     }
   }
 
   // JEM Error data
-  errTES = 0; 
-  if (evtStore()->contains<ErrorVector>("L1CaloJEMErrorVector")) {
-    sc = evtStore()->retrieve(errTES, "L1CaloJEMErrorVector"); 
-  } else sc = StatusCode::FAILURE;
-  if (sc.isFailure() || !errTES || errTES->size() != size_t(jemCrates)) {
-    if (debug) msg(MSG::DEBUG) << "No JEM error vector of expected size"
+  errors = m_errorBoard->errors(TrigT1CaloErrorBoardTool::JEMError);
+  if (!errors) {
+    if (debug) msg(MSG::DEBUG) << "No JEM error bits for this event"
                                << endreq;
   } else {
     for (int crate = 0; crate < jemCrates; ++crate) {
-      const int err = (*errTES)[crate];
+      const int err = errors[crate];
       if (err == 0) continue;
       const int cr = crate + ppmCrates + cpmCrates;
-      if ((err >> JEMStatus) & 0x1) m_h_l1calo_2d_CurrentEventOverview->Fill(SubStatus, cr);
+      if ((err >> JEMStatus) & 0x1) overview[cr] |= (1 << SubStatus);
       if (((err >> JEMEMParity) & 0x1) || ((err >> JEMHadParity) & 0x1))
-                                             m_h_l1calo_2d_CurrentEventOverview->Fill(Parity, cr);
+                                             overview[cr] |= (1 << Parity);
       if (((err >> JEMEMLink) & 0x1) || ((err >> JEMHadLink) & 0x1))
-                                             m_h_l1calo_2d_CurrentEventOverview->Fill(LinkDown, cr);
-      if ((err >> JEMRoIParity) & 0x1) m_h_l1calo_2d_CurrentEventOverview->Fill(RoIParity, cr);
+                                             overview[cr] |= (1 << LinkDown);
+      if ((err >> JEMRoIParity) & 0x1) overview[cr] |= (1 << RoIParity);
     }
   }
 
   // JEM CMM Error data
-  errTES = 0; 
-  if (evtStore()->contains<ErrorVector>("L1CaloJEMCMMErrorVector")) {
-    sc = evtStore()->retrieve(errTES, "L1CaloJEMCMMErrorVector"); 
-  } else sc = StatusCode::FAILURE;
-  if (sc.isFailure() || !errTES || errTES->size() != size_t(jemCrates)) {
-    if (debug) msg(MSG::DEBUG) << "No JEM CMM error vector of expected size"
+  errors = m_errorBoard->errors(TrigT1CaloErrorBoardTool::JEMCMMError);
+  if (!errors) {
+    if (debug) msg(MSG::DEBUG) << "No JEM CMM error bits for this event"
                                << endreq;
   } else {
     for (int crate = 0; crate < jemCrates; ++crate) {
-      const int err = (*errTES)[crate];
+      const int err = errors[crate];
       if (err == 0) continue;
       const int cr = crate + ppmCrates + cpmCrates;
       if (((err >> JEMCMMJetStatus) & 0x1) ||
           ((err >> JEMCMMEnergyStatus) & 0x1)) {
-        m_h_l1calo_2d_CurrentEventOverview->Fill(CMMSubStatus, cr);
+        overview[cr] |= (1 << CMMSubStatus);
       }
       if (((err >> JEMCMMJetParity) & 0x1) ||
           ((err >> JEMCMMEnergyParity) & 0x1)) {
-        m_h_l1calo_2d_CurrentEventOverview->Fill(GbCMMParity, cr);
+        overview[cr] |= (1 << GbCMMParity);
       }
-      if ((err >> JEMCMMRoIParity) & 0x1) m_h_l1calo_2d_CurrentEventOverview->Fill(RoIParity, cr);
+      if ((err >> JEMCMMRoIParity) & 0x1) overview[cr] |= (1 << RoIParity);
     }
   }
 
   // ROD Error data
-  errTES = 0; 
-  if (evtStore()->contains<ErrorVector>("L1CaloRODErrorVector")) {
-    sc = evtStore()->retrieve(errTES, "L1CaloRODErrorVector"); 
-  } else sc = StatusCode::FAILURE;
-  if (sc.isFailure() || !errTES || 
-                errTES->size() != size_t(ppmCrates + cpmCrates + jemCrates)) {
-    if (debug) msg(MSG::DEBUG) << "No ROD error vector of expected size"
+  errors = m_errorBoard->errors(TrigT1CaloErrorBoardTool::RODError);
+  if (!errors) {
+    if (debug) msg(MSG::DEBUG) << "No ROD error bits for this event"
                                << endreq;
   } else {
-    for (int crate = 0; crate < ppmCrates+cpmCrates+jemCrates; ++crate) {
-      const int err = (*errTES)[crate];
+    for (int crate = 0; crate < nCrates; ++crate) {
+      const int err = errors[crate];
       if (err == 0) continue;
-      //if (err & 0x7f) m_h_l1calo_2d_CurrentEventOverview->Fill(RODStatus, crate);
-      if (err & 0x3f) m_h_l1calo_2d_CurrentEventOverview->Fill(RODStatus, crate);
+      //if (err & 0x7f) overview[crate] |= (1 << RODStatus);
+      if (err & 0x3f) overview[crate] |= (1 << RODStatus);
       if (((err >> NoFragment) & 0x1) || ((err >> NoPayload) & 0x1))
-                      m_h_l1calo_2d_CurrentEventOverview->Fill(RODMissing, crate);
-      if ((err >> ROBStatusError) & 0x1) m_h_l1calo_2d_CurrentEventOverview->Fill(ROBStatus, crate);
-      if ((err >> UnpackingError) & 0x1) m_h_l1calo_2d_CurrentEventOverview->Fill(Unpacking, crate);
+                      overview[crate] |= (1 << RODMissing);
+      if ((err >> ROBStatusError) & 0x1) overview[crate] |= (1 << ROBStatus);
+      if ((err >> UnpackingError) & 0x1) overview[crate] |= (1 << Unpacking);
     }
   }
 
   // PPM Mismatch data
-  errTES = 0; 
-  if (evtStore()->contains<ErrorVector>("L1CaloPPMMismatchVector")) {
-    sc = evtStore()->retrieve(errTES, "L1CaloPPMMismatchVector"); 
-  } else sc = StatusCode::FAILURE;
-  if (sc.isFailure() || !errTES || errTES->size() != size_t(ppmCrates)) {
-    if (debug) msg(MSG::DEBUG) << "No PPM mismatch vector of expected size"
+  errors = m_errorBoard->errors(TrigT1CaloErrorBoardTool::PPMMismatch);
+  if (!errors) {
+    if (debug) msg(MSG::DEBUG) << "No PPM mismatch bits for this event"
                                << endreq;
   } else {
     for (int crate = 0; crate < ppmCrates; ++crate) {
-      const int err = (*errTES)[crate];
+      const int err = errors[crate];
       if (err == 0) continue;
-      if (((err >> LUTMismatch) & 0x1)) m_h_l1calo_2d_CurrentEventOverview->Fill(Simulation, crate);
+      if (((err >> LUTMismatch) & 0x1)) overview[crate] |= (1 << Simulation);
     }
   }
 
   // CPM Mismatch data
-  errTES = 0; 
-  if (evtStore()->contains<ErrorVector>("L1CaloCPMMismatchVector")) {
-    sc = evtStore()->retrieve(errTES, "L1CaloCPMMismatchVector"); 
-  } else sc = StatusCode::FAILURE;
-  if (sc.isFailure() || !errTES || errTES->size() != size_t(cpmCrates)) {
-    if (debug) msg(MSG::DEBUG) << "No CPM mismatch vector of expected size"
+  errors = m_errorBoard->errors(TrigT1CaloErrorBoardTool::CPMMismatch);
+  if (!errors) {
+    if (debug) msg(MSG::DEBUG) << "No CPM mismatch bits for this event"
                                << endreq;
   } else {
     for (int crate = 0; crate < cpmCrates; ++crate) {
-      const int err = (*errTES)[crate];
+      const int err = errors[crate];
       if (err == 0) continue;
       const int cr = crate + ppmCrates;
       if (((err >> EMTowerMismatch) & 0x1) || ((err >> HadTowerMismatch) & 0x1))
-                                        m_h_l1calo_2d_CurrentEventOverview->Fill(Transmission, cr);
+                                        overview[cr] |= (1 << Transmission);
       if (((err >> CPMRoIMismatch) & 0x1) || ((err >> CPMHitsMismatch) & 0x1))
-                                        m_h_l1calo_2d_CurrentEventOverview->Fill(Simulation, cr);
+                                        overview[cr] |= (1 << Simulation);
       if (((err >> CMMHitsMismatch) & 0x1) || ((err >> RemoteSumMismatch) & 0x1))
-                                        m_h_l1calo_2d_CurrentEventOverview->Fill(CMMTransmission, cr);
+                                        overview[cr] |= (1 << CMMTransmission);
       if (((err >> LocalSumMismatch) & 0x1) || ((err >> TotalSumMismatch) & 0x1))
-                                        m_h_l1calo_2d_CurrentEventOverview->Fill(CMMSimulation, cr);
+                                        overview[cr] |= (1 << CMMSimulation);
     }
   }
 
   // JEM Mismatch data
-  errTES = 0; 
-  if (evtStore()->contains<ErrorVector>("L1CaloJEMMismatchVector")) {
-    sc = evtStore()->retrieve(errTES, "L1CaloJEMMismatchVector"); 
-  } else sc = StatusCode::FAILURE;
-  if (sc.isFailure() || !errTES || errTES->size() != size_t(jemCrates)) {
-    if (debug) msg(MSG::DEBUG) << "No JEM mismatch vector of expected size"
+  errors = m_errorBoard->errors(TrigT1CaloErrorBoardTool::JEMMismatch);
+  if (!errors) {
+    if (debug) msg(MSG::DEBUG) << "No JEM mismatch bits for this event"
                                << endreq;
   } else {
     for (int crate = 0; crate < jemCrates; ++crate) {
-      const int err = (*errTES)[crate];
+      const int err = errors[crate];
       if (err == 0) continue;
       const int cr = crate + ppmCrates + cpmCrates;
       if (((err >> EMElementMismatch) & 0x1)  ||
           ((err >> HadElementMismatch) & 0x1) ||
           ((err >> JEMRoIMismatch) & 0x1)     ||
           ((err >> JEMHitsMismatch) & 0x1)    ||
-          ((err >> JEMEtSumsMismatch) & 0x1)) m_h_l1calo_2d_CurrentEventOverview->Fill(Simulation, cr);
+          ((err >> JEMEtSumsMismatch) & 0x1)) overview[cr] |= (1 << Simulation);
       if (((err >> CMMJetHitsMismatch) & 0x1)   ||
           ((err >> RemoteJetMismatch) & 0x1)    ||
 	  ((err >> JetEtRoIMismatch) & 0x1)     ||
 	  ((err >> CMMEtSumsMismatch) & 0x1)    ||
 	  ((err >> RemoteEnergyMismatch) & 0x1) ||
 	  ((err >> EnergyRoIMismatch) & 0x1))
-	                              m_h_l1calo_2d_CurrentEventOverview->Fill(CMMTransmission, cr);
+	                              overview[cr] |= (1 << CMMTransmission);
       if (((err >> LocalJetMismatch) & 0x1)    ||
           ((err >> TotalJetMismatch) & 0x1)    ||
 	  ((err >> JetEtMismatch) & 0x1)       ||
@@ -574,16 +548,28 @@ StatusCode TrigT1CaloGlobalMonTool::fillHistograms()
 	  ((err >> SumEtMismatch) & 0x1)       ||
 	  ((err >> MissingEtMismatch) & 0x1)   ||
 	  ((err >> MissingEtSigMismatch) & 0x1))
-	                                m_h_l1calo_2d_CurrentEventOverview->Fill(CMMSimulation, cr);
+	                                overview[cr] |= (1 << CMMSimulation);
     }
   }
 
-  if (m_h_l1calo_2d_CurrentEventOverview->GetEntries() > 0.) {
-    m_h_l1calo_2d_GlobalOverview->Add(m_h_l1calo_2d_CurrentEventOverview);
-    if (online) {
-      m_h_l1calo_2d_GlobalOverviewRecent->Add(m_h_l1calo_2d_CurrentEventOverview);
-      m_v_l1calo_2d_GlobalOverviewBlock[m_lumipos]->Add(m_h_l1calo_2d_CurrentEventOverview);
+  // Fill only the bins set, nearly always none
+
+  bool error = false;
+  for (int crate = 0; crate < nCrates; ++crate) {
+    const unsigned int bits = overview[crate];
+    if (bits == 0) continue;
+    error = true;
+    for (int bin = 0; bin < NumberOfGlobalErrors; ++bin) {
+      if (((bits >> bin) & 0x1) == 0) continue;
+      m_h_l1calo_2d_GlobalOverview->Fill(bin, crate);
+      if (online) {
+        m_h_l1calo_2d_GlobalOverviewRecent->Fill(bin, crate);
+        m_v_l1calo_2d_GlobalOverviewBlock[m_lumipos]->Fill(bin, crate);
+      }
     }
+  }
+
+  if (error) {
     if (m_lumiNo && m_h_l1calo_1d_ErrorsByLumiblock) {
       if (!online && m_h_l1calo_1d_ErrorsByLumiblock->GetEntries() == 0.) {
         std::string dir(m_rootDir + "/Overview/Errors");
@@ -0,0 +1,213 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloJetWindowEngine.cxx
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+
+#include <algorithm>
+#include <cmath>
+
+#include "TrigT1CaloMonitoring/TrigT1CaloJetWindowEngine.h"
+
+namespace {
+
+// Jet Element eta bin edges
+const double etaEdges[TrigT1CaloJetWindowEngine::s_etaBins + 1] = {
+  -4.9, -3.2, -2.9, -2.7, -2.4, -2.2, -2.0, -1.8, -1.6, -1.4, -1.2,
+  -1.0, -0.8, -0.6, -0.4, -0.2,  0.0,  0.2,  0.4,  0.6,  0.8,  1.0,
+   1.2,  1.4,  1.6,  1.8,  2.0,  2.2,  2.4,  2.7,  2.9,  3.2,  4.9
+};
+
+}
+
+/*---------------------------------------------------------*/
+TrigT1CaloJetWindowEngine::TrigT1CaloJetWindowEngine()
+  : m_etaBins(0), m_phiBins(0), m_saturation(0), m_stride(0), m_rows(0),
+    m_candidates(0), m_filled(false)
+/*---------------------------------------------------------*/
+{
+  setup(s_etaBins, s_phiBins, 0x3ff);
+}
+
+/*---------------------------------------------------------*/
+void TrigT1CaloJetWindowEngine::setup(int etaBins, int phiBins,
+                                      int saturation)
+/*---------------------------------------------------------*/
+{
+  m_etaBins    = etaBins;
+  m_phiBins    = phiBins;
+  m_saturation = saturation;
+  m_stride     = etaBins + 2*s_pad;
+  m_rows       = phiBins + 2*s_pad;
+  m_et.assign(m_stride * m_rows, 0);
+  m_core.assign(m_stride * m_rows, 0);
+  m_marked.assign(m_stride * m_rows, 0);
+  m_table.assign((m_stride + 1) * (m_rows + 1), 0);
+  m_markedTable.assign((m_stride + 1) * (m_rows + 1), 0);
+  m_candidates = 0;
+  m_filled = false;
+}
+
+/*---------------------------------------------------------*/
+void TrigT1CaloJetWindowEngine::clear()
+/*---------------------------------------------------------*/
+{
+  if (m_filled) {
+    std::fill(m_et.begin(), m_et.end(), 0);
+    std::fill(m_marked.begin(), m_marked.end(), 0);
+    std::fill(m_markedTable.begin(), m_markedTable.end(), 0);
+    std::fill(m_table.begin(), m_table.end(), 0);
+    m_filled = false;
+  }
+  m_candidates = 0;
+}
+
+/*---------------------------------------------------------*/
+bool TrigT1CaloJetWindowEngine::add(int eta, int phi, int et)
+/*---------------------------------------------------------*/
+{
+  if (eta < 0 || eta >= m_etaBins || phi < 0 || phi >= m_phiBins) {
+    return false;
+  }
+  m_et[cell(eta, phi)] += et;
+  m_filled = true;
+  return true;
+}
+
+/*---------------------------------------------------------*/
+void TrigT1CaloJetWindowEngine::process()
+/*---------------------------------------------------------*/
+{
+  m_candidates = 0;
+  if (!m_filled) return;
+
+  // Wrap phi padding rows and build the summed-area table
+
+  for (int row = 0; row < s_pad; ++row) {
+    std::copy(&m_et[cell(-s_pad, m_phiBins - s_pad + row)],
+              &m_et[cell(-s_pad, m_phiBins - s_pad + row)] + m_stride,
+              &m_et[cell(-s_pad, row - s_pad)]);
+    std::copy(&m_et[cell(-s_pad, row)], &m_et[cell(-s_pad, row)] + m_stride,
+              &m_et[cell(-s_pad, m_phiBins + row)]);
+  }
+  buildTable(m_et, m_table);
+
+  // 2x2 core sums at all positions whose neighbours may be RoIs
+
+  const int tstride = m_stride + 1;
+  for (int phi = -1; phi <= m_phiBins; ++phi) {
+    const int* lo = &m_table[(phi + s_pad) * tstride + s_pad];
+    const int* hi = lo + 2*tstride;
+    int* core = &m_core[cell(0, phi)];
+    for (int eta = -2; eta <= m_etaBins; ++eta) {
+      core[eta] = hi[eta + 2] - hi[eta] - lo[eta + 2] + lo[eta];
+    }
+  }
+
+  // Local maximum test against the eight neighbouring cores, allowing
+  // ties so that any tie-break rule gives a subset of these
+
+  for (int phi = 0; phi < m_phiBins; ++phi) {
+    const int* down = &m_core[cell(0, phi - 1)];
+    const int* mid  = &m_core[cell(0, phi)];
+    const int* up   = &m_core[cell(0, phi + 1)];
+    const int phiUp = (phi + 1 < m_phiBins) ? phi + 1 : 0;
+    for (int eta = -1; eta < m_etaBins; ++eta) {
+      const int c = mid[eta];
+      const bool candidate = (c > 0) &
+                             (c >= mid[eta - 1])  & (c >= mid[eta + 1])  &
+                             (c >= down[eta - 1]) & (c >= down[eta])     &
+                             (c >= down[eta + 1]) & (c >= up[eta - 1])   &
+                             (c >= up[eta])       & (c >= up[eta + 1]);
+      if (!candidate) continue;
+      ++m_candidates;
+      for (int e = eta; e <= eta + 1; ++e) {
+        if (e < 0 || e >= m_etaBins) continue;
+        m_marked[cell(e, phi)]   = 1;
+        m_marked[cell(e, phiUp)] = 1;
+      }
+    }
+  }
+
+  // Saturated Jet Elements mark everything they can reach
+
+  for (int phi = 0; phi < m_phiBins; ++phi) {
+    const int* et = &m_et[cell(0, phi)];
+    for (int eta = 0; eta < m_etaBins; ++eta) {
+      if (et[eta] < m_saturation) continue;
+      for (int dphi = -2; dphi <= 2; ++dphi) {
+        const int p = (phi + dphi + m_phiBins) % m_phiBins;
+        const int e1 = std::max(eta - 2, 0);
+        const int e2 = std::min(eta + 2, m_etaBins - 1);
+        for (int e = e1; e <= e2; ++e) m_marked[cell(e, p)] = 1;
+      }
+    }
+  }
+
+  // Table of marked elements for needed()
+
+  for (int row = 0; row < s_pad; ++row) {
+    std::copy(&m_marked[cell(-s_pad, m_phiBins - s_pad + row)],
+              &m_marked[cell(-s_pad, m_phiBins - s_pad + row)] + m_stride,
+              &m_marked[cell(-s_pad, row - s_pad)]);
+    std::copy(&m_marked[cell(-s_pad, row)],
+              &m_marked[cell(-s_pad, row)] + m_stride,
+              &m_marked[cell(-s_pad, m_phiBins + row)]);
+  }
+  buildTable(m_marked, m_markedTable);
+}
+
+/*---------------------------------------------------------*/
+void TrigT1CaloJetWindowEngine::buildTable(const std::vector<int>& cells,
+                                                 std::vector<int>& table)
+/*---------------------------------------------------------*/
+{
+  const int tstride = m_stride + 1;
+  for (int row = 0; row < m_rows; ++row) {
+    const int* in   = &cells[row * m_stride];
+    const int* prev = &table[row * tstride];
+    int* out = &table[(row + 1) * tstride];
+    int rowSum = 0;
+    out[0] = 0;
+    for (int col = 0; col < m_stride; ++col) {
+      rowSum += in[col];
+      out[col + 1] = prev[col + 1] + rowSum;
+    }
+  }
+}
+
+/*---------------------------------------------------------*/
+int TrigT1CaloJetWindowEngine::tableSum(const std::vector<int>& table,
+                                        int eta, int phi,
+                                        int etaSize, int phiSize) const
+/*---------------------------------------------------------*/
+{
+  const int tstride = m_stride + 1;
+  const int c1 = std::max(eta + s_pad, 0);
+  const int c2 = std::min(eta + s_pad + etaSize, m_stride);
+  const int r1 = std::max(phi + s_pad, 0);
+  const int r2 = std::min(phi + s_pad + phiSize, m_rows);
+  if (c1 >= c2 || r1 >= r2) return 0;
+  return table[r2*tstride + c2] - table[r1*tstride + c2]
+       - table[r2*tstride + c1] + table[r1*tstride + c1];
+}
+
+/*---------------------------------------------------------*/
+int TrigT1CaloJetWindowEngine::etaIndex(double eta)
+/*---------------------------------------------------------*/
+{
+  if (eta < etaEdges[0] || eta >= etaEdges[s_etaBins]) return -1;
+  return std::upper_bound(etaEdges, etaEdges + s_etaBins + 1, eta)
+                                                            - etaEdges - 1;
+}
+
+/*---------------------------------------------------------*/
+int TrigT1CaloJetWindowEngine::phiIndex(double phi)
+/*---------------------------------------------------------*/
+{
+  const double twoPi = 2.*M_PI;
+  if (phi < 0.) phi += twoPi;
+  const int bin = int(phi * s_phiBins / twoPi);
+  return (bin < s_phiBins) ? ((bin >= 0) ? bin : 0) : s_phiBins - 1;
+}
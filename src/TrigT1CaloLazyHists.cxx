@@ -0,0 +1,80 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloLazyHists.cxx
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+
+#include "LWHists/LWHist.h"
+
+#include "TrigT1CaloMonitoring/TrigT1CaloLazyHists.h"
+
+/*---------------------------------------------------------*/
+TrigT1CaloLazyHists::TrigT1CaloLazyHists()
+  : m_enabled(false)
+/*---------------------------------------------------------*/
+{
+}
+
+/*---------------------------------------------------------*/
+TrigT1CaloLazyHists::~TrigT1CaloLazyHists()
+/*---------------------------------------------------------*/
+{
+  deleteDropped();
+}
+
+/*---------------------------------------------------------*/
+void TrigT1CaloLazyHists::setup(bool enabled)
+/*---------------------------------------------------------*/
+{
+  m_enabled = enabled;
+  m_hists.clear();
+  deleteDropped();
+}
+
+/*---------------------------------------------------------*/
+StatusCode TrigT1CaloLazyHists::defer(LWHist* hist,
+                               const ManagedMonitorToolBase::MonGroup& group)
+/*---------------------------------------------------------*/
+{
+  if (!m_enabled || !hist) return StatusCode::SUCCESS;
+  ManagedMonitorToolBase::MonGroup grp(group);
+  const StatusCode sc = grp.deregHist(hist);
+  if (sc.isSuccess()) m_hists.push_back(std::make_pair(hist, grp));
+  return sc;
+}
+
+/*---------------------------------------------------------*/
+StatusCode TrigT1CaloLazyHists::registerFilled(int& registered, int& dropped)
+/*---------------------------------------------------------*/
+{
+  StatusCode sc = StatusCode::SUCCESS;
+  registered = 0;
+  dropped    = 0;
+  std::vector<std::pair<LWHist*, ManagedMonitorToolBase::MonGroup> >::iterator
+                                                          it  = m_hists.begin();
+  std::vector<std::pair<LWHist*, ManagedMonitorToolBase::MonGroup> >::iterator
+                                                          itE = m_hists.end();
+  for (; it != itE; ++it) {
+    LWHist* hist = it->first;
+    if (hist->GetEntries() > 0) {
+      if (it->second.regHist(hist).isFailure()) sc = StatusCode::FAILURE;
+      ++registered;
+    } else {
+      m_dropped.push_back(hist);
+      ++dropped;
+    }
+  }
+  m_hists.clear();
+  return sc;
+}
+
+/*---------------------------------------------------------*/
+void TrigT1CaloLazyHists::deleteDropped()
+/*---------------------------------------------------------*/
+{
+  std::vector<LWHist*>::iterator it  = m_dropped.begin();
+  std::vector<LWHist*>::iterator itE = m_dropped.end();
+  for (; it != itE; ++it) LWHist::safeDelete(*it);
+  m_dropped.clear();
+}
@@ -0,0 +1,50 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloProfileStore.cxx
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+
+#include <cmath>
+
+#include "LWHists/TProfile_LW.h"
+
+#include "TrigT1CaloMonitoring/TrigT1CaloProfileStore.h"
+
+/*---------------------------------------------------------*/
+TrigT1CaloProfileStore::TrigT1CaloProfileStore()
+/*---------------------------------------------------------*/
+{
+}
+
+/*---------------------------------------------------------*/
+void TrigT1CaloProfileStore::setup(int cells)
+/*---------------------------------------------------------*/
+{
+  m_n.assign(cells, 0.);
+  m_sum.assign(cells, 0.);
+  m_sum2.assign(cells, 0.);
+  m_pending.assign(cells, 0.);
+}
+
+/*---------------------------------------------------------*/
+void TrigT1CaloProfileStore::flush(TProfile_LW* hist, int first, int nbins)
+/*---------------------------------------------------------*/
+{
+  if (!hist) return;
+  double total = 0.;
+  for (int bin = 1; bin <= nbins; ++bin) {
+    const int cell = first + bin - 1;
+    if (m_pending[cell] == 0.) continue;
+
+    // Error is spread/sqrt(entries)
+    const double n    = m_n[cell];
+    const double mean = m_sum[cell]/n;
+    const double var  = m_sum2[cell]/n - mean*mean;
+    const double error = (var > 0.) ? std::sqrt(var/n) : 0.;
+    hist->SetBinInfo(bin, n, mean, error);
+    total += m_pending[cell];
+    m_pending[cell] = 0.;
+  }
+  if (total > 0.) hist->SetEntries(hist->GetEntries() + total);
+}
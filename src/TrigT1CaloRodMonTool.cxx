@@ -15,16 +15,15 @@
 
 #include "GaudiKernel/MsgStream.h"
 #include "GaudiKernel/StatusCode.h"
-#include "SGTools/StlVectorClids.h"
 
 #include "EventInfo/EventInfo.h"
 #include "EventInfo/TriggerInfo.h"
 
 #include "AthenaMonitoring/AthenaMonManager.h"
 
-#include "TrigT1CaloEvent/RODHeader.h"
-
 #include "TrigT1CaloMonitoring/TrigT1CaloRodMonTool.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloErrorBoardTool.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloRodSummary.h"
 #include "TrigT1CaloMonitoringTools/TrigT1CaloMonErrorTool.h"
 #include "TrigT1CaloMonitoringTools/TrigT1CaloLWHistogramTool.h"
 
@@ -35,6 +34,7 @@ TrigT1CaloRodMonTool::TrigT1CaloRodMonTool(const std::string & type,
   : ManagedMonitorToolBase(type, name, parent),
     m_errorTool("TrigT1CaloMonErrorTool"),
     m_histTool("TrigT1CaloLWHistogramTool"),
+    m_errorBoard("TrigT1CaloErrorBoardTool"),
     m_events(0),
     m_histBooked(false),
     m_h_rod_1d_PpPayload(0),
@@ -66,8 +66,6 @@ TrigT1CaloRodMonTool::TrigT1CaloRodMonTool(const std::string & type,
 {
 
   declareProperty("RodHeaderLocation", m_rodHeaderLocation = "RODHeaders");
-  m_cpRoibRodHeaderLocation  = m_rodHeaderLocation + "CPRoIB";
-  m_jepRoibRodHeaderLocation = m_rodHeaderLocation + "JEPRoIB";
 
   declareProperty("RootDirectory", m_rootDir = "L1Calo");
   declareProperty("OnlineTest", m_onlineTest = false,
@@ -111,6 +109,13 @@ StatusCode TrigT1CaloRodMonTool:: initialize()
     return sc;
   }
 
+  sc = m_errorBoard.retrieve();
+  if( sc.isFailure() ) {
+    msg(MSG::ERROR) << "Unable to locate Tool TrigT1CaloErrorBoardTool"
+                    << endreq;
+    return sc;
+  }
+
   return StatusCode::SUCCESS;
 }
 
@@ -516,33 +521,11 @@ StatusCode TrigT1CaloRodMonTool::fillHistograms()
 
   if ( !corrupt ) {
 
-    //Retrieve DAQ ROD Headers from SG
-    const RodHeaderCollection* rodTES = 0; 
-    if (evtStore()->contains<RodHeaderCollection>(m_rodHeaderLocation)) {
-      sc = evtStore()->retrieve(rodTES, m_rodHeaderLocation); 
-    } else sc = StatusCode::FAILURE;
-    if( sc.isFailure()  ||  !rodTES ) {
-      if (debug) msg(MSG::DEBUG) << "No DAQ ROD Header container found"
-                                 << endreq; 
-    }
-
-    //Retrieve CP RoIB ROD Headers from SG
-    const RodHeaderCollection* cpRoibTES = 0; 
-    if (evtStore()->contains<RodHeaderCollection>(m_cpRoibRodHeaderLocation)) {
-      sc = evtStore()->retrieve(cpRoibTES, m_cpRoibRodHeaderLocation); 
-    } else sc = StatusCode::FAILURE;
-    if( sc.isFailure()  ||  !cpRoibTES ) {
-      if (debug) msg(MSG::DEBUG) << "No CP RoIB ROD Header container found"
-                                 << endreq; 
-    }
-
-    //Retrieve JEP RoIB ROD Headers from SG
-    const RodHeaderCollection* jepRoibTES = 0; 
-    if (evtStore()->contains<RodHeaderCollection>(m_jepRoibRodHeaderLocation)) {
-      sc = evtStore()->retrieve(jepRoibTES, m_jepRoibRodHeaderLocation); 
-    } else sc = StatusCode::FAILURE;
-    if( sc.isFailure()  ||  !jepRoibTES ) {
-      if (debug) msg(MSG::DEBUG) << "No JEP RoIB ROD Header container found"
+    //Decoded ROD Headers, DAQ and CP/JEP RoIB, shared with other tools
+    const TrigT1CaloRodSummary* rodSummary =
+                 TrigT1CaloRodSummary::get(*evtStore(), m_rodHeaderLocation);
+    if ( !rodSummary ) {
+      if (debug) msg(MSG::DEBUG) << "No ROD Header summary available"
                                  << endreq; 
     }
 
@@ -552,93 +535,43 @@ StatusCode TrigT1CaloRodMonTool::fillHistograms()
 
     std::vector<int> noFragmentFlags(80, 1);
     std::vector<int> noPayloadFlags(56, 1);
-    std::vector<const RodHeaderCollection*> cols;
-    if (rodTES)     cols.push_back(rodTES);
-    if (cpRoibTES)  cols.push_back(cpRoibTES);
-    if (jepRoibTES) cols.push_back(jepRoibTES);
-    std::vector<const RodHeaderCollection*>::const_iterator colIter =
-                                                                 cols.begin();
-    std::vector<const RodHeaderCollection*>::const_iterator colIterEnd =
-                                                                   cols.end();
-    for (; colIter != colIterEnd; ++colIter) {
-      RodHeaderCollection::const_iterator iter    = (*colIter)->begin();
-      RodHeaderCollection::const_iterator iterEnd = (*colIter)->end();
-      for (; iter != iterEnd; ++iter) {
-        const LVL1::RODHeader* header = *iter;
-        const int crate = header->crate();
-        const int slink = header->sLink();
-        const int dataType = header->dataType();
-        const int rod = crate + dataType*6;
-        const int nData = header->payloadSize();
-        const int pos = rod*4 + slink;
-        // Skip obviously corrupt data
-        if (crate > 13 || slink > 3 || nData < 0 ||
-                          nData > 10000 || pos >= 80) continue;
-        noFragmentFlags[pos] = 0;
-        if (pos < 56 && nData > 0) noPayloadFlags[pos] = 0;
-        m_sumPayloads1[pos] += nData;
-        m_sumPayloads2[pos] += nData;
-        // Status bits
-        TH2F_LW* hist = m_h_rod_2d_PpStatus;
-        int val = pos;
-        if (pos >= 72) {
-          hist = m_h_rod_2d_CpJepRoiStatus;
-	  val = (pos-72)/2 + 8;
-        } else if (pos >= 56) {
-          hist = m_h_rod_2d_CpJepRoiStatus;
-	  val = (pos-56)/2;
-        } else if (pos >= 48) {
-          hist = m_h_rod_2d_CpJepStatus;
-	  val = pos-48 + 8;
-        } else if (pos >= 32) {
-          hist = m_h_rod_2d_CpJepStatus;
-	  val = (pos-32)/2;
-        }
-	// ToDo: Fix properly in RODHeader.
-        // gLinkError is actually OR'ed with cmmParityError
-	// (email from Weiming 26/06/09)
-        //if (header->gLinkError()) {
-	// gLinkError and LinkError are interchanged
-	// (email from Bruce 10/03/10
-        //if (header->cmmParityError()) {
-        if (header->lvdsLinkError()) {
-          hist->Fill(GLink, val);
-	  errors[GLink] = 1;
-	  crateErr[crate] |= (1 << GLink);
-        }
-        //if (header->cmmParityError()) {
-        //  hist->Fill(CMMParity, val);
-        //  errors[CMMParity] = 1;
-        //  crateErr[crate] |= (1 << CMMParity);
-        //}
-        //if (header->lvdsLinkError()) {
-        if (header->cmmParityError()) {
-          hist->Fill(LVDSLink, val);
-	  errors[LVDSLink] = 1;
-	  crateErr[crate] |= (1 << LVDSLink);
-        }
-        if (header->rodFifoOverflow()) {
-          hist->Fill(FIFOOverflow, val);
-	  errors[FIFOOverflow] = 1;
-	  crateErr[crate] |= (1 << FIFOOverflow);
-        }
-        if (header->dataTransportError()) {
-          hist->Fill(DataTransport, val);
-	  errors[DataTransport] = 1;
-	  crateErr[crate] |= (1 << DataTransport);
-        }
-        if (header->gLinkTimeout()) {
-          hist->Fill(Timeout, val);
-	  errors[Timeout] = 1;
-	  crateErr[crate] |= (1 << Timeout);
-        }
-        if (header->bcnMismatch()) {
-          hist->Fill(BCNMismatch, val);
-	  errors[BCNMismatch] = 1;
-	  crateErr[crate] |= (1 << BCNMismatch);
+    for (int pos = 0; rodSummary && pos < 80; ++pos) {
+      const TrigT1CaloRodSummary::Rod& rod(rodSummary->rod(pos));
+      if ( !rod.present ) continue;
+      const int crate = rod.crate;
+      const int nData = rod.payloadSize;
+      noFragmentFlags[pos] = 0;
+      if (pos < 56 && nData > 0) noPayloadFlags[pos] = 0;
+      m_sumPayloads1[pos] += nData;
+      m_sumPayloads2[pos] += nData;
+      // Status bits
+      TH2F_LW* hist = m_h_rod_2d_PpStatus;
+      int val = pos;
+      if (pos >= 72) {
+        hist = m_h_rod_2d_CpJepRoiStatus;
+        val = (pos-72)/2 + 8;
+      } else if (pos >= 56) {
+        hist = m_h_rod_2d_CpJepRoiStatus;
+        val = (pos-56)/2;
+      } else if (pos >= 48) {
+        hist = m_h_rod_2d_CpJepStatus;
+        val = pos-48 + 8;
+      } else if (pos >= 32) {
+        hist = m_h_rod_2d_CpJepStatus;
+        val = (pos-32)/2;
+      }
+      // Once per header with the bit set.  LimitedRoISet only for RoI RODs,
+      // the DAQ bin is used for NoPayload
+      for (int bit = 0; bit < TrigT1CaloRodSummary::NumberOfStatusBits; ++bit) {
+        const int count = rod.statusCounts[bit];
+        if ( !count ) continue;
+        if (pos < 56 && bit == TrigT1CaloRodSummary::LimitedRoISet) continue;
+        const int bin = statusBin(bit);
+        for (int i = 0; i < count; ++i) hist->Fill(bin, val);
+        if (bin < TriggerType) {
+          errors[bin] = 1;
+          crateErr[crate] |= (1 << bin);
         }
-        if (header->triggerTypeTimeout()) hist->Fill(TriggerType, val);
-        if (pos >= 56 && header->limitedRoISet()) hist->Fill(LimitedRoI, val);
       }
     }
 
@@ -774,12 +707,7 @@ StatusCode TrigT1CaloRodMonTool::fillHistograms()
   // Save error vector for global summary
 
   if ( !corrupt ) {
-    std::vector<int>* save = new std::vector<int>(crateErr);
-    sc = evtStore()->record(save, "L1CaloRODErrorVector");
-    if (sc != StatusCode::SUCCESS) {
-      msg(MSG::ERROR) << "Error recording ROD error vector in TES " << endreq;
-      return sc;
-    }
+    m_errorBoard->set(TrigT1CaloErrorBoardTool::RODError, crateErr);
   }
 
   if (debug) msg(MSG::DEBUG) << "Leaving fillHistograms" << endreq;
@@ -800,6 +728,21 @@ StatusCode TrigT1CaloRodMonTool::procHistograms()
   return StatusCode::SUCCESS;
 }
 
+int TrigT1CaloRodMonTool::statusBin(int bit)
+{
+  switch (bit) {
+    case TrigT1CaloRodSummary::GLinkError:         return GLink;
+    case TrigT1CaloRodSummary::LVDSLinkError:      return LVDSLink;
+    case TrigT1CaloRodSummary::FIFOOverflow:       return FIFOOverflow;
+    case TrigT1CaloRodSummary::DataTransportError: return DataTransport;
+    case TrigT1CaloRodSummary::GLinkTimeout:       return Timeout;
+    case TrigT1CaloRodSummary::BCNMismatch:        return BCNMismatch;
+    case TrigT1CaloRodSummary::TriggerTypeTimeout: return TriggerType;
+    case TrigT1CaloRodSummary::LimitedRoISet:      return LimitedRoI;
+    default:                                       return NoFragment;
+  }
+}
+
 void TrigT1CaloRodMonTool::setLabelsStatus(LWHist* hist, bool xAxis)
 {
   LWHist::LWHistAxis* axis = (xAxis) ? hist->GetXaxis() : hist->GetYaxis();
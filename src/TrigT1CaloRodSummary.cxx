@@ -0,0 +1,117 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloRodSummary.cxx
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+
+#include "StoreGate/StoreGateSvc.h"
+
+#include "TrigT1CaloEvent/RODHeader.h"
+
+#include "TrigT1CaloMonitoring/TrigT1CaloRodSummary.h"
+
+/*---------------------------------------------------------*/
+TrigT1CaloRodSummary::Rod::Rod()
+  : present(false),
+    headers(0),
+    crate(0),
+    dataType(0),
+    payloadSize(0),
+    majorVersion(0),
+    minorVersion(0)
+/*---------------------------------------------------------*/
+{
+  for (int bit = 0; bit < NumberOfStatusBits; ++bit) statusCounts[bit] = 0;
+}
+
+/*---------------------------------------------------------*/
+TrigT1CaloRodSummary::TrigT1CaloRodSummary()
+  : m_rods(s_positions),
+    m_limitedRoi(0),
+    m_roiMinorVersion(s_crates, -1)
+/*---------------------------------------------------------*/
+{
+}
+
+/*---------------------------------------------------------*/
+const TrigT1CaloRodSummary* TrigT1CaloRodSummary::get(StoreGateSvc& store,
+                                      const std::string& rodHeaderLocation)
+/*---------------------------------------------------------*/
+{
+  const std::string key(rodHeaderLocation + "Summary");
+  const TrigT1CaloRodSummary* summary = 0;
+  if (store.contains<TrigT1CaloRodSummary>(key)) {
+    StatusCode sc = store.retrieve(summary, key);
+    if (sc.isFailure()) summary = 0;
+    return summary;
+  }
+
+  TrigT1CaloRodSummary* newSummary = new TrigT1CaloRodSummary;
+  const std::string keys[3] = { rodHeaderLocation,
+                                rodHeaderLocation + "CPRoIB",
+                                rodHeaderLocation + "JEPRoIB" };
+  for (int i = 0; i < 3; ++i) {
+    const RodHeaderCollection* rods = 0;
+    if (store.contains<RodHeaderCollection>(keys[i])) {
+      StatusCode sc = store.retrieve(rods, keys[i]);
+      if (sc.isFailure()) rods = 0;
+    }
+    if (rods) newSummary->add(rods, i == 0);
+  }
+  StatusCode sc = store.record(newSummary, key);
+  if (sc.isFailure()) return 0;
+  return newSummary;
+}
+
+/*---------------------------------------------------------*/
+void TrigT1CaloRodSummary::add(const RodHeaderCollection* rods, bool daq)
+/*---------------------------------------------------------*/
+{
+  RodHeaderCollection::const_iterator iter    = rods->begin();
+  RodHeaderCollection::const_iterator iterEnd = rods->end();
+  for (; iter != iterEnd; ++iter) {
+    const LVL1::RODHeader* header = *iter;
+    const int crate    = header->crate();
+    const int dataType = header->dataType();
+    const int nData    = header->payloadSize();
+    const int pos = position(crate, header->sLink(), dataType);
+    // Skip obviously corrupt data
+    if (pos < 0 || nData < 0 || nData > 10000) continue;
+    Rod& rod(m_rods[pos]);
+    rod.present      = true;
+    ++rod.headers;
+    rod.crate        = crate;
+    rod.dataType     = dataType;
+    rod.payloadSize += nData;
+    rod.majorVersion = header->majorVersion();
+    rod.minorVersion = header->minorVersion();
+    // gLinkError is actually OR'ed with cmmParityError
+    // (email from Weiming 26/06/09)
+    // gLinkError and LinkError are interchanged
+    // (email from Bruce 10/03/10)
+    // ToDo: Fix properly in RODHeader.
+    if (header->lvdsLinkError())      ++rod.statusCounts[GLinkError];
+    if (header->cmmParityError())     ++rod.statusCounts[LVDSLinkError];
+    if (header->rodFifoOverflow())    ++rod.statusCounts[FIFOOverflow];
+    if (header->dataTransportError()) ++rod.statusCounts[DataTransportError];
+    if (header->gLinkTimeout())       ++rod.statusCounts[GLinkTimeout];
+    if (header->bcnMismatch())        ++rod.statusCounts[BCNMismatch];
+    if (header->triggerTypeTimeout()) ++rod.statusCounts[TriggerTypeTimeout];
+    if (header->limitedRoISet())      ++rod.statusCounts[LimitedRoISet];
+    if (daq && dataType == 1) {
+      if (header->limitedRoISet()) m_limitedRoi |= (1 << crate);
+      m_roiMinorVersion[crate] = header->minorVersion();
+    }
+  }
+}
+
+/*---------------------------------------------------------*/
+int TrigT1CaloRodSummary::position(int crate, int slink, int dataType)
+/*---------------------------------------------------------*/
+{
+  if (crate < 0 || crate >= s_crates || slink < 0 || slink > 3 ||
+      dataType < 0) return -1;
+  const int pos = (crate + dataType*6)*4 + slink;
+  return (pos < s_positions) ? pos : -1;
+}
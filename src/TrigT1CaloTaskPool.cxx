@@ -0,0 +1,118 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloTaskPool.cxx
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+
+#include <boost/bind.hpp>
+
+#include "TrigT1CaloMonitoring/TrigT1CaloTaskPool.h"
+
+/*---------------------------------------------------------*/
+TrigT1CaloTaskPool::TrigT1CaloTaskPool()
+  : m_tasks(0),
+    m_next(0),
+    m_finished(0),
+    m_generation(0),
+    m_failed(false),
+    m_stop(false)
+/*---------------------------------------------------------*/
+{
+}
+
+/*---------------------------------------------------------*/
+TrigT1CaloTaskPool::~TrigT1CaloTaskPool()
+/*---------------------------------------------------------*/
+{
+  stop();
+}
+
+/*---------------------------------------------------------*/
+bool TrigT1CaloTaskPool::start(int nthreads)
+/*---------------------------------------------------------*/
+{
+  stop();
+  for (int i = 1; i < nthreads; ++i) {
+    try {
+      m_threads.push_back(
+                 new boost::thread(boost::bind(&TrigT1CaloTaskPool::work, this)));
+    } catch (const boost::thread_resource_error&) {
+      stop();
+      return false;
+    }
+  }
+  return true;
+}
+
+/*---------------------------------------------------------*/
+void TrigT1CaloTaskPool::stop()
+/*---------------------------------------------------------*/
+{
+  if (m_threads.empty()) return;
+  {
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_wake.notify_all();
+  std::vector<boost::thread*>::iterator it  = m_threads.begin();
+  std::vector<boost::thread*>::iterator itE = m_threads.end();
+  for (; it != itE; ++it) {
+    (*it)->join();
+    delete *it;
+  }
+  m_threads.clear();
+  m_stop = false;
+}
+
+/*---------------------------------------------------------*/
+bool TrigT1CaloTaskPool::run(const std::vector<Task*>& tasks)
+/*---------------------------------------------------------*/
+{
+  if (tasks.empty()) return true;
+  boost::unique_lock<boost::mutex> lock(m_mutex);
+  m_tasks    = &tasks;
+  m_next     = 0;
+  m_finished = 0;
+  m_failed   = false;
+  ++m_generation;
+  if (!m_threads.empty()) m_wake.notify_all();
+  drain(lock);
+  while (m_finished < tasks.size()) m_done.wait(lock);
+  m_tasks = 0;
+  return !m_failed;
+}
+
+/*---------------------------------------------------------*/
+void TrigT1CaloTaskPool::work()
+/*---------------------------------------------------------*/
+{
+  unsigned long seen = 0;
+  boost::unique_lock<boost::mutex> lock(m_mutex);
+  while (true) {
+    while (!m_stop && (m_generation == seen || !m_tasks)) m_wake.wait(lock);
+    if (m_stop) return;
+    seen = m_generation;
+    drain(lock);
+  }
+}
+
+/*---------------------------------------------------------*/
+void TrigT1CaloTaskPool::drain(boost::unique_lock<boost::mutex>& lock)
+/*---------------------------------------------------------*/
+{
+  while (m_tasks && m_next < m_tasks->size()) {
+    Task* task = (*m_tasks)[m_next++];
+    const unsigned int ntasks = m_tasks->size();
+    bool failed = false;
+    lock.unlock();
+    try {
+      task->execute();
+    } catch (...) {
+      failed = true;
+    }
+    lock.lock();
+    if (failed) m_failed = true;
+    if (++m_finished == ntasks) m_done.notify_all();
+  }
+}
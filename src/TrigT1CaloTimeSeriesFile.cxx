@@ -0,0 +1,213 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloTimeSeriesFile.cxx
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+
+#include <algorithm>
+#include <fstream>
+
+#include "TrigT1CaloMonitoring/TrigT1CaloChannelStats.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloTimeSeriesFile.h"
+
+namespace {
+
+const char s_magic[4] = { 'L', '1', 'T', 'S' };
+
+template <class T>
+void writeColumn(std::ofstream& out, const std::vector<T>& column)
+{
+  if (!column.empty()) {
+    out.write(reinterpret_cast<const char*>(&column[0]),
+              column.size() * sizeof(T));
+  }
+}
+
+// Bytes left between the read position and the end of the file
+std::size_t remaining(std::ifstream& in)
+{
+  const std::streampos pos = in.tellg();
+  in.seekg(0, std::ios::end);
+  const std::streampos end = in.tellg();
+  in.seekg(pos);
+  return (pos < 0 || end < pos) ? 0 : std::size_t(end - pos);
+}
+
+template <class T>
+bool readColumn(std::ifstream& in, std::vector<T>& column, std::size_t n)
+{
+  if (n > remaining(in) / sizeof(T)) return false;
+  column.resize(n);
+  if (n > 0) {
+    in.read(reinterpret_cast<char*>(&column[0]), n * sizeof(T));
+  }
+  return in.good();
+}
+
+}
+
+/*---------------------------------------------------------*/
+TrigT1CaloTimeSeriesFile::TrigT1CaloTimeSeriesFile() : m_run(0)
+/*---------------------------------------------------------*/
+{
+}
+
+/*---------------------------------------------------------*/
+bool TrigT1CaloTimeSeriesFile::write(const std::string& fileName,
+                  unsigned int run,
+                  const std::vector<std::string>& names,
+                  const std::vector<const TrigT1CaloChannelStats*>& stats,
+                  const std::vector<unsigned int>& channelIds)
+/*---------------------------------------------------------*/
+{
+  const unsigned int nQuantities = stats.size();
+  const unsigned int nChannels   = channelIds.size();
+  if (names.size() != nQuantities) return false;
+  for (unsigned int q = 0; q < nQuantities; ++q) {
+    if (stats[q]->channels() != int(nChannels)) return false;
+  }
+
+  // Lumiblocks with data in any store
+
+  std::vector<unsigned int> lumiBlocks;
+  int maxLumiBlocks = 0;
+  for (unsigned int q = 0; q < nQuantities; ++q) {
+    maxLumiBlocks = std::max(maxLumiBlocks, stats[q]->lumiBlocks());
+  }
+  for (int lb = 0; lb < maxLumiBlocks; ++lb) {
+    for (unsigned int q = 0; q < nQuantities; ++q) {
+      if (stats[q]->filled(lb)) {
+        lumiBlocks.push_back(lb);
+        break;
+      }
+    }
+  }
+  const unsigned int nLumiBlocks = lumiBlocks.size();
+
+  std::ofstream out(fileName.c_str(), std::ios::out | std::ios::binary);
+  if (!out) return false;
+  const unsigned int header[5] = { s_version, run, nChannels, nLumiBlocks,
+                                   nQuantities };
+  out.write(s_magic, sizeof(s_magic));
+  out.write(reinterpret_cast<const char*>(header), sizeof(header));
+  for (unsigned int q = 0; q < nQuantities; ++q) {
+    const unsigned int length = names[q].size();
+    out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    out.write(names[q].data(), length);
+  }
+  writeColumn(out, channelIds);
+  writeColumn(out, lumiBlocks);
+
+  const unsigned int nCells = nChannels * nLumiBlocks;
+  std::vector<unsigned int> entries(nCells);
+  std::vector<float> mean(nCells);
+  std::vector<float> rms(nCells);
+  for (unsigned int q = 0; q < nQuantities; ++q) {
+    unsigned int cell = 0;
+    for (unsigned int ch = 0; ch < nChannels; ++ch) {
+      for (unsigned int pos = 0; pos < nLumiBlocks; ++pos, ++cell) {
+        const TrigT1CaloChannelStats::Moments* moments =
+                                   stats[q]->moments(ch, lumiBlocks[pos]);
+        if (moments) {
+          entries[cell] = moments->entries;
+          mean[cell]    = moments->mean;
+          rms[cell]     = moments->rms();
+        } else {
+          entries[cell] = 0;
+          mean[cell]    = 0.;
+          rms[cell]     = 0.;
+        }
+      }
+    }
+    writeColumn(out, entries);
+    writeColumn(out, mean);
+    writeColumn(out, rms);
+  }
+  out.close();
+  return !out.fail();
+}
+
+/*---------------------------------------------------------*/
+bool TrigT1CaloTimeSeriesFile::read(const std::string& fileName)
+/*---------------------------------------------------------*/
+{
+  clear();
+  std::ifstream in(fileName.c_str(), std::ios::in | std::ios::binary);
+  if (!in || !load(in)) {
+    clear();
+    return false;
+  }
+  return true;
+}
+
+/*---------------------------------------------------------*/
+bool TrigT1CaloTimeSeriesFile::load(std::ifstream& in)
+/*---------------------------------------------------------*/
+{
+  char magic[4];
+  unsigned int header[5];
+  in.read(magic, sizeof(magic));
+  in.read(reinterpret_cast<char*>(header), sizeof(header));
+  if (!in.good() || !std::equal(magic, magic + 4, s_magic) ||
+      header[0] != s_version) return false;
+  m_run = header[1];
+  const unsigned int nChannels   = header[2];
+  const unsigned int nLumiBlocks = header[3];
+  const unsigned int nQuantities = header[4];
+  for (unsigned int q = 0; q < nQuantities; ++q) {
+    unsigned int length = 0;
+    in.read(reinterpret_cast<char*>(&length), sizeof(length));
+    std::vector<char> name;
+    if (!in.good() || !readColumn(in, name, length)) return false;
+    m_names.push_back(std::string(name.begin(), name.end()));
+  }
+  const std::size_t nCells = std::size_t(nChannels) * nLumiBlocks;
+  return readColumn(in, m_channelIds, nChannels) &&
+         readColumn(in, m_lumiBlocks, nLumiBlocks) &&
+         readColumns(in, nQuantities, nCells);
+}
+
+/*---------------------------------------------------------*/
+bool TrigT1CaloTimeSeriesFile::readColumns(std::ifstream& in,
+                                unsigned int nQuantities, std::size_t nCells)
+/*---------------------------------------------------------*/
+{
+  // Sizes come from the header, so check them before allocating
+  const std::size_t cellBytes = sizeof(unsigned int) + 2 * sizeof(float);
+  if (nQuantities > 0 &&
+      nCells > remaining(in) / (nQuantities * cellBytes)) return false;
+  m_entries.resize(nQuantities * nCells);
+  m_mean.resize(nQuantities * nCells);
+  m_rms.resize(nQuantities * nCells);
+  for (unsigned int q = 0; q < nQuantities && nCells > 0; ++q) {
+    const std::size_t offset = q * nCells;
+    in.read(reinterpret_cast<char*>(&m_entries[offset]),
+            nCells * sizeof(unsigned int));
+    in.read(reinterpret_cast<char*>(&m_mean[offset]), nCells * sizeof(float));
+    in.read(reinterpret_cast<char*>(&m_rms[offset]),  nCells * sizeof(float));
+  }
+  return in.good();
+}
+
+/*---------------------------------------------------------*/
+void TrigT1CaloTimeSeriesFile::clear()
+/*---------------------------------------------------------*/
+{
+  m_run = 0;
+  m_names.clear();
+  m_channelIds.clear();
+  m_lumiBlocks.clear();
+  m_entries.clear();
+  m_mean.clear();
+  m_rms.clear();
+}
+
+/*---------------------------------------------------------*/
+int TrigT1CaloTimeSeriesFile::quantity(const std::string& name) const
+/*---------------------------------------------------------*/
+{
+  std::vector<std::string>::const_iterator it =
+                          std::find(m_names.begin(), m_names.end(), name);
+  return (it == m_names.end()) ? -1 : it - m_names.begin();
+}
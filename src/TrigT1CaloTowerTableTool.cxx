@@ -0,0 +1,212 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloTowerTableTool.cxx
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// ********************************************************************
+
+#include <cmath>
+
+#include "GaudiKernel/MsgStream.h"
+#include "GaudiKernel/StatusCode.h"
+
+#include "EventInfo/EventInfo.h"
+#include "EventInfo/EventID.h"
+
+#include "TrigT1CaloToolInterfaces/IL1TriggerTowerTool.h"
+
+#include "TrigT1CaloMonitoring/TrigT1CaloTowerTableTool.h"
+
+/*---------------------------------------------------------*/
+TrigT1CaloTowerTableTool::TrigT1CaloTowerTableTool(const std::string& type,
+                                                   const std::string& name,
+                                                   const IInterface* parent)
+  : AthAlgTool(type, name, parent),
+    m_ttTool("LVL1::L1TriggerTowerTool/L1TriggerTowerTool"),
+    m_runNumber(0),
+    m_builds(0)
+/*---------------------------------------------------------*/
+{
+  declareInterface<TrigT1CaloTowerTableTool>(this);
+
+  declareProperty("TriggerTowerTool", m_ttTool,
+                  "Tool for identifiers and hardware mapping");
+}
+
+/*---------------------------------------------------------*/
+TrigT1CaloTowerTableTool::~TrigT1CaloTowerTableTool()
+/*---------------------------------------------------------*/
+{
+}
+
+#ifndef PACKAGE_VERSION
+#define PACKAGE_VERSION "unknown"
+#endif
+
+/*---------------------------------------------------------*/
+StatusCode TrigT1CaloTowerTableTool::initialize()
+/*---------------------------------------------------------*/
+{
+  msg(MSG::INFO) << "Initializing " << name() << " - package version "
+                 << PACKAGE_VERSION << endreq;
+
+  StatusCode sc = m_ttTool.retrieve();
+  if( sc.isFailure() ) {
+    msg(MSG::ERROR) << "Unable to locate Tool L1TriggerTowerTool" << endreq;
+    return sc;
+  }
+
+  return StatusCode::SUCCESS;
+}
+
+/*---------------------------------------------------------*/
+StatusCode TrigT1CaloTowerTableTool::finalize()
+/*---------------------------------------------------------*/
+{
+  if (msgLvl(MSG::DEBUG)) {
+    msg(MSG::DEBUG) << "Tower table built " << m_builds << " time(s)"
+                    << endreq;
+  }
+  return StatusCode::SUCCESS;
+}
+
+/*---------------------------------------------------------*/
+StatusCode TrigT1CaloTowerTableTool::update()
+/*---------------------------------------------------------*/
+{
+  unsigned int run = 0;
+  const EventInfo* evInfo = 0;
+  StatusCode sc = evtStore()->retrieve(evInfo);
+  if (sc.isSuccess() && evInfo) {
+    const EventID* evID = evInfo->event_ID();
+    if (evID) run = evID->run_number();
+  }
+  if (!m_towers.empty() && run == m_runNumber) return StatusCode::SUCCESS;
+
+  if (msgLvl(MSG::DEBUG)) {
+    msg(MSG::DEBUG) << "Building tower table for run " << run << endreq;
+  }
+
+  const int nAbsEtaBins = 33;
+  m_towers.clear();
+  m_towers.resize(numberOfTowers());
+  for (int side = 0; side < 2; ++side) {
+    for (int absEtaBin = 0; absEtaBin < nAbsEtaBins; ++absEtaBin) {
+      const double eta = (side) ? etaCentre(absEtaBin) : -etaCentre(absEtaBin);
+      const int nPhi = (absEtaBin < 25) ? 64 : (absEtaBin < 29) ? 32 : 16;
+      const double phiWidth = 2.*M_PI/nPhi;
+      for (int phiBin = 0; phiBin < nPhi; ++phiBin) {
+        const double phi = (phiBin + 0.5)*phiWidth;
+	Tower& tt(m_towers[index(eta, phi)]);
+	tt.eta     = eta;
+	tt.phi     = phi;
+	for (int layer = 0; layer < 2; ++layer) {
+	  Channel& chan(tt.layer[layer]);
+	  chan.coolId     = m_ttTool->channelID(eta, phi, layer);
+	  chan.identifier = m_ttTool->identifier(eta, phi, layer);
+	  chan.crate      = chan.coolId.crate();
+	  chan.module     = chan.coolId.module();
+	  chan.subModule  = chan.coolId.subModule();
+	  chan.channel    = chan.coolId.channel();
+	  chan.partition  = partition(layer, eta);
+	}
+      }
+    }
+  }
+  m_runNumber = run;
+  ++m_builds;
+
+  return StatusCode::SUCCESS;
+}
+
+/*---------------------------------------------------------*/
+int TrigT1CaloTowerTableTool::index(double eta, double phi) const
+/*---------------------------------------------------------*/
+{
+  const double absEta = std::fabs(eta);
+  int absEtaBin = 0;
+  int nPhi      = 64;
+  int offset    = 0;
+  if (absEta < 2.5) {
+    absEtaBin = int(absEta/0.1);
+    offset    = absEtaBin*64;
+  } else if (absEta < 3.2) {
+    absEtaBin = (absEta < 3.1) ? int((absEta - 2.5)/0.2) : 3;
+    nPhi      = 32;
+    offset    = 1600 + absEtaBin*32;
+  } else {
+    absEtaBin = int((absEta - 3.2)/0.425);
+    if (absEtaBin > 3) absEtaBin = 3;
+    nPhi      = 16;
+    offset    = 1728 + absEtaBin*16;
+  }
+  int phiBin = int(phi*nPhi/(2.*M_PI));
+  if (phiBin < 0)     phiBin = 0;
+  if (phiBin >= nPhi) phiBin = nPhi - 1;
+  if (eta > 0.) offset += s_towersPerSide;
+  return offset + phiBin;
+}
+
+/*---------------------------------------------------------*/
+double TrigT1CaloTowerTableTool::etaCentre(int absEtaBin) const
+/*---------------------------------------------------------*/
+{
+  if (absEtaBin < 25) return 0.05 + 0.1*absEtaBin;
+  if (absEtaBin < 28) return 2.6 + 0.2*(absEtaBin - 25);
+  if (absEtaBin < 29) return 3.15;
+  return 3.2 + 0.425*(absEtaBin - 29) + 0.2125;
+}
+
+/*---------------------------------------------------------*/
+int TrigT1CaloTowerTableTool::partition(int layer, double eta) {
+/*---------------------------------------------------------*/
+
+  int part = 0;
+  if (layer == 0) {
+    if      (eta < -3.2) part = LArFCAL1C;
+    else if (eta < -1.5) part = LArEMECC;
+    else if (eta < -1.4) part = LArOverlapC;
+    else if (eta <  0.0) part = LArEMBC;
+    else if (eta <  1.4) part = LArEMBA;
+    else if (eta <  1.5) part = LArOverlapA;
+    else if (eta <  3.2) part = LArEMECA;
+    else                 part = LArFCAL1A;
+  } else {
+    if      (eta < -3.2) part = LArFCAL23C;
+    else if (eta < -1.5) part = LArHECC;
+    else if (eta < -0.9) part = TileEBC;
+    else if (eta <  0.0) part = TileLBC;
+    else if (eta <  0.9) part = TileLBA;
+    else if (eta <  1.5) part = TileEBA;
+    else if (eta <  3.2) part = LArHECA;
+    else                 part = LArFCAL23A;
+  }
+  return part;
+}
+
+/*---------------------------------------------------------*/
+std::string TrigT1CaloTowerTableTool::partitionName(int part) {
+/*---------------------------------------------------------*/
+
+  std::string name = "";
+  switch (part) {
+    case LArFCAL1C:   name = "LArFCAL1C";   break;
+    case LArEMECC:    name = "LArEMECC";    break;
+    case LArOverlapC: name = "LArOverlapC"; break;
+    case LArEMBC:     name = "LArEMBC";     break;
+    case LArEMBA:     name = "LArEMBA";     break;
+    case LArOverlapA: name = "LArOverlapA"; break;
+    case LArEMECA:    name = "LArEMECA";    break;
+    case LArFCAL1A:   name = "LArFCAL1A";   break;
+    case LArFCAL23C:  name = "LArFCAL23C";  break;
+    case LArHECC:     name = "LArHECC";     break;
+    case TileEBC:     name = "TileEBC";     break;
+    case TileLBC:     name = "TileLBC";     break;
+    case TileLBA:     name = "TileLBA";     break;
+    case TileEBA:     name = "TileEBA";     break;
+    case LArHECA:     name = "LArHECA";     break;
+    case LArFCAL23A:  name = "LArFCAL23A";  break;
+    default:          name = "Unknown";     break;
+  }
+  return name;
+}
@@ -12,6 +12,8 @@
 #include "TrigT1CaloMonitoring/PPMSimBSMon.h"
 #include "TrigT1CaloMonitoring/EmEfficienciesMonTool.h"
 #include "TrigT1CaloMonitoring/JetEfficienciesMonTool.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloTowerTableTool.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloErrorBoardTool.h"
 
 #include "GaudiKernel/DeclareFactoryEntries.h"
 
@@ -29,6 +31,8 @@ DECLARE_TOOL_FACTORY(CMMMon)
 DECLARE_TOOL_FACTORY(PPMSimBSMon)
 DECLARE_TOOL_FACTORY(EmEfficienciesMonTool)
 DECLARE_TOOL_FACTORY(JetEfficienciesMonTool)
+DECLARE_TOOL_FACTORY(TrigT1CaloTowerTableTool)
+DECLARE_TOOL_FACTORY(TrigT1CaloErrorBoardTool)
 
 DECLARE_FACTORY_ENTRIES(TrigT1CaloMonitoring) {
   DECLARE_ALGTOOL(TrigT1CaloBSMon)
@@ -45,5 +49,7 @@ DECLARE_FACTORY_ENTRIES(TrigT1CaloMonitoring) {
   DECLARE_ALGTOOL(PPMSimBSMon)
   DECLARE_ALGTOOL(EmEfficienciesMonTool)
   DECLARE_ALGTOOL(JetEfficienciesMonTool)
+  DECLARE_ALGTOOL(TrigT1CaloTowerTableTool)
+  DECLARE_ALGTOOL(TrigT1CaloErrorBoardTool)
 }
 
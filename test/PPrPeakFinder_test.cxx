@@ -0,0 +1,185 @@
+// ********************************************************************
+//
+// NAME:     PPrPeakFinder_test.cxx
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// Check that PPrPeakFinder gives the same peak slices as the former
+// PPrMon::recTime, with and without the SSE2 path.
+//
+// ********************************************************************
+
+#undef NDEBUG
+
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "TrigT1CaloMonitoring/PPrPeakFinder.h"
+
+namespace {
+
+const int pedestal = 32;
+const int cut      = 20;
+
+// PPrMon::recTime as it was before PPrPeakFinder
+int recTime(const std::vector<int>& vFAdc, int ped, int cutValue)
+{
+  int max = -1;
+  const int slices = vFAdc.size();
+  if (slices > 0) {
+    max = 0.;
+    int maxAdc = vFAdc[0];
+    for (int sl = 1; sl < slices; ++sl) {
+      if (vFAdc[sl] > maxAdc) {
+        maxAdc = vFAdc[sl];
+        max = sl;
+      } else if (vFAdc[sl] == maxAdc) max = -1;
+    }
+    if (maxAdc == 0) max = -1;
+  }
+  if (max >= 0) {
+    int slbeg = max - 2;
+    if (slbeg < 0) slbeg = 0;
+    int slend = max + 3;
+    if (slend > slices) slend = slices;
+    int sum = 0;
+    int min = 999999;
+    for (int sl = slbeg; sl < slend; ++sl) {
+      int val = vFAdc[sl];
+      if (val < ped) val = ped;
+      sum += val;
+      if (val < min) min = val;
+    }
+    sum -= (slend-slbeg)*min;
+    if (sum <= cutValue) max = -1;
+  }
+  return max;
+}
+
+std::vector<int> waveform(int a0, int a1, int a2, int a3, int a4)
+{
+  std::vector<int> adc;
+  adc.push_back(a0);
+  adc.push_back(a1);
+  adc.push_back(a2);
+  adc.push_back(a3);
+  adc.push_back(a4);
+  return adc;
+}
+
+// Deterministic pseudo-random waveforms
+unsigned int seed = 12345;
+int random(int range)
+{
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 16) % range;
+}
+
+// Run finder over towers with buffer slices, return number of mismatches
+int check(const std::vector<std::vector<int> >& towers, int slices,
+          bool vectorised)
+{
+  PPrPeakFinder finder;
+  finder.setVectorised(vectorised);
+  finder.clear(slices, towers.size());
+  std::vector<int> pos;
+  for (unsigned int i = 0; i < towers.size(); ++i) {
+    pos.push_back(finder.add(towers[i]));
+  }
+  finder.process(pedestal, cut);
+  int bad = 0;
+  for (unsigned int i = 0; i < towers.size(); ++i) {
+    const int expected = recTime(towers[i], pedestal, cut);
+    if (finder.peak(pos[i]) != expected) ++bad;
+    if (PPrPeakFinder::peak(towers[i], pedestal, cut) != expected) ++bad;
+  }
+  return bad;
+}
+
+void run(const std::string& name, const std::vector<std::vector<int> >& towers,
+         int slices)
+{
+  const int badScalar = check(towers, slices, false);
+  const int badVector = check(towers, slices, true);
+  int peaks = 0;
+  for (unsigned int i = 0; i < towers.size(); ++i) {
+    if (recTime(towers[i], pedestal, cut) >= 0) ++peaks;
+  }
+  std::cout << name << ": " << towers.size() << " towers, " << peaks
+            << " peaks, scalar mismatches "
+            << badScalar << ", vector mismatches " << badVector << std::endl;
+  assert(badScalar == 0);
+  assert(badVector == 0);
+}
+
+} // anonymous namespace
+
+void testTies()
+{
+  std::vector<std::vector<int> > towers;
+  towers.push_back(waveform(40, 90, 90, 40, 32));   // tied maximum
+  towers.push_back(waveform(90, 40, 40, 40, 90));   // tied at ends
+  towers.push_back(waveform(60, 60, 90, 40, 32));   // tie then higher
+  towers.push_back(waveform(40, 90, 40, 90, 95));   // tie then higher at end
+  towers.push_back(waveform(95, 90, 40, 90, 32));   // tie below maximum
+  run("ties", towers, 5);
+}
+
+void testFlat()
+{
+  std::vector<std::vector<int> > towers;
+  towers.push_back(waveform(0, 0, 0, 0, 0));        // all zero
+  towers.push_back(waveform(32, 32, 32, 32, 32));   // flat at pedestal
+  towers.push_back(waveform(70, 70, 70, 70, 70));   // flat above pedestal
+  towers.push_back(waveform(0, 0, 1, 0, 0));        // tiny single peak
+  run("flat", towers, 5);
+}
+
+void testPedestalClamp()
+{
+  std::vector<std::vector<int> > towers;
+  towers.push_back(waveform(0, 10, 80, 5, 0));      // below pedestal clamped
+  towers.push_back(waveform(20, 31, 53, 31, 20));   // signal at cut
+  towers.push_back(waveform(20, 31, 54, 31, 20));   // signal above cut
+  towers.push_back(waveform(32, 33, 52, 33, 32));   // signal exactly cut
+  towers.push_back(waveform(0, 0, 0, 0, 60));       // peak at last slice
+  towers.push_back(waveform(60, 0, 0, 0, 0));       // peak at first slice
+  run("pedestal clamp", towers, 5);
+}
+
+void testSliceMismatch()
+{
+  std::vector<std::vector<int> > towers;
+  towers.push_back(waveform(40, 50, 90, 50, 40));
+  std::vector<int> seven(waveform(32, 40, 45, 100, 45));
+  seven.push_back(40);
+  seven.push_back(32);
+  towers.push_back(seven);                          // more slices than buffer
+  towers.push_back(std::vector<int>(1, 80));        // single slice
+  towers.push_back(std::vector<int>());             // no slices
+  towers.push_back(waveform(40, 90, 90, 40, 32));
+  run("slice mismatch", towers, 5);
+}
+
+void testRandom()
+{
+  std::vector<std::vector<int> > towers;
+  for (int i = 0; i < 7171; ++i) {
+    std::vector<int> adc(7);
+    const int scale = (i%3 == 0) ? 1024 : 64;
+    for (int sl = 0; sl < 7; ++sl) adc[sl] = random(scale);
+    towers.push_back(adc);
+  }
+  run("random", towers, 7);
+}
+
+int main()
+{
+  testTies();
+  testFlat();
+  testPedestalClamp();
+  testSliceMismatch();
+  testRandom();
+  return 0;
+}
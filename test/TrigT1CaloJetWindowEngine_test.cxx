@@ -0,0 +1,330 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloJetWindowEngine_test.cxx
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// Check that a sliding-window jet RoI finder run on the Jet Elements
+// TrigT1CaloJetWindowEngine flags as needed, keeping RoIs at marked
+// references, gives the same RoIs as run on all Jet Elements.
+//
+// ********************************************************************
+
+#undef NDEBUG
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "TrigT1CaloMonitoring/TrigT1CaloJetWindowEngine.h"
+
+namespace {
+
+const int etaBins    = TrigT1CaloJetWindowEngine::s_etaBins;
+const int phiBins    = TrigT1CaloJetWindowEngine::s_phiBins;
+const int saturation = 0x3ff;
+
+// Jet Element ET by grid position, with presence flag as in a collection
+struct Grid {
+  Grid() : et(etaBins*phiBins, 0), present(etaBins*phiBins, false) {}
+  int  value(int eta, int phi) const;
+  int& at(int eta, int phi) { return et[phi*etaBins + eta]; }
+  std::vector<int>  et;
+  std::vector<bool> present;
+};
+
+int Grid::value(int eta, int phi) const
+{
+  if (eta < 0 || eta >= etaBins) return 0;
+  phi = (phi + phiBins) % phiBins;
+  if (!present[phi*etaBins + eta]) return 0;
+  const int v = et[phi*etaBins + eta];
+  return (v < saturation) ? v : saturation;    // saturated inputs
+}
+
+// An RoI as the jet algorithm would give it
+struct Roi {
+  int eta;
+  int phi;
+  int core;
+  int window3;
+  int window4;
+  bool operator<(const Roi& other) const {
+    if (eta != other.eta) return eta < other.eta;
+    if (phi != other.phi) return phi < other.phi;
+    if (core != other.core) return core < other.core;
+    if (window3 != other.window3) return window3 < other.window3;
+    return window4 < other.window4;
+  }
+  bool operator==(const Roi& other) const {
+    return !(*this < other) && !(other < *this);
+  }
+};
+
+int window(const Grid& grid, int eta, int phi, int size)
+{
+  int sum = 0;
+  for (int p = phi; p < phi + size; ++p) {
+    for (int e = eta; e < eta + size; ++e) sum += grid.value(e, p);
+  }
+  return sum;
+}
+
+// Direct sliding-window RoI finder, evaluated at each present Jet
+// Element as reference.  The core is 2x2 with the reference at its lower
+// corner (refUpper false) or upper corner (refUpper true), and ties with
+// neighbours below/left (strictBelow true) or above/right lose.
+std::vector<Roi> findRoIs(const Grid& grid, bool refUpper, bool strictBelow)
+{
+  std::vector<Roi> rois;
+  for (int phiRef = 0; phiRef < phiBins; ++phiRef) {
+    for (int etaRef = 0; etaRef < etaBins; ++etaRef) {
+      if (!grid.present[phiRef*etaBins + etaRef]) continue;
+      const int eta = refUpper ? etaRef - 1 : etaRef;
+      const int phi = refUpper ? phiRef - 1 : phiRef;
+      const int core = window(grid, eta, phi, 2);
+      bool max = true;
+      for (int dphi = -1; dphi <= 1 && max; ++dphi) {
+        for (int deta = -1; deta <= 1 && max; ++deta) {
+          if (!dphi && !deta) continue;
+          const int other = window(grid, eta + deta, phi + dphi, 2);
+          const bool below = (dphi < 0 || (dphi == 0 && deta < 0));
+          if (below == strictBelow) max = (core > other);
+          else                      max = (core >= other);
+        }
+      }
+      if (!max) continue;
+      Roi roi;
+      roi.eta = etaRef;
+      roi.phi = phiRef;
+      roi.core = core;
+      roi.window3 = 0;
+      for (int dphi = -1; dphi <= 0; ++dphi) {
+        for (int deta = -1; deta <= 0; ++deta) {
+          const int w = window(grid, eta + deta, phi + dphi, 3);
+          if (w > roi.window3) roi.window3 = w;
+        }
+      }
+      roi.window4 = window(grid, eta - 1, phi - 1, 4);
+      rois.push_back(roi);
+    }
+  }
+  return rois;
+}
+
+// Deterministic pseudo-random numbers
+unsigned int seed = 4711;
+int random(int range)
+{
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 16) % range;
+}
+
+// Compare finder on all elements with finder on needed elements, for all
+// reference and tie conventions.  Return number of RoIs found.
+int check(const Grid& grid, int& candidates)
+{
+  TrigT1CaloJetWindowEngine engine;
+  engine.clear();
+  for (int phi = 0; phi < phiBins; ++phi) {
+    for (int eta = 0; eta < etaBins; ++eta) {
+      if (grid.present[phi*etaBins + eta]) {
+        assert(engine.add(eta, phi, grid.et[phi*etaBins + eta]));
+      }
+    }
+  }
+  engine.process();
+  candidates += engine.candidates();
+
+  // Summed-area table windows against direct sums of raw ET
+  for (int i = 0; i < 50; ++i) {
+    const int eta = random(etaBins + 4) - 2;
+    const int phi = random(phiBins);
+    const int size = random(4) + 1;
+    int direct = 0;
+    for (int p = phi; p < phi + size; ++p) {
+      for (int e = eta; e < eta + size; ++e) {
+        if (e < 0 || e >= etaBins) continue;
+        const int cell = (p % phiBins)*etaBins + e;
+        if (grid.present[cell]) direct += grid.et[cell];
+      }
+    }
+    if (phi + size <= phiBins) assert(engine.sum(eta, phi, size, size) == direct);
+  }
+
+  Grid reduced;
+  for (int phi = 0; phi < phiBins; ++phi) {
+    for (int eta = 0; eta < etaBins; ++eta) {
+      const int cell = phi*etaBins + eta;
+      reduced.et[cell] = grid.et[cell];
+      reduced.present[cell] = grid.present[cell] && engine.needed(eta, phi);
+    }
+  }
+  int found = 0;
+  for (int conv = 0; conv < 4; ++conv) {
+    const bool refUpper = conv & 1;
+    const bool strictBelow = conv & 2;
+    std::vector<Roi> all(findRoIs(grid, refUpper, strictBelow));
+    std::vector<Roi> some(findRoIs(reduced, refUpper, strictBelow));
+    std::set<Roi> kept;
+    for (unsigned int i = 0; i < some.size(); ++i) {
+      if (engine.marked(some[i].eta, some[i].phi)) kept.insert(some[i]);
+    }
+    const std::set<Roi> expected(all.begin(), all.end());
+    assert(kept == expected);
+    found += all.size();
+  }
+  return found;
+}
+
+void run(const std::string& name, const std::vector<Grid>& grids)
+{
+  int rois = 0;
+  int candidates = 0;
+  int needed = 0;
+  int present = 0;
+  for (unsigned int i = 0; i < grids.size(); ++i) {
+    rois += check(grids[i], candidates);
+    TrigT1CaloJetWindowEngine engine;
+    for (int cell = 0; cell < etaBins*phiBins; ++cell) {
+      if (!grids[i].present[cell]) continue;
+      ++present;
+      engine.add(cell % etaBins, cell / etaBins, grids[i].et[cell]);
+    }
+    engine.process();
+    for (int cell = 0; cell < etaBins*phiBins; ++cell) {
+      if (grids[i].present[cell] &&
+          engine.needed(cell % etaBins, cell / etaBins)) ++needed;
+    }
+  }
+  std::cout << name << ": " << grids.size() << " events, " << rois
+            << " RoIs, " << candidates << " candidates, " << needed
+            << " of " << present << " Jet Elements needed" << std::endl;
+}
+
+} // anonymous namespace
+
+void testGeometry()
+{
+  std::cout << "testGeometry\n";
+  assert(TrigT1CaloJetWindowEngine::etaIndex(-4.0)  == 0);
+  assert(TrigT1CaloJetWindowEngine::etaIndex(-3.05) == 1);
+  assert(TrigT1CaloJetWindowEngine::etaIndex(-0.1)  == 15);
+  assert(TrigT1CaloJetWindowEngine::etaIndex(0.1)   == 16);
+  assert(TrigT1CaloJetWindowEngine::etaIndex(2.55)  == 28);
+  assert(TrigT1CaloJetWindowEngine::etaIndex(4.0)   == 31);
+  assert(TrigT1CaloJetWindowEngine::etaIndex(5.0)   == -1);
+  assert(TrigT1CaloJetWindowEngine::etaIndex(-5.0)  == -1);
+  const double step = 2.*M_PI/phiBins;
+  for (int bin = 0; bin < phiBins; ++bin) {
+    assert(TrigT1CaloJetWindowEngine::phiIndex((bin + 0.5)*step) == bin);
+  }
+  assert(TrigT1CaloJetWindowEngine::phiIndex(-0.5*step) == phiBins - 1);
+  TrigT1CaloJetWindowEngine engine;
+  assert(!engine.add(-1, 0, 5));
+  assert(!engine.add(etaBins, 0, 5));
+  assert(!engine.add(0, phiBins, 5));
+  engine.process();
+  assert(engine.candidates() == 0);
+  assert(!engine.needed(0, 0) && !engine.marked(0, 0));
+}
+
+void testSingle()
+{
+  std::vector<Grid> grids;
+  const int etas[4] = { 0, 1, 16, etaBins - 1 };
+  const int phis[3] = { 0, 17, phiBins - 1 };
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      Grid grid;
+      grid.at(etas[i], phis[j]) = 40;
+      grid.present[phis[j]*etaBins + etas[i]] = true;
+      grids.push_back(grid);
+    }
+  }
+  run("single", grids);
+}
+
+void testTies()
+{
+  std::vector<Grid> grids;
+  for (int i = 0; i < 40; ++i) {
+    Grid grid;
+    const int eta0 = random(etaBins);
+    const int phi0 = random(phiBins);
+    const int width = random(5) + 1;
+    for (int p = phi0; p < phi0 + width; ++p) {      // flat plateau
+      for (int e = eta0; e < eta0 + width && e < etaBins; ++e) {
+        grid.at(e, p % phiBins) = 10;
+      }
+    }
+    for (int cell = 0; cell < etaBins*phiBins; ++cell) {
+      grid.present[cell] = (i%2 == 0) || grid.et[cell] > 0;
+    }
+    grids.push_back(grid);
+  }
+  run("ties", grids);
+}
+
+void testRandom()
+{
+  std::vector<Grid> grids;
+  for (int i = 0; i < 200; ++i) {
+    Grid grid;
+    const int noise = (i%4 == 0) ? 60 : 200;
+    for (int cell = 0; cell < etaBins*phiBins; ++cell) {
+      if (random(noise) < 10) grid.et[cell] = random(8) + 1;
+    }
+    const int jets = random(6);
+    for (int j = 0; j < jets; ++j) {
+      const int eta = random(etaBins);
+      const int phi = random(phiBins);
+      const int peak = 20 + random(300);
+      for (int dp = -2; dp <= 2; ++dp) {
+        for (int de = -2; de <= 2; ++de) {
+          if (eta + de < 0 || eta + de >= etaBins) continue;
+          const int d = std::abs(dp) + std::abs(de);
+          grid.at(eta + de, (phi + dp + phiBins) % phiBins) += peak >> (2*d);
+        }
+      }
+    }
+    for (int cell = 0; cell < etaBins*phiBins; ++cell) {
+      grid.present[cell] = (i%3 == 0) || grid.et[cell] > 0;
+    }
+    grids.push_back(grid);
+  }
+  run("random", grids);
+}
+
+void testSaturation()
+{
+  std::vector<Grid> grids;
+  for (int i = 0; i < 50; ++i) {
+    Grid grid;
+    const int eta = random(etaBins);
+    const int phi = random(phiBins);
+    grid.at(eta, phi) = 0x3ff + random(3000);       // saturates
+    for (int j = 0; j < 6; ++j) {
+      const int e = eta + random(5) - 2;
+      if (e < 0 || e >= etaBins) continue;
+      grid.at(e, (phi + random(5) - 2 + phiBins) % phiBins) += random(900);
+    }
+    for (int cell = 0; cell < etaBins*phiBins; ++cell) {
+      grid.present[cell] = grid.et[cell] > 0;
+    }
+    grids.push_back(grid);
+  }
+  run("saturation", grids);
+}
+
+int main()
+{
+  testGeometry();
+  testSingle();
+  testTies();
+  testRandom();
+  testSaturation();
+  return 0;
+}
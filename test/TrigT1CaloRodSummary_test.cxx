@@ -0,0 +1,178 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloRodSummary_test.cxx
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// Check the slink positions of TrigT1CaloRodSummary and the merging of
+// ROD headers at the same position.
+//
+// ********************************************************************
+
+#undef NDEBUG
+
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+#include "TrigT1CaloEvent/RODHeader.h"
+
+#include "TrigT1CaloMonitoring/TrigT1CaloRodSummary.h"
+
+namespace {
+
+typedef TrigT1CaloRodSummary::RodHeaderCollection RodHeaderCollection;
+
+// Header with the given source identifier, status words and payload
+LVL1::RODHeader* header(unsigned int sourceId, unsigned int status0,
+                        unsigned int status1, int nData,
+                        unsigned int version = 0x10003)
+{
+  std::vector<unsigned int> status;
+  status.push_back(status0);
+  status.push_back(status1);
+  return new LVL1::RODHeader(version, sourceId, 1, 2, 3, 4, 5, status, nData);
+}
+
+// Status bits the summary should see for a header
+std::vector<int> expectedCounts(const LVL1::RODHeader& h)
+{
+  std::vector<int> counts(TrigT1CaloRodSummary::NumberOfStatusBits, 0);
+  // GLink and LVDS link errors interchanged, CMM parity in the LVDS bit
+  counts[TrigT1CaloRodSummary::GLinkError]         = h.lvdsLinkError();
+  counts[TrigT1CaloRodSummary::LVDSLinkError]      = h.cmmParityError();
+  counts[TrigT1CaloRodSummary::FIFOOverflow]       = h.rodFifoOverflow();
+  counts[TrigT1CaloRodSummary::DataTransportError] = h.dataTransportError();
+  counts[TrigT1CaloRodSummary::GLinkTimeout]       = h.gLinkTimeout();
+  counts[TrigT1CaloRodSummary::BCNMismatch]        = h.bcnMismatch();
+  counts[TrigT1CaloRodSummary::TriggerTypeTimeout] = h.triggerTypeTimeout();
+  counts[TrigT1CaloRodSummary::LimitedRoISet]      = h.limitedRoISet();
+  return counts;
+}
+
+} // anonymous namespace
+
+void testPosition()
+{
+  std::cout << "testPosition\n";
+  assert(TrigT1CaloRodSummary::position(0, 0, 0)  == 0);
+  assert(TrigT1CaloRodSummary::position(0, 3, 0)  == 3);
+  assert(TrigT1CaloRodSummary::position(7, 1, 0)  == 29);
+  assert(TrigT1CaloRodSummary::position(13, 3, 0) == 55);
+  assert(TrigT1CaloRodSummary::position(8, 0, 1)  == 56);
+  assert(TrigT1CaloRodSummary::position(13, 3, 1) == 79);
+  assert(TrigT1CaloRodSummary::position(-1, 0, 0) == -1);
+  assert(TrigT1CaloRodSummary::position(14, 0, 0) == -1);
+  assert(TrigT1CaloRodSummary::position(0, -1, 0) == -1);
+  assert(TrigT1CaloRodSummary::position(0, 4, 0)  == -1);
+  assert(TrigT1CaloRodSummary::position(0, 0, -1) == -1);
+  assert(TrigT1CaloRodSummary::position(13, 0, 2) == -1);
+  // Distinct positions for all DAQ RODs and the RoI RODs of crates 8-13
+  std::vector<int> used(TrigT1CaloRodSummary::s_positions, 0);
+  int valid = 0;
+  for (int dataType = 0; dataType < 2; ++dataType) {
+    for (int crate = 8*dataType; crate < TrigT1CaloRodSummary::s_crates; ++crate) {
+      for (int slink = 0; slink < 4; ++slink) {
+        const int pos = TrigT1CaloRodSummary::position(crate, slink, dataType);
+        if (pos < 0) continue;
+        assert(pos < TrigT1CaloRodSummary::s_positions);
+        assert(used[pos] == 0);
+        used[pos] = 1;
+        ++valid;
+      }
+    }
+  }
+  assert(valid == TrigT1CaloRodSummary::s_positions);
+}
+
+void testStatus()
+{
+  std::cout << "testStatus\n";
+  // Each status bit alone, wherever the header keeps it
+  for (int word = 0; word < 2; ++word) {
+    for (int bit = 0; bit < 32; ++bit) {
+      RodHeaderCollection rods;
+      rods.push_back(header(0x0, (word) ? 0 : 1u << bit,
+                                 (word) ? 1u << bit : 0, 10));
+      const LVL1::RODHeader& h(*rods[0]);
+      const int pos = TrigT1CaloRodSummary::position(h.crate(), h.sLink(),
+                                                     h.dataType());
+      assert(pos >= 0);
+      TrigT1CaloRodSummary summary;
+      summary.add(&rods, true);
+      const TrigT1CaloRodSummary::Rod& rod(summary.rod(pos));
+      const std::vector<int> counts(expectedCounts(h));
+      for (int i = 0; i < TrigT1CaloRodSummary::NumberOfStatusBits; ++i) {
+        assert(rod.statusCounts[i] == counts[i]);
+      }
+    }
+  }
+}
+
+void testAdd()
+{
+  std::cout << "testAdd\n";
+  // Two DAQ headers and one RoIB header at each source identifier
+  for (unsigned int sourceId = 0; sourceId < 0x100; ++sourceId) {
+    RodHeaderCollection daq;
+    RodHeaderCollection roib;
+    daq.push_back(header(sourceId, 0xffffffff, 0xffffffff, 20, 0x10003));
+    daq.push_back(header(sourceId, 0, 0, 30, 0x10004));
+    roib.push_back(header(sourceId, 0xffffffff, 0, 5, 0x10005));
+    const LVL1::RODHeader& h(*daq[0]);
+    const int crate = h.crate();
+    const int dataType = h.dataType();
+    const int pos = TrigT1CaloRodSummary::position(crate, h.sLink(), dataType);
+
+    TrigT1CaloRodSummary summary;
+    summary.add(&daq, true);
+    summary.add(&roib, false);
+    for (int p = 0; p < TrigT1CaloRodSummary::s_positions; ++p) {
+      if (p != pos) assert(!summary.rod(p).present);
+    }
+    if (pos < 0) {
+      assert(!summary.limitedRoI(crate));
+      assert(summary.roiMinorVersion(crate) == -1);
+      continue;
+    }
+    const TrigT1CaloRodSummary::Rod& rod(summary.rod(pos));
+    assert(rod.present);
+    assert(rod.headers == 3);
+    assert(rod.crate == crate);
+    assert(rod.dataType == dataType);
+    assert(rod.payloadSize == 55);
+    assert(rod.minorVersion == roib[0]->minorVersion());
+    const std::vector<int> all(expectedCounts(*daq[0]));
+    const std::vector<int> word0(expectedCounts(*roib[0]));
+    for (int i = 0; i < TrigT1CaloRodSummary::NumberOfStatusBits; ++i) {
+      assert(rod.statusCounts[i] == all[i] + word0[i]);
+    }
+    // Only DAQ RoI ROD headers set the per-crate values
+    if (dataType == 1) {
+      assert(summary.limitedRoI(crate) == h.limitedRoISet());
+      assert(summary.roiMinorVersion(crate) == daq[1]->minorVersion());
+    } else {
+      assert(!summary.limitedRoI(crate));
+      assert(summary.roiMinorVersion(crate) == -1);
+    }
+  }
+
+  // Impossible payload sizes are skipped
+  RodHeaderCollection bad;
+  bad.push_back(header(0x0, 0, 0, -1));
+  bad.push_back(header(0x0, 0, 0, 10001));
+  TrigT1CaloRodSummary summary;
+  summary.add(&bad, true);
+  for (int p = 0; p < TrigT1CaloRodSummary::s_positions; ++p) {
+    assert(!summary.rod(p).present);
+  }
+  assert(!summary.limitedRoI(-1) && !summary.limitedRoI(14));
+  assert(summary.roiMinorVersion(14) == -1);
+}
+
+int main()
+{
+  testPosition();
+  testStatus();
+  testAdd();
+  return 0;
+}
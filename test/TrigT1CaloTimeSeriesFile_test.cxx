@@ -0,0 +1,273 @@
+// ********************************************************************
+//
+// NAME:     TrigT1CaloTimeSeriesFile_test.cxx
+// PACKAGE:  TrigT1CaloMonitoring
+//
+// Check TrigT1CaloChannelStats slab allocation and totals, write stores
+// with TrigT1CaloTimeSeriesFile, read them back, and check that damaged
+// files are rejected.
+//
+// ********************************************************************
+
+#undef NDEBUG
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "TrigT1CaloMonitoring/TrigT1CaloChannelStats.h"
+#include "TrigT1CaloMonitoring/TrigT1CaloTimeSeriesFile.h"
+
+namespace {
+
+const std::string fileName = "TrigT1CaloTimeSeriesFile_test.l1ts";
+const unsigned int run     = 123456;
+const int channels         = 5;
+const int lumiBlocks       = 12;
+
+std::string readBytes(const std::string& name)
+{
+  std::ifstream in(name.c_str(), std::ios::in | std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(in),
+                     std::istreambuf_iterator<char>());
+}
+
+void writeBytes(const std::string& name, const std::string& bytes)
+{
+  std::ofstream out(name.c_str(), std::ios::out | std::ios::binary);
+  out.write(bytes.data(), bytes.size());
+}
+
+void setWord(std::string& bytes, int offset, unsigned int value)
+{
+  bytes.replace(offset, sizeof(value),
+                reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Two stores sharing channels, with lumiblock gaps and empty channels
+void fillStores(TrigT1CaloChannelStats& pedestal,
+                TrigT1CaloChannelStats& timing)
+{
+  pedestal.setup(channels, lumiBlocks);
+  timing.setup(channels, lumiBlocks);
+  for (int lb = 1; lb < lumiBlocks; lb += 3) {     // 1, 4, 7, 10
+    for (int ch = 0; ch < channels; ++ch) {
+      if (ch == 2) continue;                       // never filled
+      for (int i = 0; i <= ch; ++i) {
+        pedestal.fill(ch, lb, 32. + 0.25*ch + 0.5*i + 0.1*lb);
+      }
+    }
+  }
+  timing.fill(0, 4, 1.5);
+  timing.fill(0, 4, 2.5);
+  timing.fill(4, 5, -3.);                          // only in timing
+}
+
+std::vector<unsigned int> channelIds()
+{
+  std::vector<unsigned int> ids;
+  for (int ch = 0; ch < channels; ++ch) ids.push_back(0x100 + 7*ch);
+  return ids;
+}
+
+} // anonymous namespace
+
+void testRoundTrip()
+{
+  std::cout << "testRoundTrip\n";
+  TrigT1CaloChannelStats pedestal;
+  TrigT1CaloChannelStats timing;
+  fillStores(pedestal, timing);
+  std::vector<std::string> names;
+  names.push_back("pedestal");
+  names.push_back("timing");
+  std::vector<const TrigT1CaloChannelStats*> stats;
+  stats.push_back(&pedestal);
+  stats.push_back(&timing);
+  const std::vector<unsigned int> ids(channelIds());
+  assert(TrigT1CaloTimeSeriesFile::write(fileName, run, names, stats, ids));
+
+  TrigT1CaloTimeSeriesFile file;
+  assert(file.read(fileName));
+  assert(file.run() == run);
+  assert(file.channels() == channels);
+  assert(file.quantities() == 2);
+  assert(file.name(0) == "pedestal");
+  assert(file.name(1) == "timing");
+  assert(file.quantity("timing") == 1);
+  assert(file.quantity("energy") == -1);
+  for (int ch = 0; ch < channels; ++ch) assert(file.channelId(ch) == ids[ch]);
+
+  std::cout << "lumiblocks:";
+  for (int pos = 0; pos < file.lumiBlocks(); ++pos) {
+    std::cout << " " << file.lumiBlock(pos);
+  }
+  std::cout << "\n";
+  assert(file.lumiBlocks() == 5);
+
+  int cells = 0;
+  int empty = 0;
+  for (int q = 0; q < file.quantities(); ++q) {
+    const unsigned int* entries = file.entries(q);
+    const float* mean = file.mean(q);
+    const float* rms  = file.rms(q);
+    for (int ch = 0; ch < channels; ++ch) {
+      for (int pos = 0; pos < file.lumiBlocks(); ++pos, ++cells) {
+        const int cell = ch * file.lumiBlocks() + pos;
+        const TrigT1CaloChannelStats::Moments* moments =
+                               stats[q]->moments(ch, file.lumiBlock(pos));
+        if (moments && moments->entries > 0) {
+          assert(entries[cell] == moments->entries);
+          assert(mean[cell] == float(moments->mean));
+          assert(rms[cell]  == float(moments->rms()));
+        } else {
+          assert(entries[cell] == 0);
+          assert(mean[cell] == 0.);
+          assert(rms[cell]  == 0.);
+          ++empty;
+        }
+      }
+    }
+  }
+  std::cout << "cells: " << cells << " empty: " << empty << "\n";
+}
+
+void testMismatch()
+{
+  std::cout << "testMismatch\n";
+  TrigT1CaloChannelStats pedestal;
+  TrigT1CaloChannelStats timing;
+  fillStores(pedestal, timing);
+  std::vector<const TrigT1CaloChannelStats*> stats;
+  stats.push_back(&pedestal);
+  stats.push_back(&timing);
+  std::vector<std::string> names(1, "pedestal");
+  assert(!TrigT1CaloTimeSeriesFile::write(fileName, run, names, stats,
+                                          channelIds()));
+  names.push_back("timing");
+  std::vector<unsigned int> ids(channelIds());
+  ids.pop_back();
+  assert(!TrigT1CaloTimeSeriesFile::write(fileName, run, names, stats, ids));
+}
+
+void testBadFiles()
+{
+  std::cout << "testBadFiles\n";
+  TrigT1CaloChannelStats pedestal;
+  TrigT1CaloChannelStats timing;
+  fillStores(pedestal, timing);
+  std::vector<std::string> names;
+  names.push_back("pedestal");
+  names.push_back("timing");
+  std::vector<const TrigT1CaloChannelStats*> stats;
+  stats.push_back(&pedestal);
+  stats.push_back(&timing);
+  assert(TrigT1CaloTimeSeriesFile::write(fileName, run, names, stats,
+                                         channelIds()));
+  const std::string good = readBytes(fileName);
+  std::cout << "file size: " << good.size() << "\n";
+
+  TrigT1CaloTimeSeriesFile file;
+  assert(!file.read("TrigT1CaloTimeSeriesFile_test.missing"));
+  assert(file.channels() == 0 && file.quantities() == 0);
+
+  // Bad magic
+  std::string bytes(good);
+  bytes[0] = 'X';
+  writeBytes(fileName, bytes);
+  assert(!file.read(fileName));
+  assert(file.channels() == 0 && file.entries(0) == 0);
+
+  // Bad version
+  bytes = good;
+  setWord(bytes, 4, 2);
+  writeBytes(fileName, bytes);
+  assert(!file.read(fileName));
+
+  // Header sizes larger than the file
+  const int sizeOffsets[3] = { 12, 16, 20 };
+  for (int i = 0; i < 3; ++i) {
+    bytes = good;
+    setWord(bytes, sizeOffsets[i], 0xffffffff);
+    writeBytes(fileName, bytes);
+    assert(!file.read(fileName));
+    assert(file.channels() == 0 && file.lumiBlocks() == 0);
+  }
+  bytes = good;
+  setWord(bytes, 24, 0xffffffff);                  // first name length
+  writeBytes(fileName, bytes);
+  assert(!file.read(fileName));
+
+  // Truncated at every length
+  int rejected = 0;
+  for (std::size_t length = 0; length < good.size(); ++length) {
+    writeBytes(fileName, good.substr(0, length));
+    if (!file.read(fileName)) ++rejected;
+    assert(file.quantities() == 0);
+  }
+  std::cout << "truncated files rejected: " << rejected << "\n";
+
+  // Good file still reads after failures
+  writeBytes(fileName, good);
+  assert(file.read(fileName));
+  assert(file.quantities() == 2 && file.channels() == channels);
+  std::remove(fileName.c_str());
+}
+
+void testStore()
+{
+  std::cout << "testStore\n";
+  const int nLumi = 3*TrigT1CaloChannelStats::s_chunkSlabs + 5;
+  TrigT1CaloChannelStats stats;
+  stats.setup(channels, nLumi);
+  assert(stats.memory() == channels*sizeof(TrigT1CaloChannelStats::Totals));
+  assert(sizeof(TrigT1CaloChannelStats::Moments) == 12);
+
+  // Records stay put as more slabs are allocated
+  stats.fill(1, 0, 4.);
+  const TrigT1CaloChannelStats::Moments* first = stats.moments(1, 0);
+  for (int lb = nLumi - 1; lb > 0; lb -= 2) {
+    for (int ch = 0; ch < channels; ++ch) stats.fill(ch, lb, lb + 0.5*ch);
+  }
+  assert(stats.moments(1, 0) == first && first->entries == 1);
+  assert(first->mean == 4.f);
+  const std::size_t memory = stats.memory();
+  std::cout << "memory: " << memory << "\n";
+
+  // Totals match merged lumiblocks
+  for (int ch = 0; ch < channels; ++ch) {
+    TrigT1CaloChannelStats::Totals merged;
+    for (int lb = 0; lb < nLumi; ++lb) {
+      if (stats.moments(ch, lb)) merged.add(*stats.moments(ch, lb));
+    }
+    assert(merged.entries == stats.total(ch).entries);
+    assert(std::fabs(merged.mean - stats.total(ch).mean) < 1e-4);
+    assert(std::fabs(merged.rms() - stats.total(ch).rms()) < 1e-3);
+  }
+
+  // Clear keeps slabs for reuse
+  stats.clear();
+  assert(stats.memory() == memory);
+  assert(!stats.filled(1) && stats.total(1).entries == 0);
+  for (int lb = 0; lb < nLumi; ++lb) stats.fill(0, lb, 1.);
+  assert(stats.memory() > memory);
+  assert(stats.moments(3, 1)->entries == 0);
+  assert(stats.total(0).entries == (unsigned int)nLumi);
+  stats.fill(0, nLumi, 1.);                        // outside, ignored
+  stats.fill(channels, 0, 1.);
+  assert(stats.total(0).entries == (unsigned int)nLumi);
+}
+
+int main()
+{
+  testStore();
+  testRoundTrip();
+  testMismatch();
+  testBadFiles();
+  return 0;
+}